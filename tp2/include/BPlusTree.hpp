@@ -1,33 +1,68 @@
 #ifndef BPLUSTREE_HPP
 #define BPLUSTREE_HPP
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <cstring>
 #include <string>
+#include <utility>
 #include <vector>
+#include "crc32c.h"
+#include "metrics.h"
+#include <fcntl.h>
+#include <unistd.h>
 
 #define BLOCK_SIZE 4096 // padrão SO
-#define M 102 // Ordem da árvore B+: mínimo M, máximo 2*M chaves
+#ifndef M
+#define M 102 // Ordem da árvore B+: mínimo M, máximo 2*M chaves (-DM=... só na verificação, make check-bptree)
+#endif
+#define READ_AHEAD_PADRAO 8 // folhas antecipadas nas varreduras (BPTREE_READAHEAD)
 
 // Forward declaration
 template <typename T> class BPlusTree;
 
 class FileManager {
-private:
-    std::fstream file;
-    long nextFreeOffset; // Próximo offset livre no arquivo
-
-    // Estrutura de cabeçalho do arquivo
+public:
+    // Estrutura de cabeçalho do arquivo (offset 0; a primeira página é dele)
     struct FileHeader {
         long rootOffset;
         long nextFreeOffset;
         int m;
-    } header;
+        long freeListHead; // primeira página liberada (0 = lista vazia)
+        std::uint32_t projection; // colunas gravadas junto do valor (projecao.h); 0 em índices antigos
+        std::uint32_t checksums;  // CHECKSUM_MAGIC se as páginas levam CRC32C (índices antigos não)
+        std::uint32_t valueSize;  // bytes do valor nas páginas de dados (sizeof do T de criação); 0 em índices antigos
+    };
+
+    // Nós guardam o CRC32C no último campo; páginas de dados, logo depois dos
+    // valueSize bytes do valor, que cobre. Só arquivos criados com checksums são
+    // verificados.
+    static constexpr std::uint32_t CHECKSUM_MAGIC = 0x43524333; // "3CRC"
+
+    // Tamanho do valor gravado nas páginas de dados; quem abre o arquivo com um
+    // T menor (BPlusTree<long> sobre um índice de cobertura, projecao.h) lê e
+    // regrava só o começo dele
+    static std::size_t valueBytes(const FileHeader& h, std::size_t sizeofT) {
+        return h.valueSize ? h.valueSize : sizeofT;
+    }
+
+private:
+    std::fstream file;
+    std::string fileName;
+    int hintFd = -1; // descritor só para posix_fadvise (o fstream não expõe o seu)
+    long nextFreeOffset; // Próximo offset livre no arquivo
+    FileHeader header;
     mutable std::size_t blocksRead = 0;
+    std::size_t blocksWritten = 0;
+    StorageMetrics& metrics = StorageMetrics::get();
 
 public:
-    FileManager(const std::string& filename, int treeM) : header({0, 4096, treeM}) {
+    FileManager(const std::string& filename, int treeM, std::size_t valueSize)
+        : fileName(filename),
+          header({0, 4096, treeM, 0, 0, CHECKSUM_MAGIC, static_cast<std::uint32_t>(valueSize)}) {
         file.open(filename, std::ios::in | std::ios::out | std::ios::binary);
 
         if (!file.is_open()) {
@@ -45,11 +80,13 @@ public:
             readHeader();
             nextFreeOffset = header.nextFreeOffset;
         }
+        hintFd = ::open(filename.c_str(), O_RDONLY);
     }
 
     ~FileManager() {
         writeHeader();
         file.close();
+        if (hintFd >= 0) ::close(hintFd);
     }
     void updateRootOffset(long newRootOffset) {
         header.rootOffset = newRootOffset;
@@ -60,26 +97,75 @@ public:
         return header;
     }
 
+    void setProjection(std::uint32_t projection) {
+        header.projection = projection;
+        writeHeader();
+    }
+
     void readHeader() {
         file.seekg(0, std::ios::beg);
         file.read(reinterpret_cast<char*>(&header), sizeof(FileHeader));
         nextFreeOffset = header.nextFreeOffset;
+        metrics.bptreeSeeks.inc();
+        metrics.bptreeBytesRead.inc(sizeof(FileHeader));
     }
 
     void writeHeader() {
         header.nextFreeOffset = nextFreeOffset;
         file.seekp(0, std::ios::beg);
         file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+        metrics.bptreeSeeks.inc();
+        metrics.bptreeBytesWritten.inc(sizeof(FileHeader));
     }
     
-    // Aloca espaço e retorna o offset
+    // Aloca espaço e retorna o offset (reaproveita páginas liberadas antes de crescer o arquivo)
     long getNewOffset() {
+        if (header.freeListHead != 0) {
+            long offset = header.freeListHead;
+            long next = 0;
+            file.seekg(offset, std::ios::beg);
+            file.read(reinterpret_cast<char*>(&next), sizeof(long));
+            header.freeListHead = next;
+            metrics.bptreeSeeks.inc();
+            metrics.bptreeBytesRead.inc(sizeof(long));
+            metrics.bptreePagesReused.inc();
+            return offset;
+        }
         long offset = nextFreeOffset;
         nextFreeOffset += BLOCK_SIZE;
+        metrics.bptreePagesAllocated.inc();
         return offset;
     }
 
-    // Leitura de um nó do arquivo
+    // Devolve uma página à lista livre; o encadeamento fica nos primeiros bytes da própria página
+    void freeOffset(long offset) {
+        file.seekp(offset, std::ios::beg);
+        file.write(reinterpret_cast<const char*>(&header.freeListHead), sizeof(long));
+        file.flush();
+        header.freeListHead = offset;
+        metrics.bptreeSeeks.inc();
+        metrics.bptreeFlushes.inc();
+        metrics.bptreeBytesWritten.inc(sizeof(long));
+        metrics.bptreePagesFreed.inc();
+    }
+
+    bool checksummed() const { return header.checksums == CHECKSUM_MAGIC; }
+
+    // CRC32C da parte viva do nó: numKeys, isLeaf, as numKeys chaves, os
+    // numKeys + 1 filhos e nextLeafOffset. Os slots além de numKeys não são
+    // lidos e ficam de fora, então o custo acompanha a ocupação do nó.
+    template <typename T>
+    static std::uint32_t nodeChecksum(const typename BPlusTree<T>::BPlusTreeNode& node) {
+        std::size_t n = static_cast<std::size_t>(node.numKeys < 0 ? 0 : node.numKeys > 2 * M ? 2 * M : node.numKeys);
+        std::uint32_t crc = crc32c(&node.numKeys, sizeof(node.numKeys));
+        crc = crc32c(&node.isLeaf, sizeof(node.isLeaf), crc);
+        crc = crc32c(node.keys, n * sizeof(int), crc);
+        crc = crc32c(node.childrenOffsets, (n + 1) * sizeof(long), crc);
+        return crc32c(&node.nextLeafOffset, sizeof(node.nextLeafOffset), crc);
+    }
+
+    // Leitura de um nó do arquivo. Um nó com checksum errado é devolvido como
+    // folha vazia (false), para a descida não seguir offsets corrompidos.
     template <typename T>
     bool readNode(long offset, typename BPlusTree<T>::BPlusTreeNode& node) {
         if (offset == 0) return false;
@@ -87,25 +173,112 @@ public:
         file.seekg(offset, std::ios::beg);
         file.read(reinterpret_cast<char*>(&node), sizeof(typename BPlusTree<T>::BPlusTreeNode)); 
         blocksRead++; // contador de blocos lidos
-        return file.good();
+        metrics.bptreeNodeReads.inc();
+        metrics.bptreeSeeks.inc();
+        metrics.bptreeBytesRead.inc(sizeof(typename BPlusTree<T>::BPlusTreeNode));
+        if (!file.good()) return false;
+        if (checksummed() && node.checksum != nodeChecksum<T>(node)) {
+            checksumFailure(offset);
+            std::memset(&node, 0, sizeof(node));
+            node.isLeaf = true;
+            return false;
+        }
+        return true;
+    }
+
+    // Pede ao kernel para ir trazendo a página para o cache (assíncrono); a
+    // leitura de verdade continua sendo readNode/readData
+    void prefetch(long offset, std::size_t length) {
+        if (hintFd < 0 || offset <= 0) return;
+        posix_fadvise(hintFd, offset, static_cast<off_t>(length), POSIX_FADV_WILLNEED);
+        metrics.bptreePrefetches.inc();
     }
 
     template <typename T>
     void writeNode(long offset, const typename BPlusTree<T>::BPlusTreeNode& node) {
+        typename BPlusTree<T>::BPlusTreeNode sealed = node;
+        sealed.checksum = nodeChecksum<T>(node);
         file.seekp(offset, std::ios::beg);
-        file.write(reinterpret_cast<const char*>(&node), sizeof(typename BPlusTree<T>::BPlusTreeNode));
+        file.write(reinterpret_cast<const char*>(&sealed), sizeof(typename BPlusTree<T>::BPlusTreeNode));
         file.flush();
+        blocksWritten++;
+        metrics.bptreeNodeWrites.inc();
+        metrics.bptreeSeeks.inc();
+        metrics.bptreeFlushes.inc();
+        metrics.bptreeBytesWritten.inc(sizeof(typename BPlusTree<T>::BPlusTreeNode));
     }
     
+    // Página de dados: os valueBytes do valor seguidos do CRC32C deles. A
+    // página é lida inteira mesmo quando T é só o começo do valor.
+    template <typename T>
+    bool readData(long offset, T* data) {
+        static_assert(sizeof(T) + sizeof(std::uint32_t) <= BLOCK_SIZE, "valor maior que a pagina");
+        const std::size_t size = std::max(valueBytes(header, sizeof(T)), sizeof(T));
+        const std::size_t bytes = checksummed() ? size + sizeof(std::uint32_t) : sizeof(T);
+        char page[BLOCK_SIZE];
+        file.seekg(offset, std::ios::beg);
+        file.read(page, static_cast<std::streamsize>(bytes));
+        blocksRead++;
+        metrics.bptreeDataReads.inc();
+        metrics.bptreeSeeks.inc();
+        metrics.bptreeBytesRead.inc(bytes);
+        if (!file.good()) return false;
+        if (checksummed()) {
+            std::uint32_t checksum;
+            std::memcpy(&checksum, page + size, sizeof(checksum));
+            if (checksum != crc32c(page, size)) {
+                checksumFailure(offset);
+                return false;
+            }
+        }
+        std::memcpy(data, page, sizeof(T));
+        return true;
+    }
+
+    // Com T menor que o valor gravado, o resto dele é preservado: a página é
+    // lida antes e o CRC recalculado sobre o valor inteiro
     template <typename T>
     void writeData(long offset, const T* data) {
+        const std::size_t size = std::max(valueBytes(header, sizeof(T)), sizeof(T));
+        std::size_t bytes = sizeof(T);
+        char page[BLOCK_SIZE];
+        if (checksummed()) {
+            if (size > sizeof(T)) {
+                file.seekg(offset, std::ios::beg);
+                file.read(page, static_cast<std::streamsize>(size));
+                metrics.bptreeDataReads.inc();
+                metrics.bptreeSeeks.inc();
+                metrics.bptreeBytesRead.inc(size);
+                if (!file.good()) {
+                    file.clear();
+                    std::memset(page, 0, size);
+                }
+            }
+            std::memcpy(page, data, sizeof(T));
+            std::uint32_t checksum = crc32c(page, size);
+            std::memcpy(page + size, &checksum, sizeof(checksum));
+            bytes = size + sizeof(checksum);
+        } else {
+            std::memcpy(page, data, sizeof(T));
+        }
         file.seekp(offset, std::ios::beg);
-        file.write(reinterpret_cast<const char*>(data), sizeof(T));
+        file.write(page, static_cast<std::streamsize>(bytes));
         file.flush();
+        blocksWritten++;
+        metrics.bptreeDataWrites.inc();
+        metrics.bptreeSeeks.inc();
+        metrics.bptreeFlushes.inc();
+        metrics.bptreeBytesWritten.inc(bytes);
+    }
+
+    void checksumFailure(long offset) {
+        metrics.checksumFailures.inc();
+        std::cerr << "[ERRO] Checksum invalido na pagina " << offset / BLOCK_SIZE << " de " << fileName << std::endl;
     }
     
-    void resetStats() { blocksRead = 0; }
+    void resetStats() { blocksRead = 0; blocksWritten = 0; }
     std::size_t getBlocksRead() const { return blocksRead; }
+    std::size_t getBlocksWritten() const { return blocksWritten; }
 
 };
 
@@ -119,6 +292,7 @@ public:
         // Offsets de arquivo (long)
         long childrenOffsets[2 * M + 1];
         long nextLeafOffset;
+        std::uint32_t checksum; // CRC32C da parte viva do nó (FileManager::nodeChecksum)
     };
 
 protected:
@@ -129,21 +303,97 @@ public:
     ~BPlusTree();
 
     void insert(int key, T *data);
+    // Insere um lote ordenado por chave: chaves que caem na mesma folha são
+    // intercaladas nela com uma única leitura/escrita do nó
+    void insertSorted(const std::vector<std::pair<int, T>>& entries);
+    // Constrói, de baixo para cima, uma árvore ainda vazia a partir de entradas
+    // ordenadas por chave. O long de cada entrada vai direto para o slot da folha
+    // (sem página de dados), então só scanRange/search devem lê-lo: a árvore
+    // fica "index-only". Folhas e nós internos saem com ~3/4 da capacidade,
+    // deixando folga para insertSortedPayloads não dividir logo a cada chave.
+    bool bulkLoadPayloads(const std::vector<std::pair<int, long>>& entries);
+    // Manutenção de uma árvore de bulkLoadPayloads: como insertSorted e
+    // remove(key, value), mas o long vai para o slot da folha (e é procurado
+    // nele) em vez de numa página de dados. Chaves iguais às já presentes
+    // entram depois delas.
+    void insertSortedPayloads(const std::vector<std::pair<int, long>>& entries);
+    bool removePayload(int key, long payload);
     // Retorna o OFFSET do nó folha que contém a chave, ou 0 se não encontrar
     long search(int k); 
     // Retorna todos os offsets de dados associados a uma chave
     std::vector<long> searchAll(int k);
+    // Visita, em ordem, as entradas com lo <= chave <= hi; visit(key, dataOffset)
+    // devolve false para encerrar a varredura. Retorna quantas foram visitadas.
+    template <typename F>
+    std::size_t scanRange(int lo, int hi, F visit);
+    // Lê o dado apontado por um offset devolvido por searchAll/scanRange
+    bool readValue(long dataOffset, T& value) { return fileManager->readData(dataOffset, &value); }
+    // Remove uma ocorrência da chave (a primeira, ou a que aponta para 'value'),
+    // redistribuindo/fundindo nós que fiquem abaixo de m chaves
+    bool remove(int key);
+    bool remove(int key, const T& value);
+    // Troca o dado associado ao par (key, oldValue) sem mexer na estrutura
+    bool update(int key, const T& oldValue, const T& newValue);
+    // Percorre todas as entradas na ordem das folhas; fn(key, value) devolve true
+    // quando alterou o valor, que então é regravado na página de dados
+    template <typename F>
+    void forEachValue(F fn);
     int getM() const { return m; }
+
+    // Colunas projetadas que o índice guarda ao lado do RID na página de dados
+    // (máscara de projecao.h). Só podem ser declaradas com a árvore vazia; quem
+    // lê o índice como BPlusTree<long> continua vendo só o RID no início do valor.
+    std::uint32_t projection() const { return fileManager->getHeader().projection; }
+    bool setProjection(std::uint32_t projection);
+
+    // Quantas folhas à frente as varreduras pela cadeia (searchAll, scanRange,
+    // forEachValue) pedem ao kernel; 0 desliga. Padrão: BPTREE_READAHEAD ou READ_AHEAD_PADRAO.
+    void setReadAhead(int depth) { readAheadDepth = depth < 0 ? 0 : depth; }
+    int getReadAhead() const { return readAheadDepth; }
     
     // Métodos para estatísticas de I/O
     void resetStats() { fileManager->resetStats(); }
     std::size_t getBlocksRead() const { return fileManager->getBlocksRead(); }
+    std::size_t getBlocksWritten() const { return fileManager->getBlocksWritten(); }
 
 private:
     long rootOffset;
     FileManager *fileManager;
+    int readAheadDepth;
+
+    // nó interno visitado na descida e índice do filho seguido
+    struct PathEntry {
+        long offset;
+        BPlusTreeNode node;
+        int childIdx;
+    };
+
+    // Read-ahead de uma varredura: os nós internos da descida dão os offsets
+    // das próximas folhas (que raramente são vizinhas no arquivo, então o
+    // read-ahead sequencial do kernel não ajuda). childIdx aponta para a última
+    // folha já antecipada; quando um pai acaba, o próximo nó interno é lido.
+    struct LeafReadAhead {
+        std::vector<PathEntry> path;
+        int ahead = 0; // folhas antecipadas e ainda não lidas
+        bool done = false;
+    };
+    long nextLeafToPrefetch(LeafReadAhead& ra);
+    // mantém readAheadDepth folhas antecipadas; chamada ao entrar em cada folha
+    void pumpReadAhead(LeafReadAhead& ra, bool enteredLeaf);
+
+    // localiza (key[, value]) guardando o caminho da raiz até a folha; com
+    // payload, compara o próprio slot da folha (árvores de bulkLoadPayloads)
+    bool locate(int key, const T* value, std::vector<PathEntry>& path,
+                long& leafOffset, BPlusTreeNode& leaf, int& pos, const long* payload = nullptr);
+    bool advanceLeaf(std::vector<PathEntry>& path, long& leafOffset, BPlusTreeNode& leaf);
+    // freeData = false quando o slot guarda um payload, não o offset de uma página
+    bool removeAt(std::vector<PathEntry>& path, long leafOffset, BPlusTreeNode& leaf, int pos, bool freeData = true);
+    void rebalanceInternal(std::vector<PathEntry>& path, long nodeOffset, BPlusTreeNode& node);
 
     void insert(int key, long dataOffset, long nodeOffset); // recursiva
+    // corpo de insertSorted; slotOf(entrada) dá o long gravado no slot da folha
+    template <typename E, typename S>
+    void mergeSorted(const std::vector<E>& entries, S slotOf);
 
     // utilidades
     long newNode(bool leaf);
@@ -152,13 +402,14 @@ private:
 
     // divisão & promoção
     void splitLeaf(long nodeOffset, int key, long dataOffset);
-    void splitInternal(long parentOffset, int promoteKey, long rightChildOffset);
+    void splitInternal(long parentOffset, int promoteKey, long leftChildOffset, long rightChildOffset);
 
     // função auxiliar para inserção em nós internos
-    void insertInternal(int key, long parentOffset, long childOffset);
+    void insertInternal(int key, long parentOffset, long leftChildOffset, long childOffset);
 
     // função auxiliar para encontrar o pai de um nó
     long findParent(long subrootOffset, long childOffset);
+    static int childSlot(const BPlusTreeNode& node, long childOffset);
 };
 
 
@@ -166,7 +417,9 @@ private:
 // Construtor: Inicializa FileManager e carrega a raiz (offset)
 template <typename T>
 BPlusTree<T>::BPlusTree(const std::string& filename) {
-    fileManager = new FileManager(filename, m);
+    fileManager = new FileManager(filename, m, sizeof(T));
+    const char* depth = std::getenv("BPTREE_READAHEAD");
+    setReadAhead(depth && *depth ? std::atoi(depth) : READ_AHEAD_PADRAO);
     
     auto header = fileManager->getHeader();
     rootOffset = header.rootOffset;
@@ -215,6 +468,157 @@ void BPlusTree<T>::insert(int key, T *data) {
     
     insert(key, dataOffset, rootOffset);
 }
+template <typename T>
+void BPlusTree<T>::insertSorted(const std::vector<std::pair<int, T>>& entries) {
+    mergeSorted(entries, [this](const std::pair<int, T>& e) {
+        long dataOffset = fileManager->getNewOffset();
+        fileManager->writeData(dataOffset, &e.second);
+        return dataOffset;
+    });
+}
+
+template <typename T>
+void BPlusTree<T>::insertSortedPayloads(const std::vector<std::pair<int, long>>& entries) {
+    mergeSorted(entries, [](const std::pair<int, long>& e) { return e.second; });
+}
+
+template <typename T>
+template <typename E, typename S>
+void BPlusTree<T>::mergeSorted(const std::vector<E>& entries, S slotOf) {
+    if (rootOffset == 0) {
+        rootOffset = newNode(true);
+        fileManager->updateRootOffset(rootOffset);
+    }
+
+    std::size_t i = 0;
+    while (i < entries.size()) {
+        // Desce até a folha da chave atual guardando o menor separador à direita,
+        // que delimita as chaves que pertencem a essa mesma folha
+        long leafOffset = rootOffset;
+        BPlusTreeNode leaf;
+        bool hasUpper = false;
+        int upper = 0;
+        while (true) {
+            if (!fileManager->readNode<T>(leafOffset, leaf)) return;
+            if (leaf.isLeaf) break;
+            int c = upperBound(leaf.keys, leaf.numKeys, entries[i].first);
+            if (c < leaf.numKeys) {
+                hasUpper = true;
+                upper = leaf.keys[c];
+            }
+            leafOffset = leaf.childrenOffsets[c];
+        }
+
+        std::size_t j = i;
+        while (j < entries.size()
+               && leaf.numKeys + static_cast<int>(j - i) < 2 * m
+               && (!hasUpper || entries[j].first < upper)) {
+            ++j;
+        }
+
+        if (j == i) {
+            // Folha cheia: caminho normal, com divisão
+            insert(entries[i].first, slotOf(entries[i]), rootOffset);
+            ++i;
+            continue;
+        }
+
+        // Intercala (de trás para frente) as chaves do lote com as da folha
+        int total = leaf.numKeys + static_cast<int>(j - i);
+        int a = leaf.numKeys - 1;
+        long b = static_cast<long>(j) - 1;
+        for (int pos = total - 1; pos >= 0; --pos) {
+            if (b >= static_cast<long>(i) && (a < 0 || leaf.keys[a] <= entries[b].first)) {
+                leaf.keys[pos] = entries[b].first;
+                leaf.childrenOffsets[pos] = slotOf(entries[b]);
+                --b;
+            } else {
+                leaf.keys[pos] = leaf.keys[a];
+                leaf.childrenOffsets[pos] = leaf.childrenOffsets[a];
+                --a;
+            }
+        }
+        leaf.numKeys = total;
+        fileManager->writeNode<T>(leafOffset, leaf);
+        i = j;
+    }
+}
+
+template <typename T>
+bool BPlusTree<T>::setProjection(std::uint32_t projection) {
+    BPlusTreeNode root;
+    if (!fileManager->readNode<T>(rootOffset, root) || !root.isLeaf || root.numKeys != 0) return false;
+    fileManager->setProjection(projection);
+    return true;
+}
+
+template <typename T>
+bool BPlusTree<T>::bulkLoadPayloads(const std::vector<std::pair<int, long>>& entries) {
+    BPlusTreeNode node;
+    if (!fileManager->readNode<T>(rootOffset, node) || !node.isLeaf || node.numKeys != 0) return false;
+    if (entries.empty()) return true;
+
+    // Divide n itens em grupos de tamanhos iguais (±1) com cerca de 'alvo' itens
+    // cada; com mais de um grupo, nenhum fica abaixo de 'minimo'
+    auto numGrupos = [](std::size_t n, std::size_t alvo, std::size_t minimo) {
+        std::size_t grupos = (n + alvo - 1) / alvo;
+        if (grupos > 1 && n / grupos < minimo) grupos = std::max<std::size_t>(1, n / minimo);
+        return grupos;
+    };
+    auto tamanhoGrupo = [](std::size_t n, std::size_t grupos, std::size_t g) {
+        return n / grupos + (g < n % grupos ? 1 : 0);
+    };
+
+    // folhas: a primeira reaproveita a raiz vazia
+    std::size_t numFolhas = numGrupos(entries.size(), std::max(m, 3 * (2 * m) / 4), m);
+    std::vector<long> offsets(numFolhas);
+    offsets[0] = rootOffset;
+    for (std::size_t f = 1; f < numFolhas; ++f) offsets[f] = fileManager->getNewOffset();
+
+    std::vector<std::pair<int, long>> nivel; // (primeira chave, offset) de cada nó do nível
+    nivel.reserve(numFolhas);
+    std::size_t e = 0;
+    for (std::size_t f = 0; f < numFolhas; ++f) {
+        std::memset(&node, 0, sizeof(node));
+        node.isLeaf = true;
+        node.numKeys = static_cast<int>(tamanhoGrupo(entries.size(), numFolhas, f));
+        for (int k = 0; k < node.numKeys; ++k, ++e) {
+            node.keys[k] = entries[e].first;
+            node.childrenOffsets[k] = entries[e].second;
+        }
+        node.nextLeafOffset = f + 1 < numFolhas ? offsets[f + 1] : 0;
+        fileManager->writeNode<T>(offsets[f], node);
+        nivel.push_back({node.keys[0], offsets[f]});
+    }
+
+    // níveis internos: o separador de cada filho (menos o primeiro) é a sua menor chave
+    while (nivel.size() > 1) {
+        std::size_t numNos = numGrupos(nivel.size(), std::max(m + 1, 3 * (2 * m + 1) / 4), m + 1);
+        std::vector<std::pair<int, long>> acima;
+        acima.reserve(numNos);
+        std::size_t c = 0;
+        for (std::size_t g = 0; g < numNos; ++g) {
+            std::size_t filhos = tamanhoGrupo(nivel.size(), numNos, g);
+            std::memset(&node, 0, sizeof(node));
+            node.isLeaf = false;
+            node.numKeys = static_cast<int>(filhos) - 1;
+            int primeira = nivel[c].first;
+            for (std::size_t k = 0; k < filhos; ++k, ++c) {
+                if (k > 0) node.keys[k - 1] = nivel[c].first;
+                node.childrenOffsets[k] = nivel[c].second;
+            }
+            long offset = fileManager->getNewOffset();
+            fileManager->writeNode<T>(offset, node);
+            acima.push_back({primeira, offset});
+        }
+        nivel.swap(acima);
+    }
+
+    rootOffset = nivel[0].second;
+    fileManager->updateRootOffset(rootOffset);
+    return true;
+}
+
 /*
 Função de inserção em uma árvore B+
 Parâmetros:
@@ -265,6 +669,7 @@ Divide nó folha cheio e promove a menor chave do novo nó (separator key).
 */
 template <typename T>
 void BPlusTree<T>::splitLeaf(long nodeOffset, int key, long dataOffset) { 
+    StorageMetrics::get().bptreeLeafSplits.inc();
     typename BPlusTree<T>::BPlusTreeNode node;
     fileManager->readNode<T>(nodeOffset, node);
 
@@ -334,18 +739,29 @@ void BPlusTree<T>::splitLeaf(long nodeOffset, int key, long dataOffset) {
         fileManager->updateRootOffset(newRootOffset);
     } 
     else 
-        insertInternal(promoteKey, parentOffset, newLeafOffset);
+        insertInternal(promoteKey, parentOffset, nodeOffset, newLeafOffset);
     
     fileManager->writeNode<T>(nodeOffset, node);
     fileManager->writeNode<T>(newLeafOffset, newLeaf);
 }
 
+// Posição de childOffset entre os filhos de um nó interno
+template <typename T>
+int BPlusTree<T>::childSlot(const BPlusTreeNode& node, long childOffset) {
+    for (int i = 0; i <= node.numKeys; ++i)
+        if (node.childrenOffsets[i] == childOffset) return i;
+    return -1;
+}
+
 /*
 Inserção em nó interno (semelhante à de folha, mas deslocando também ponteiros de filhos).
+O novo filho entra logo à direita do filho que foi dividido (leftChildOffset):
+com chaves repetidas a posição pela chave é ambígua e separaria o nó da sua
+metade, divergindo do encadeamento das folhas.
 Pode disparar divisão de nó interno.
 */
 template <typename T>
-void BPlusTree<T>::insertInternal(int key, long parentOffset, long childOffset) {
+void BPlusTree<T>::insertInternal(int key, long parentOffset, long leftChildOffset, long childOffset) {
     if (parentOffset == 0) {
         long newRootOffset = newNode(false);
         typename BPlusTree<T>::BPlusTreeNode newRoot;
@@ -367,36 +783,37 @@ void BPlusTree<T>::insertInternal(int key, long parentOffset, long childOffset)
     fileManager->readNode<T>(parentOffset, parentNode);
 
     if (parentNode.numKeys < 2 * m) {
+        int slot = childSlot(parentNode, leftChildOffset);
         int i = parentNode.numKeys - 1;
-        while (i >= 0 && parentNode.keys[i] > key) {
+        while (i >= slot) {
             parentNode.keys[i + 1] = parentNode.keys[i];
             parentNode.childrenOffsets[i + 2] = parentNode.childrenOffsets[i + 1];
             --i;
         }
-        parentNode.keys[i + 1] = key;
-        parentNode.childrenOffsets[i + 2] = childOffset;
+        parentNode.keys[slot] = key;
+        parentNode.childrenOffsets[slot + 1] = childOffset;
         parentNode.numKeys++;
 
         fileManager->writeNode<T>(parentOffset, parentNode);
         return;
     }
 
-    splitInternal(parentOffset, key, childOffset);
+    splitInternal(parentOffset, key, leftChildOffset, childOffset);
 }
 
 /*
-Divisão de nó interno: insere (key, rightChild), e então promove a chave do meio.
+Divisão de nó interno: insere (key, rightChild) à direita de leftChild, e então promove a chave do meio.
 */
 template <typename T>
-void BPlusTree<T>::splitInternal(long parentOffset, int promoteKey, long rightChildOffset) {
+void BPlusTree<T>::splitInternal(long parentOffset, int promoteKey, long leftChildOffset, long rightChildOffset) {
+    StorageMetrics::get().bptreeInternalSplits.inc();
     typename BPlusTree<T>::BPlusTreeNode parentNode;
     fileManager->readNode<T>(parentOffset, parentNode);
 
     int tmpKeys[2 * M + 1];
     long tmpChildrenOffsets[2 * M + 2]; 
 
-    int i, j, pos = 0;
-    while (pos < parentNode.numKeys && parentNode.keys[pos] < promoteKey) pos++;
+    int i, j, pos = childSlot(parentNode, leftChildOffset);
 
     for (i = 0; i < pos; ++i) {
         tmpKeys[i] = parentNode.keys[i];
@@ -451,7 +868,7 @@ void BPlusTree<T>::splitInternal(long parentOffset, int promoteKey, long rightCh
     } 
     else {
         long grandparentOffset = findParent(rootOffset, parentOffset);
-        insertInternal(upKey, grandparentOffset, newRightOffset);
+        insertInternal(upKey, grandparentOffset, parentOffset, newRightOffset);
     }
 
     fileManager->writeNode<T>(parentOffset, parentNode);
@@ -494,12 +911,18 @@ long BPlusTree<T>::search(int k) {
         return 0; // Árvore vazia
     }
 
-    // Desce até folha
+    // Desce até folha (lowerBound, como searchAll: com chaves duplicadas e após
+    // remoções a primeira ocorrência pode estar à esquerda do separador igual a k)
     while (true) {
         fileManager->readNode<T>(currentOffset, currentNode); 
         
         if (currentNode.isLeaf) {
             int pos = lowerBound(currentNode.keys, currentNode.numKeys, k);
+            while (pos == currentNode.numKeys && currentNode.nextLeafOffset != 0) {
+                currentOffset = currentNode.nextLeafOffset;
+                if (!fileManager->readNode<T>(currentOffset, currentNode)) return 0;
+                pos = lowerBound(currentNode.keys, currentNode.numKeys, k);
+            }
             
             if (pos < currentNode.numKeys && currentNode.keys[pos] == k) {
                 return currentOffset; 
@@ -507,7 +930,7 @@ long BPlusTree<T>::search(int k) {
             else return 0;
         }
 
-        int i = upperBound(currentNode.keys, currentNode.numKeys, k);
+        int i = lowerBound(currentNode.keys, currentNode.numKeys, k);
         currentOffset = currentNode.childrenOffsets[i];
 
         if (currentOffset == 0) {
@@ -526,6 +949,7 @@ std::vector<long> BPlusTree<T>::searchAll(int k) {
 
     long nodeOffset = rootOffset;
     BPlusTreeNode node;
+    LeafReadAhead ra;
     while (true) {
         if (!fileManager->readNode<T>(nodeOffset, node)) return results;
 
@@ -534,6 +958,7 @@ std::vector<long> BPlusTree<T>::searchAll(int k) {
         int i = lowerBound(node.keys, node.numKeys, k);
         long child = node.childrenOffsets[i];
         if (child == 0) return results; // estrutura inconsistente
+        ra.path.push_back({nodeOffset, node, i});
         nodeOffset = child;
     }
 
@@ -545,6 +970,8 @@ std::vector<long> BPlusTree<T>::searchAll(int k) {
     while (true) {
         if (idx >= leaf.numKeys) {
             if (leaf.nextLeafOffset == 0) break;
+            // só chega aqui quando as duplicatas atravessam folhas
+            pumpReadAhead(ra, true);
             if (!fileManager->readNode<T>(leaf.nextLeafOffset, leaf)) break;
             curLeafOffset = leaf.nextLeafOffset;
             idx = 0;
@@ -568,12 +995,414 @@ std::vector<long> BPlusTree<T>::searchAll(int k) {
 }
 
 
+template <typename T>
+template <typename F>
+std::size_t BPlusTree<T>::scanRange(int lo, int hi, F visit) {
+    std::size_t visited = 0;
+    if (rootOffset == 0 || lo > hi) return visited;
+
+    long offset = rootOffset;
+    BPlusTreeNode node;
+    LeafReadAhead ra;
+    while (true) {
+        if (!fileManager->readNode<T>(offset, node)) return visited;
+        if (node.isLeaf) break;
+        int i = lowerBound(node.keys, node.numKeys, lo);
+        ra.path.push_back({offset, node, i});
+        offset = node.childrenOffsets[i];
+    }
+
+    int idx = lowerBound(node.keys, node.numKeys, lo);
+    while (true) {
+        for (; idx < node.numKeys; ++idx) {
+            if (node.keys[idx] > hi) return visited;
+            visited++;
+            if (!visit(node.keys[idx], node.childrenOffsets[idx])) return visited;
+        }
+        if (node.nextLeafOffset == 0) break;
+        // a faixa continua além da primeira folha: a partir daqui vale antecipar
+        pumpReadAhead(ra, true);
+        if (!fileManager->readNode<T>(node.nextLeafOffset, node)) break;
+        idx = 0;
+    }
+    return visited;
+}
+
+template <typename T>
+template <typename F>
+void BPlusTree<T>::forEachValue(F fn) {
+    if (rootOffset == 0) return;
+
+    long offset = rootOffset;
+    BPlusTreeNode node;
+    LeafReadAhead ra;
+    while (true) {
+        if (!fileManager->readNode<T>(offset, node)) return;
+        if (node.isLeaf) break;
+        ra.path.push_back({offset, node, 0});
+        offset = node.childrenOffsets[0];
+    }
+    pumpReadAhead(ra, false);
+
+    while (true) {
+        // as páginas de dados da folha também ficam espalhadas pelo arquivo
+        if (readAheadDepth > 0) {
+            for (int i = 0; i < node.numKeys; ++i) fileManager->prefetch(node.childrenOffsets[i], sizeof(T));
+        }
+        for (int i = 0; i < node.numKeys; ++i) {
+            T value;
+            if (!fileManager->readData(node.childrenOffsets[i], &value)) continue;
+            if (fn(node.keys[i], value)) {
+                fileManager->writeData(node.childrenOffsets[i], &value);
+            }
+        }
+        if (node.nextLeafOffset == 0) break;
+        pumpReadAhead(ra, true);
+        if (!fileManager->readNode<T>(node.nextLeafOffset, node)) break;
+    }
+}
+
+template <typename T>
+long BPlusTree<T>::nextLeafToPrefetch(LeafReadAhead& ra) {
+    // sobe até um nível que ainda tenha filhos à direita
+    std::size_t level = ra.path.size();
+    while (level > 0 && ra.path[level - 1].childIdx >= ra.path[level - 1].node.numKeys) level--;
+    if (level == 0) return 0;
+    ra.path[level - 1].childIdx++;
+    // e desce pela borda esquerda até o pai das folhas
+    for (; level < ra.path.size(); ++level) {
+        const PathEntry& above = ra.path[level - 1];
+        PathEntry& entry = ra.path[level];
+        entry.offset = above.node.childrenOffsets[above.childIdx];
+        if (!fileManager->readNode<T>(entry.offset, entry.node) || entry.node.isLeaf) return 0;
+        entry.childIdx = 0;
+    }
+    const PathEntry& parent = ra.path.back();
+    return parent.node.childrenOffsets[parent.childIdx];
+}
+
+template <typename T>
+void BPlusTree<T>::pumpReadAhead(LeafReadAhead& ra, bool enteredLeaf) {
+    if (readAheadDepth <= 0) return;
+    if (enteredLeaf && ra.ahead > 0) ra.ahead--;
+    while (!ra.done && ra.ahead < readAheadDepth) {
+        long leafOffset = nextLeafToPrefetch(ra);
+        if (leafOffset == 0) {
+            ra.done = true;
+            break;
+        }
+        fileManager->prefetch(leafOffset, sizeof(BPlusTreeNode));
+        ra.ahead++;
+    }
+}
+
+// ---------- remoção ----------
+
+template <typename T>
+bool BPlusTree<T>::remove(int key) {
+    std::vector<PathEntry> path;
+    long leafOffset;
+    BPlusTreeNode leaf;
+    int pos;
+    if (!locate(key, nullptr, path, leafOffset, leaf, pos)) return false;
+    return removeAt(path, leafOffset, leaf, pos);
+}
+
+template <typename T>
+bool BPlusTree<T>::remove(int key, const T& value) {
+    std::vector<PathEntry> path;
+    long leafOffset;
+    BPlusTreeNode leaf;
+    int pos;
+    if (!locate(key, &value, path, leafOffset, leaf, pos)) return false;
+    return removeAt(path, leafOffset, leaf, pos);
+}
+
+template <typename T>
+bool BPlusTree<T>::removePayload(int key, long payload) {
+    std::vector<PathEntry> path;
+    long leafOffset;
+    BPlusTreeNode leaf;
+    int pos;
+    if (!locate(key, nullptr, path, leafOffset, leaf, pos, &payload)) return false;
+    return removeAt(path, leafOffset, leaf, pos, false);
+}
+
+template <typename T>
+bool BPlusTree<T>::update(int key, const T& oldValue, const T& newValue) {
+    std::vector<PathEntry> path;
+    long leafOffset;
+    BPlusTreeNode leaf;
+    int pos;
+    if (!locate(key, &oldValue, path, leafOffset, leaf, pos)) return false;
+    fileManager->writeData(leaf.childrenOffsets[pos], &newValue);
+    return true;
+}
+
+// Desce com lowerBound (como searchAll) e percorre as duplicatas da chave,
+// avançando de folha pelo caminho para que o pai de cada folha seja conhecido
+template <typename T>
+bool BPlusTree<T>::locate(int key, const T* value, std::vector<PathEntry>& path,
+                          long& leafOffset, BPlusTreeNode& leaf, int& pos, const long* payload) {
+    path.clear();
+    if (rootOffset == 0) return false;
+
+    leafOffset = rootOffset;
+    while (true) {
+        if (!fileManager->readNode<T>(leafOffset, leaf)) return false;
+        if (leaf.isLeaf) break;
+        int i = lowerBound(leaf.keys, leaf.numKeys, key);
+        path.push_back({leafOffset, leaf, i});
+        leafOffset = leaf.childrenOffsets[i];
+    }
+
+    pos = lowerBound(leaf.keys, leaf.numKeys, key);
+    while (true) {
+        for (; pos < leaf.numKeys; ++pos) {
+            if (leaf.keys[pos] != key) return false;
+            if (payload != nullptr) {
+                if (leaf.childrenOffsets[pos] == *payload) return true;
+                continue;
+            }
+            if (value == nullptr) return true;
+            T stored;
+            if (fileManager->readData(leaf.childrenOffsets[pos], &stored)
+                && std::memcmp(&stored, value, sizeof(T)) == 0) {
+                return true;
+            }
+        }
+        if (!advanceLeaf(path, leafOffset, leaf)) return false;
+        pos = 0;
+    }
+}
+
+// Vai para a folha seguinte subindo pelo caminho até um nó com irmão à direita
+template <typename T>
+bool BPlusTree<T>::advanceLeaf(std::vector<PathEntry>& path, long& leafOffset, BPlusTreeNode& leaf) {
+    while (!path.empty() && path.back().childIdx >= path.back().node.numKeys) {
+        path.pop_back();
+    }
+    if (path.empty()) return false;
+
+    path.back().childIdx++;
+    long offset = path.back().node.childrenOffsets[path.back().childIdx];
+    while (true) {
+        if (!fileManager->readNode<T>(offset, leaf)) return false;
+        if (leaf.isLeaf) break;
+        path.push_back({offset, leaf, 0});
+        offset = leaf.childrenOffsets[0];
+    }
+    leafOffset = offset;
+    return true;
+}
+
+template <typename T>
+bool BPlusTree<T>::removeAt(std::vector<PathEntry>& path, long leafOffset, BPlusTreeNode& leaf, int pos, bool freeData) {
+    if (freeData) fileManager->freeOffset(leaf.childrenOffsets[pos]); // página do dado
+
+    for (int i = pos; i < leaf.numKeys - 1; ++i) {
+        leaf.keys[i] = leaf.keys[i + 1];
+        leaf.childrenOffsets[i] = leaf.childrenOffsets[i + 1];
+    }
+    leaf.numKeys--;
+    leaf.childrenOffsets[leaf.numKeys] = 0; // não deixa o offset da página liberada para trás
+
+    if (leafOffset == rootOffset || leaf.numKeys >= m) {
+        fileManager->writeNode<T>(leafOffset, leaf);
+        return true;
+    }
+
+    BPlusTreeNode parent = path.back().node; // cópia: o caminho é desempilhado antes de subir
+    long parentOffset = path.back().offset;
+    int idx = path.back().childIdx;
+
+    BPlusTreeNode left, right;
+    bool hasLeft = idx > 0 && fileManager->readNode<T>(parent.childrenOffsets[idx - 1], left);
+    bool hasRight = idx < parent.numKeys && fileManager->readNode<T>(parent.childrenOffsets[idx + 1], right);
+
+    if (hasLeft && left.numKeys > m) {
+        // empresta a última chave do irmão esquerdo
+        for (int i = leaf.numKeys; i > 0; --i) {
+            leaf.keys[i] = leaf.keys[i - 1];
+            leaf.childrenOffsets[i] = leaf.childrenOffsets[i - 1];
+        }
+        leaf.keys[0] = left.keys[left.numKeys - 1];
+        leaf.childrenOffsets[0] = left.childrenOffsets[left.numKeys - 1];
+        leaf.numKeys++;
+        left.numKeys--;
+        parent.keys[idx - 1] = leaf.keys[0];
+
+        StorageMetrics::get().bptreeBorrows.inc();
+        fileManager->writeNode<T>(parent.childrenOffsets[idx - 1], left);
+        fileManager->writeNode<T>(leafOffset, leaf);
+        fileManager->writeNode<T>(parentOffset, parent);
+        return true;
+    }
+
+    if (hasRight && right.numKeys > m) {
+        // empresta a primeira chave do irmão direito
+        leaf.keys[leaf.numKeys] = right.keys[0];
+        leaf.childrenOffsets[leaf.numKeys] = right.childrenOffsets[0];
+        leaf.numKeys++;
+        for (int i = 0; i < right.numKeys - 1; ++i) {
+            right.keys[i] = right.keys[i + 1];
+            right.childrenOffsets[i] = right.childrenOffsets[i + 1];
+        }
+        right.numKeys--;
+        parent.keys[idx] = right.keys[0];
+
+        StorageMetrics::get().bptreeBorrows.inc();
+        fileManager->writeNode<T>(parent.childrenOffsets[idx + 1], right);
+        fileManager->writeNode<T>(leafOffset, leaf);
+        fileManager->writeNode<T>(parentOffset, parent);
+        return true;
+    }
+
+    // fusão: o nó da direita é absorvido pelo da esquerda e some do pai
+    int removedKey;
+    if (hasLeft || hasRight) StorageMetrics::get().bptreeMerges.inc();
+    if (hasLeft) {
+        for (int i = 0; i < leaf.numKeys; ++i) {
+            left.keys[left.numKeys + i] = leaf.keys[i];
+            left.childrenOffsets[left.numKeys + i] = leaf.childrenOffsets[i];
+        }
+        left.numKeys += leaf.numKeys;
+        left.nextLeafOffset = leaf.nextLeafOffset;
+        fileManager->writeNode<T>(parent.childrenOffsets[idx - 1], left);
+        fileManager->freeOffset(leafOffset);
+        removedKey = idx - 1;
+    } else if (hasRight) {
+        for (int i = 0; i < right.numKeys; ++i) {
+            leaf.keys[leaf.numKeys + i] = right.keys[i];
+            leaf.childrenOffsets[leaf.numKeys + i] = right.childrenOffsets[i];
+        }
+        leaf.numKeys += right.numKeys;
+        leaf.nextLeafOffset = right.nextLeafOffset;
+        fileManager->writeNode<T>(leafOffset, leaf);
+        fileManager->freeOffset(parent.childrenOffsets[idx + 1]);
+        removedKey = idx;
+    } else {
+        fileManager->writeNode<T>(leafOffset, leaf);
+        return true;
+    }
+
+    for (int i = removedKey; i < parent.numKeys - 1; ++i) {
+        parent.keys[i] = parent.keys[i + 1];
+    }
+    for (int i = removedKey + 1; i < parent.numKeys; ++i) {
+        parent.childrenOffsets[i] = parent.childrenOffsets[i + 1];
+    }
+    parent.numKeys--;
+
+    path.pop_back();
+    rebalanceInternal(path, parentOffset, parent);
+    return true;
+}
+
+// Mesma lógica para nós internos: a chave separadora do pai desce/sobe junto com o filho movido
+template <typename T>
+void BPlusTree<T>::rebalanceInternal(std::vector<PathEntry>& path, long nodeOffset, BPlusTreeNode& node) {
+    if (nodeOffset == rootOffset) {
+        if (node.numKeys == 0 && !node.isLeaf) {
+            // raiz sem chaves: o único filho vira a raiz e a altura diminui
+            rootOffset = node.childrenOffsets[0];
+            fileManager->updateRootOffset(rootOffset);
+            fileManager->freeOffset(nodeOffset);
+        } else {
+            fileManager->writeNode<T>(nodeOffset, node);
+        }
+        return;
+    }
+
+    if (node.numKeys >= m) {
+        fileManager->writeNode<T>(nodeOffset, node);
+        return;
+    }
+
+    BPlusTreeNode parent = path.back().node; // cópia: o caminho é desempilhado antes de subir
+    long parentOffset = path.back().offset;
+    int idx = path.back().childIdx;
+
+    BPlusTreeNode left, right;
+    bool hasLeft = idx > 0 && fileManager->readNode<T>(parent.childrenOffsets[idx - 1], left);
+    bool hasRight = idx < parent.numKeys && fileManager->readNode<T>(parent.childrenOffsets[idx + 1], right);
+
+    if (hasLeft && left.numKeys > m) {
+        for (int i = node.numKeys; i > 0; --i) node.keys[i] = node.keys[i - 1];
+        for (int i = node.numKeys + 1; i > 0; --i) node.childrenOffsets[i] = node.childrenOffsets[i - 1];
+        node.keys[0] = parent.keys[idx - 1];
+        node.childrenOffsets[0] = left.childrenOffsets[left.numKeys];
+        node.numKeys++;
+        parent.keys[idx - 1] = left.keys[left.numKeys - 1];
+        left.numKeys--;
+
+        StorageMetrics::get().bptreeBorrows.inc();
+        fileManager->writeNode<T>(parent.childrenOffsets[idx - 1], left);
+        fileManager->writeNode<T>(nodeOffset, node);
+        fileManager->writeNode<T>(parentOffset, parent);
+        return;
+    }
+
+    if (hasRight && right.numKeys > m) {
+        node.keys[node.numKeys] = parent.keys[idx];
+        node.childrenOffsets[node.numKeys + 1] = right.childrenOffsets[0];
+        node.numKeys++;
+        parent.keys[idx] = right.keys[0];
+        for (int i = 0; i < right.numKeys - 1; ++i) right.keys[i] = right.keys[i + 1];
+        for (int i = 0; i < right.numKeys; ++i) right.childrenOffsets[i] = right.childrenOffsets[i + 1];
+        right.numKeys--;
+
+        StorageMetrics::get().bptreeBorrows.inc();
+        fileManager->writeNode<T>(parent.childrenOffsets[idx + 1], right);
+        fileManager->writeNode<T>(nodeOffset, node);
+        fileManager->writeNode<T>(parentOffset, parent);
+        return;
+    }
+
+    int removedKey;
+    if (hasLeft || hasRight) StorageMetrics::get().bptreeMerges.inc();
+    if (hasLeft) {
+        left.keys[left.numKeys] = parent.keys[idx - 1];
+        for (int i = 0; i < node.numKeys; ++i) left.keys[left.numKeys + 1 + i] = node.keys[i];
+        for (int i = 0; i <= node.numKeys; ++i) left.childrenOffsets[left.numKeys + 1 + i] = node.childrenOffsets[i];
+        left.numKeys += node.numKeys + 1;
+        fileManager->writeNode<T>(parent.childrenOffsets[idx - 1], left);
+        fileManager->freeOffset(nodeOffset);
+        removedKey = idx - 1;
+    } else if (hasRight) {
+        node.keys[node.numKeys] = parent.keys[idx];
+        for (int i = 0; i < right.numKeys; ++i) node.keys[node.numKeys + 1 + i] = right.keys[i];
+        for (int i = 0; i <= right.numKeys; ++i) node.childrenOffsets[node.numKeys + 1 + i] = right.childrenOffsets[i];
+        node.numKeys += right.numKeys + 1;
+        fileManager->writeNode<T>(nodeOffset, node);
+        fileManager->freeOffset(parent.childrenOffsets[idx + 1]);
+        removedKey = idx;
+    } else {
+        fileManager->writeNode<T>(nodeOffset, node);
+        return;
+    }
+
+    for (int i = removedKey; i < parent.numKeys - 1; ++i) {
+        parent.keys[i] = parent.keys[i + 1];
+    }
+    for (int i = removedKey + 1; i < parent.numKeys; ++i) {
+        parent.childrenOffsets[i] = parent.childrenOffsets[i + 1];
+    }
+    parent.numKeys--;
+
+    path.pop_back();
+    rebalanceInternal(path, parentOffset, parent);
+}
+
 template <typename T>
 long BPlusTree<T>::findParent(long subrootOffset, long childOffset) {
     if (subrootOffset == childOffset || subrootOffset == 0) return 0; 
 
     typename BPlusTree<T>::BPlusTreeNode parentNode;
     fileManager->readNode<T>(subrootOffset, parentNode); 
+    // os offsets de uma folha são páginas de dados, não filhos; uma página de
+    // dados liberada pode ter virado o nó procurado
+    if (parentNode.isLeaf) return 0;
 
     for (int i = 0; i <= parentNode.numKeys; ++i) {
         if (parentNode.childrenOffsets[i] == childOffset) {
@@ -581,14 +1410,12 @@ long BPlusTree<T>::findParent(long subrootOffset, long childOffset) {
         }
     }
 
-    if (!parentNode.isLeaf) {
-        for (int i = 0; i <= parentNode.numKeys; ++i) {
-            long nextOffset = parentNode.childrenOffsets[i];
-            if (nextOffset != 0) {
-                // Chama findParent para o próximo nível
-                long result = findParent(nextOffset, childOffset);
-                if (result != 0) return result;
-            }
+    for (int i = 0; i <= parentNode.numKeys; ++i) {
+        long nextOffset = parentNode.childrenOffsets[i];
+        if (nextOffset != 0) {
+            // Chama findParent para o próximo nível
+            long result = findParent(nextOffset, childOffset);
+            if (result != 0) return result;
         }
     }
     return 0;
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+// Índice composto (ano asc, citacoes desc, id asc) para os "mais citados do ano"
+// (DB_DIR/ano_citacoes.idx), uma BPlusTree<long> construída com bulkLoadPayloads.
+//
+// A árvore só tem chaves int, então (ano, citacoes) vão empacotados na chave:
+// ano nos bits altos e o complemento das citações nos baixos, que ordena as
+// mais citadas primeiro. Citações acima de CITACOES_MAX_CHAVE empatam na chave.
+// Dentro de uma chave a construção deixa as entradas em ordem (citações reais,
+// depois id), mas o --append insere as do delta depois das iguais
+// (insertSortedPayloads); por isso a consulta lê inteiro o empate da k-ésima
+// entrada e reordena.
+// O slot da folha guarda (citacoes, id) no lugar do offset de dados, então a
+// consulta não lê nada além das folhas do ano.
+
+constexpr int BITS_CITACOES = 20;
+constexpr int CITACOES_MAX_CHAVE = (1 << BITS_CITACOES) - 1;
+constexpr int ANO_MAX_CHAVE = (1 << (31 - BITS_CITACOES)) - 1; // chave sempre positiva
+
+inline int chaveAnoCitacoes(int ano, int citacoes) {
+    if (ano < 0) ano = 0;
+    if (ano > ANO_MAX_CHAVE) ano = ANO_MAX_CHAVE;
+    if (citacoes < 0) citacoes = 0;
+    if (citacoes > CITACOES_MAX_CHAVE) citacoes = CITACOES_MAX_CHAVE;
+    return (ano << BITS_CITACOES) | (CITACOES_MAX_CHAVE - citacoes);
+}
+
+// Faixa [primeira, ultima] de chaves de um ano
+inline int primeiraChaveDoAno(int ano) { return chaveAnoCitacoes(ano, CITACOES_MAX_CHAVE); }
+inline int ultimaChaveDoAno(int ano) { return chaveAnoCitacoes(ano, 0); }
+
+inline long empacotarIdCitacoes(int id, int citacoes) {
+    return static_cast<long>((static_cast<std::uint64_t>(static_cast<std::uint32_t>(citacoes)) << 32)
+                             | static_cast<std::uint32_t>(id));
+}
+inline int idDoPayload(long payload) {
+    return static_cast<int>(static_cast<std::uint32_t>(static_cast<std::uint64_t>(payload)));
+}
+inline int citacoesDoPayload(long payload) {
+    return static_cast<int>(static_cast<std::uint32_t>(static_cast<std::uint64_t>(payload) >> 32));
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Índice aprendido ID -> RID, alternativo ao índice primário (B+ tree). Os IDs
+// são quase densos, então a posição de um ID no arranjo ordenado de pares
+// (id, rid) é bem aproximada por uma função linear por partes. A construção
+// (estilo PGM, "shrinking cone") gera o menor número de segmentos em uma
+// passada garantindo erro máximo ERRO_APRENDIDO em posições para toda chave
+// presente.
+//
+// Arquivos:
+//   modelo (DB_DIR/aprendido.mdl): cabeçalho (64 bytes) + segmentos, lido
+//     inteiro na abertura
+//   arranjo (DB_DIR/aprendido.arr): EntradaAprendida ordenadas por id
+// Uma busca avalia o segmento do ID (busca binária em memória) e lê com um
+// pread só a janela de 2*ERRO_APRENDIDO + 3 entradas em volta da posição
+// prevista (~1 KB), que quase sempre cabe em uma página de 4 KB.
+
+constexpr int ERRO_APRENDIDO = 32;
+
+struct EntradaAprendida {
+    std::int32_t id;
+    std::int32_t reservado;
+    std::int64_t rid;
+};
+
+// pares (id, rid) ordenados por id e sem IDs repetidos; grava arranjo e modelo
+// (nessa ordem, cada um por arquivo temporário + rename)
+bool gravarIndiceAprendido(const std::vector<std::pair<int, long>>& pares,
+                           const std::string& caminhoModelo, const std::string& caminhoArranjo,
+                           std::size_t* numSegmentos = nullptr);
+
+// --append: intercala pares (id, rid) novos, ordenados por id, com o arranjo
+// atual (o novo vence num ID repetido) e regrava arranjo e modelo. O modelo é
+// refeito sobre o arranjo inteiro, sem ler artigos.dat. false se o índice
+// atual não abre. numEntradas recebe o tamanho do arranjo gravado.
+bool mesclarIndiceAprendido(const std::vector<std::pair<int, long>>& novos,
+                            const std::string& caminhoModelo, const std::string& caminhoArranjo,
+                            std::size_t* numSegmentos = nullptr, std::size_t* numEntradas = nullptr);
+
+class IndiceAprendido {
+public:
+    IndiceAprendido() = default;
+    ~IndiceAprendido();
+    IndiceAprendido(const IndiceAprendido&) = delete;
+    IndiceAprendido& operator=(const IndiceAprendido&) = delete;
+
+    // false se algum arquivo falta ou se o arranjo não corresponde ao modelo
+    bool abrir(const std::string& caminhoModelo, const std::string& caminhoArranjo);
+
+    // RID do ID, ou -1 se não está no índice. paginas recebe quantas páginas de
+    // 4 KB do arranjo a janela lida tocou.
+    long buscar(int id, int& paginas) const;
+
+    std::size_t numEntradas() const { return numEntradas_; }
+    std::size_t numSegmentos() const { return segmentos_.size(); }
+
+private:
+    struct Segmento {
+        std::int32_t chave; // primeiro id do segmento
+        std::int32_t reservado;
+        double inclinacao;
+        std::int64_t inicio; // posição de 'chave' no arranjo
+    };
+    friend bool gravarIndiceAprendido(const std::vector<std::pair<int, long>>&, const std::string&,
+                                      const std::string&, std::size_t*);
+    friend bool mesclarIndiceAprendido(const std::vector<std::pair<int, long>>&, const std::string&,
+                                       const std::string&, std::size_t*, std::size_t*);
+
+    int fd_ = -1;
+    std::size_t numEntradas_ = 0;
+    std::vector<Segmento> segmentos_;
+    mutable std::vector<EntradaAprendida> janela_;
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Bloom filter blocado: cada chave escolhe um bloco de 64 bytes (uma linha de
+// cache) e liga k bits dentro dele, então uma consulta toca um único bloco.
+// O arquivo é um cabeçalho de 64 bytes seguido dos blocos; nas consultas ele é
+// mapeado com mmap, de modo que uma resposta negativa custa no máximo a página
+// do bloco e nenhuma leitura nos índices.
+class BloomFilter {
+public:
+    static constexpr std::size_t BLOCK_BYTES = 64;
+    static constexpr std::size_t BLOCK_BITS = BLOCK_BYTES * 8;
+    static constexpr std::size_t WORDS_PER_BLOCK = BLOCK_BYTES / sizeof(std::uint64_t);
+
+    BloomFilter() = default;
+    ~BloomFilter();
+    BloomFilter(const BloomFilter&) = delete;
+    BloomFilter& operator=(const BloomFilter&) = delete;
+
+    // Filtro vazio em memória dimensionado para 'capacidade' chaves com a taxa
+    // de falsos positivos 'fpr'
+    void criar(std::size_t capacidade, double fpr);
+
+    // Carrega o arquivo inteiro em memória (para acrescentar chaves e regravar)
+    bool carregar(const std::string& caminho);
+    // Mapeia o arquivo somente leitura (consultas)
+    bool abrir(const std::string& caminho);
+    bool salvar(const std::string& caminho) const;
+
+    void add(std::uint64_t hash);
+    bool mayContain(std::uint64_t hash) const;
+
+    bool aberto() const { return words_ != nullptr; }
+    std::size_t capacidade() const { return header_.capacidade; }
+    std::size_t inseridos() const { return header_.inseridos; }
+    double fpr() const { return header_.fpr; }
+    int hashes() const { return static_cast<int>(header_.k); }
+    std::size_t tamanhoBytes() const { return header_.numBlocos * BLOCK_BYTES; }
+
+private:
+    struct Header {
+        char magic[4];
+        std::uint32_t k;
+        std::uint64_t numBlocos;
+        std::uint64_t capacidade;
+        std::uint64_t inseridos;
+        double fpr;
+        char reservado[24];
+    };
+    static_assert(sizeof(Header) == BLOCK_BYTES, "cabecalho do bloom deve ocupar um bloco");
+
+    void liberar();
+
+    Header header_{};
+    std::vector<std::uint64_t> own_;       // filtro em memória (criar/carregar)
+    const std::uint64_t* words_ = nullptr; // aponta para own_ ou para o mapeamento
+    void* map_ = nullptr;
+    std::size_t mapLen_ = 0;
+};
+
+// Hashes de 64 bits das chaves filtradas (independentes do FNV-1a 32 do índice
+// secundário, para não herdar as colisões dele)
+std::uint64_t bloomHashId(int id);
+std::uint64_t bloomHashTitulo(const std::string& tituloNormalizado);
+
+// Taxa de falsos positivos configurada (BLOOM_FPR, padrão 0.01)
+double bloomFprFromEnv();
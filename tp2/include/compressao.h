@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Cópia comprimida de artigos.dat (DATA_DIR/artigos.lz), opcional, para as
+// leituras por RID. Grupos de BLOCOS_POR_GRUPO blocos consecutivos são
+// comprimidos de forma independente com o codec de lz.h; antes disso os bytes
+// depois do terminador de cada campo de texto e os slots livres são zerados,
+// então o preenchimento com NULs custa quase nada.
+//
+// Arquivo, mapeado com mmap nas consultas:
+//   cabeçalho (64 bytes) | grupos comprimidos | tabela com numGrupos + 1 offsets
+// Ler o bloco b custa uma leitura do grupo b / BLOCOS_POR_GRUPO (posição vinda
+// da tabela) e a descompressão só até o fim do bloco pedido.
+//
+// O arquivo guarda o tamanho de artigos.dat de que foi gerado; se não bater, a
+// cópia está desatualizada e as consultas voltam a ler artigos.dat.
+
+// 4 blocos (8 registros, ~12 KB): com 8 a taxa melhora pouco e a leitura fica
+// bem mais lenta, porque em média se descomprime metade do grupo
+constexpr std::size_t BLOCOS_POR_GRUPO = 4;
+
+struct Bloco;
+
+class CompressorDeDados {
+public:
+    bool iniciar(const std::string& caminho);
+    // Os blocos devem chegar na ordem do arquivo
+    bool adicionarBloco(const Bloco& bloco);
+    // Fecha o último grupo, grava a tabela e troca o arquivo de uma vez
+    bool finalizar();
+
+    // --append: regrava 'caminho' recomprimindo só os grupos com algum bloco em
+    // 'blocosAlterados' (ordenados) ou além do fim anterior, lidos de 'dados';
+    // os demais grupos são copiados já comprimidos. false se a cópia atual não
+    // foi gerada de 'dados' com 'tamanhoAnterior' bytes.
+    bool atualizar(const std::string& caminho, const std::string& dados, std::uint64_t tamanhoAnterior,
+                   const std::vector<long>& blocosAlterados);
+
+    std::size_t numBlocos() const { return numBlocos_; }
+    std::uint64_t bytesOriginais() const { return bytesOriginais_; }
+    std::uint64_t bytesComprimidos() const { return offsets_.empty() ? 0 : offsets_.back(); }
+
+private:
+    bool fecharGrupo();
+
+    std::string caminho_;
+    std::ofstream out_;
+    std::vector<char> grupo_; // blocos normalizados do grupo corrente
+    std::size_t noGrupo_ = 0;
+    std::string comprimido_;
+    std::vector<std::uint64_t> offsets_;
+    std::size_t numBlocos_ = 0;
+    std::uint64_t bytesOriginais_ = 0;
+};
+
+class DadosComprimidos {
+public:
+    DadosComprimidos() = default;
+    ~DadosComprimidos();
+    DadosComprimidos(const DadosComprimidos&) = delete;
+    DadosComprimidos& operator=(const DadosComprimidos&) = delete;
+
+    // Mapeia o arquivo; false se ausente, inválido ou gerado de outra versão de
+    // 'caminhoOrigem' (comparando o tamanho)
+    bool abrir(const std::string& caminho, const std::string& caminhoOrigem);
+    bool aberto() const { return base_ != nullptr; }
+
+    std::size_t numBlocos() const;
+    // Copia o bloco 'indice' (mesma numeração de artigos.dat) para 'bloco'
+    bool lerBloco(std::size_t indice, Bloco& bloco) const;
+
+private:
+    const unsigned char* base_ = nullptr;
+    std::size_t tamanho_ = 0;
+    mutable std::vector<char> buffer_; // grupo descomprimido (parcialmente)
+};
+
+// COMPRESSAO_DADOS=1 no upload gera a cópia comprimida; depois que ela existe,
+// as reconstruções a mantêm atualizada
+bool compressaoDadosAtiva(const std::string& caminho);
@@ -16,9 +16,57 @@ const std::string DB_DIR = getEnv("DB_DIR", DATA_DIR + "/db");
 
 // caminhos completos 
 const std::string ARTIGO_DAT = DATA_DIR + "/artigos.dat";
+const std::string ARTIGO_LZ = DATA_DIR + "/artigos.lz";
 const std::string TABELA_HASH= DB_DIR + "/tabela_hash.idx";
 const std::string PRIM_INDEX= DB_DIR + "/prim_index.idx";
 const std::string SEC_INDEX= DB_DIR + "/sec_index.idx";
 const std::string ARTIGO_CSV = DATA_DIR + "/artigo.csv";
+const std::string BLOOM_ID = DB_DIR + "/bloom_id.blm";
+const std::string BLOOM_TITULO = DB_DIR + "/bloom_titulo.blm";
+const std::string INDICE_INVERTIDO = DB_DIR + "/invertido.idx";
+const std::string INDICE_PREFIXO = DB_DIR + "/prefixo.idx";
+const std::string INDICE_AUTORES = DB_DIR + "/autores.idx";
+const std::string INDICE_ANO_CITACOES = DB_DIR + "/ano_citacoes.idx";
+const std::string INDICE_APRENDIDO_MODELO = DB_DIR + "/aprendido.mdl";
+const std::string INDICE_APRENDIDO_ARRANJO = DB_DIR + "/aprendido.arr";
+const std::string SHARDS_LST = DATA_DIR + "/shards.lst";
+
+// Arquivos de dados e índices de uma partição da base (particoes.h). Os caminhos
+// acima são os da base sem partições.
+struct Caminhos {
+    std::string dataDir;
+    std::string dbDir;
+    std::string dados;
+    std::string comprimidos;
+    std::string tabelaHash;
+    std::string primario;
+    std::string secundario;
+    std::string bloomId;
+    std::string bloomTitulo;
+    std::string invertido;
+    std::string prefixo;
+    std::string autores;
+    std::string anoCitacoes;
+    std::string aprendidoModelo;
+    std::string aprendidoArranjo;
+};
+
+inline Caminhos caminhosEm(const std::string& dataDir, const std::string& dbDir) {
+    return {dataDir,
+            dbDir,
+            dataDir + "/artigos.dat",
+            dataDir + "/artigos.lz",
+            dbDir + "/tabela_hash.idx",
+            dbDir + "/prim_index.idx",
+            dbDir + "/sec_index.idx",
+            dbDir + "/bloom_id.blm",
+            dbDir + "/bloom_titulo.blm",
+            dbDir + "/invertido.idx",
+            dbDir + "/prefixo.idx",
+            dbDir + "/autores.idx",
+            dbDir + "/ano_citacoes.idx",
+            dbDir + "/aprendido.mdl",
+            dbDir + "/aprendido.arr"};
+}
 
 #endif
\ No newline at end of file
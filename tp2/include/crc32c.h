@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// CRC32C (Castagnoli, o mesmo do iSCSI/ext4) dos checksums de página de
+// artigos.dat e das B+ trees. Em x86-64 com SSE4.2 usa a instrução crc32, com
+// três fluxos intercalados nos trechos longos; sem ela, tabelas slicing-by-8.
+// Encadeável: crc32c(b, nb, crc32c(a, na)) == CRC de a seguido de b.
+std::uint32_t crc32c(const void* dados, std::size_t n, std::uint32_t crc = 0);
+
+// true se crc32c usa a instrução do processador
+bool crc32cPorHardware();
@@ -1,7 +1,16 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <vector>
+#include "config.h"
+#include "crc32c.h"
+#include "metrics.h"
 
 // representa um registro
 struct Artigo {
@@ -22,24 +31,132 @@ const int REGISTROS_POR_BLOCO = 2;
 struct Bloco {
     Artigo artigos[REGISTROS_POR_BLOCO];
     int num_registros_usados;
+    // CRC32C do bloco com este campo zerado (ocupa o alinhamento antes do
+    // offset, o tamanho do bloco não muda); 0 = gravado antes dos checksums
+    std::uint32_t crc;
     long proximo_bloco_offset;
 };
 
+// CRC32C do bloco sem o campo crc; nunca 0, que marca blocos sem checksum
+inline std::uint32_t crcDoBloco(const Bloco& bloco) {
+    const char* p = reinterpret_cast<const char*>(&bloco);
+    const std::size_t campo = offsetof(Bloco, crc);
+    const std::size_t depois = campo + sizeof(bloco.crc);
+    std::uint32_t crc = crc32c(p + depois, sizeof(Bloco) - depois, crc32c(p, campo));
+    return crc ? crc : 1;
+}
+
+// grava o checksum no bloco; chamado logo antes de escrevê-lo em artigos.dat
+inline void selarBloco(Bloco& bloco) { bloco.crc = crcDoBloco(bloco); }
+
+// Confere o checksum de um bloco lido de 'arquivo'; se não bater, conta em
+// checksum_failures_total e avisa no stderr
+inline bool conferirBloco(const Bloco& bloco, const std::string& arquivo, std::size_t indice) {
+    if (bloco.crc == 0 || bloco.crc == crcDoBloco(bloco)) return true;
+    StorageMetrics::get().checksumFailures.inc();
+    std::cerr << "[ERRO] Checksum invalido no bloco " << indice << " de " << arquivo << std::endl;
+    return false;
+}
+
+// blocos do buffer de escrita do modo carga (~12 MB)
+const std::size_t BLOCOS_BUFFER_CARGA = 4096;
+
+// resultado de uma remocao: para manter a cadeia compacta, o ultimo registro
+// da cadeia ocupa a vaga aberta e o RID dele passa de ridOrigem para rid
+struct Remocao {
+    long rid;
+    Artigo removido;
+    bool houveMovimento;
+    long ridOrigem;
+    Artigo movido;
+};
 
 class HashingFile {
 public:
-    HashingFile(const std::string& filename, int table_size);
+    HashingFile(const std::string& filename, int table_size, const std::string& tabela = TABELA_HASH);
     ~HashingFile();
 
+    // retorna o RID do registro inserido, ou -1 em caso de erro
     long inserirArtigo(Artigo& novoArtigo);
-    Artigo buscarPorId(int id, int& blocosLidos);
+    // sobrescreve o registro de mesmo ID no lugar; retorna o RID ou -1 se o ID nao existe
+    long atualizarArtigo(const Artigo& artigo, Artigo* anterior = nullptr);
+    // remove o registro do ID; blocos que ficam vazios voltam para a lista livre
+    bool removerArtigo(int id, Remocao& resultado);
+    // tempos (opcional) separa a leitura da tabela hash (index) da cadeia de blocos (fetch)
+    Artigo buscarPorId(int id, int& blocosLidos, const QueryTimings* tempos = nullptr);
+    // le o registro apontado por um RID (um bloco); false se a posicao estiver vazia
+    bool lerPorRid(long rid, Artigo& artigo);
     long getTotalBlocos();
 
+    // Reescreve o arquivo com a cadeia de cada bucket contígua e com blocos cheios
+    // (em ordem de bucket) e regrava a tabela hash. novoRid[ridAntigo] recebe o
+    // RID novo de cada registro (-1 para posições vazias).
+    bool compactar(std::vector<long>& novoRid);
+
+    // Reescreve o arquivo com os registros em ordem crescente de chave(artigo)
+    // (empates pela posição atual) e regrava a tabela hash, deixando varreduras
+    // por essa chave sequenciais. Um bloco só reúne registros consecutivos do
+    // mesmo bucket; as cadeias seguem a ordem do arquivo. novoRid como em compactar.
+    bool clusterizar(const std::function<long long(const Artigo&)>& chave, std::vector<long>& novoRid);
+
+    // Modo carga (upload e --append): a tabela hash fica em memória e os blocos
+    // escritos ficam num buffer de até 'capacidadeBlocos' blocos, de onde as
+    // inserções seguintes leem a cadeia; blocos novos recebem offsets a partir
+    // do fim lógico do arquivo. O buffer vai para o disco quando enche, em ordem
+    // de offset e com cada sequência de blocos contíguos em uma escrita só; a
+    // tabela é regravada inteira em terminarCarga (chamado também pelo destrutor,
+    // por removerArtigo, compactar e clusterizar).
+    bool iniciarCarga(std::size_t capacidadeBlocos = BLOCOS_BUFFER_CARGA);
+    bool terminarCarga();
+    // índices (offset / sizeof(Bloco)) dos blocos gravados desde o último
+    // iniciarCarga, ordenados e sem repetição; servem a quem mantém cópias de
+    // artigos.dat bloco a bloco (artigos.lz)
+    std::vector<long> blocosGravadosNaCarga() const;
+
+    // RID = indice do bloco no arquivo * REGISTROS_POR_BLOCO + posicao no bloco
+    static long calcularRid(long offsetBloco, int posicao);
+
+    // estatisticas de I/O acumuladas desde a abertura (ou desde zerarEstatisticas)
+    void zerarEstatisticas() { blocosLidosTotal = 0; blocosEscritosTotal = 0; }
+    long getBlocosLidos() const { return blocosLidosTotal; }
+    long getBlocosEscritos() const { return blocosEscritosTotal; }
+
 private:
     void criarArquivos();
+    // abre artigos.dat, criando os arquivos na primeira inserção
+    bool abrirOuCriar();
+    bool emCarga() const { return !tabelaCarga.empty(); }
+
+    // cabeça da cadeia do bucket; no modo carga vem da tabela em memória
+    long lerCabeca(std::fstream& tabela, int endereco);
+    void gravarCabeca(std::fstream& tabela, int endereco, long offset);
+
+    // a cabeca da lista de blocos livres fica logo apos as entradas da tabela hash
+    long lerListaLivre(std::fstream& tabela);
+    void gravarListaLivre(std::fstream& tabela, long offset);
+    long alocarBloco(std::fstream& tabela);
+    // false se a leitura falhar ou o checksum não conferir
+    bool lerBloco(long offset, Bloco& bloco);
+    // sela o bloco (crc) e grava
+    void gravarBloco(long offset, Bloco& bloco);
+    // grava os blocos do buffer de carga em ordem de offset e o esvazia
+    bool descarregarBlocos();
+    // grava a tabela com as cabeças novas e troca dados e tabela pelos reescritos
+    bool substituirArquivos(const std::string& dadosNovos, const std::vector<long>& cabecas);
 
     std::string nomeArquivo;
+    std::string nomeTabela;
     int TAMANHO_TABELA;
     std::fstream arquivo; 
+    long blocosLidosTotal = 0;
+    long blocosEscritosTotal = 0;
+
+    // modo carga
+    std::vector<long> tabelaCarga; // entradas + cabeça da lista livre; vazia fora do modo carga
+    bool tabelaCargaAlterada = false;
+    std::map<long, Bloco> bufferCarga; // offset -> bloco ainda não gravado
+    std::size_t capacidadeCarga = 0;
+    long fimCarga = 0; // tamanho de artigos.dat contando os blocos novos do buffer
+    std::vector<long> gravadosCarga; // índices dos blocos já descarregados
 };
 
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Índice invertido termo -> RIDs. O mesmo formato serve ao índice de palavras
+// (titulo e snippet, DB_DIR/invertido.idx) e ao de autores (nome normalizado,
+// DB_DIR/autores.idx): cada chave tem uma única lista de postings.
+//
+// Arquivo, mapeado com mmap nas consultas:
+//   cabeçalho (64 bytes)
+//   dicionário: numTermos entradas de 32 bytes ordenadas pelo termo
+//   pool com os bytes dos termos
+//   listas de postings, cada uma alinhada em 8 bytes:
+//     uint32 numBlocos, uint32 df, numBlocos skips {int64 primeiroRid, uint32 offset, uint32 n}
+//     blocos de até POSTINGS_POR_BLOCO RIDs: o primeiro absoluto e o resto em
+//     delta, todos em varint (LEB128)
+// Os skips permitem pular blocos inteiros na interseção sem decodificá-los.
+
+constexpr std::size_t POSTINGS_POR_BLOCO = 128;
+constexpr std::size_t TAMANHO_MIN_TERMO = 2;
+constexpr std::size_t TAMANHO_MAX_TERMO = 32;
+
+// Quebra o texto em termos: sequências de [a-z0-9] (minúsculas) e bytes UTF-8
+// não ASCII; termos menores que TAMANHO_MIN_TERMO são descartados e os maiores
+// truncados em TAMANHO_MAX_TERMO. Os termos são anexados a 'termos'.
+void tokenizar(const char* texto, std::size_t maxLen, std::vector<std::string>& termos);
+
+// Separa a lista de autores (delimitada por '|') em nomes normalizados:
+// minúsculas (ASCII), espaços colapsados e sem espaços nas pontas
+void extrairAutores(const char* autores, std::size_t maxLen, std::vector<std::string>& nomes);
+
+struct Artigo;
+
+class InvertidoBuilder {
+public:
+    // Os RIDs devem chegar em ordem crescente (varredura de artigos.dat)
+    void adicionar(long rid, const Artigo& artigo);
+    // Chaves já extraídas; repetidas no mesmo registro contam uma vez
+    void adicionarTermos(long rid, std::vector<std::string>& termos);
+    bool gravar(const std::string& caminho) const;
+
+    // Atualização de um índice já gravado (--append): o builder guarda só o
+    // lote, com as postings novas (adicionar) e as que saem (retirar, com o
+    // conteúdo antigo dos registros alterados, em qualquer ordem de RID).
+    // mesclar regrava 'caminho' copiando sem decodificar as listas dos termos
+    // que o lote não toca; false se o índice atual não abre.
+    void retirar(long rid, const Artigo& anterior);
+    void retirarTermos(long rid, std::vector<std::string>& termos);
+    bool mesclar(const std::string& caminho) const;
+
+    std::size_t numTermos() const { return listas_.size(); }
+    std::size_t numPostings() const { return postings_; }
+    std::size_t numDocs() const { return docs_; }
+
+private:
+    struct Skip {
+        std::int64_t primeiroRid;
+        std::uint32_t offset;
+        std::uint32_t n;
+    };
+    struct Lista {
+        long ultimo = -1;
+        std::uint32_t df = 0;
+        std::string bytes;
+        std::vector<Skip> skips;
+    };
+
+    // lista de saída da gravação: montada agora ou copiada do índice anterior
+    struct ListaGravada {
+        std::string_view termo;
+        std::uint32_t df;
+        const Lista* lista;          // nula na cópia
+        const unsigned char* bytes;  // lista já codificada (numBlocos, df, skips, dados)
+        std::uint64_t tamanho;
+    };
+
+    static void acrescentar(Lista& lista, long rid);
+    static bool gravarListas(const std::string& caminho, std::uint64_t numDocs, const std::vector<ListaGravada>& listas);
+
+    std::unordered_map<std::string, Lista> listas_;
+    std::unordered_map<std::string, std::vector<long>> retiradas_;
+    std::vector<std::string> termosDoc_; // reaproveitado entre documentos
+    std::size_t postings_ = 0;
+    std::size_t docs_ = 0;
+    std::size_t docsRetirados_ = 0;
+};
+
+class PostingCursor;
+
+class IndiceInvertido {
+public:
+    IndiceInvertido() = default;
+    ~IndiceInvertido();
+    IndiceInvertido(const IndiceInvertido&) = delete;
+    IndiceInvertido& operator=(const IndiceInvertido&) = delete;
+
+    bool abrir(const std::string& caminho);
+
+    // Posiciona o cursor no início da lista do termo; false se o termo não existe
+    bool buscar(const std::string& termo, PostingCursor& cursor) const;
+
+    std::size_t numTermos() const;
+    std::size_t numDocs() const;
+
+private:
+    friend class InvertidoBuilder; // mesclar lê o dicionário e copia as listas
+
+    const unsigned char* base_ = nullptr;
+    std::size_t tamanho_ = 0;
+};
+
+class PostingCursor {
+public:
+    bool fim() const { return fim_; }
+    long atual() const { return buf_[pos_]; }
+    std::uint32_t df() const { return df_; }
+
+    void proximo();
+    // Avança até o primeiro RID >= alvo (galopando sobre os skips e depois dentro
+    // do bloco); false se a lista acabou
+    bool avancarPara(long alvo);
+
+    // Quantos blocos foram de fato decodificados (para medir o que os skips evitaram)
+    std::size_t blocosDecodificados() const { return decodificados_; }
+
+private:
+    friend class IndiceInvertido;
+    struct Skip {
+        std::int64_t primeiroRid;
+        std::uint32_t offset;
+        std::uint32_t n;
+    };
+
+    void carregarBloco(std::uint32_t b);
+
+    const Skip* skips_ = nullptr;
+    const unsigned char* dados_ = nullptr;
+    std::uint32_t numBlocos_ = 0;
+    std::uint32_t df_ = 0;
+    std::uint32_t bloco_ = 0;
+    std::vector<long> buf_;
+    std::size_t pos_ = 0;
+    bool fim_ = true;
+    std::size_t decodificados_ = 0;
+};
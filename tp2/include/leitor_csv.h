@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Leitura do CSV de entrada do upload sem alocação por linha. O arquivo é
+// mapeado com mmap e percorrido em blocos de 64 bytes: comparações SSE2 marcam
+// numa máscara de bits as posições de ';', '"' e '\n', e só essas posições
+// passam pela máquina de estados. Os campos são string_view dentro do mapa.
+//
+// Regras (as mesmas do parser anterior, baseado em getline): toda '\n' termina
+// a linha, mesmo entre aspas; '"' alterna o modo aspas e não entra no campo;
+// ';' fora de aspas separa campos. Um campo com aspas só nas pontas vira uma
+// view do miolo; aspas no meio obrigam a copiar o campo sem elas para um
+// buffer reaproveitado entre linhas.
+
+constexpr std::size_t MAX_CAMPOS_CSV = 16;
+
+struct LinhaCsv {
+    std::string_view texto;    // sem o '\n'
+    int numero = 0;            // a partir de 1, contando linhas vazias
+    std::size_t numCampos = 0; // pode passar de MAX_CAMPOS_CSV; só os primeiros ficam em 'campos'
+    std::string_view campos[MAX_CAMPOS_CSV];
+};
+
+class LeitorCsv {
+public:
+    LeitorCsv() = default;
+    ~LeitorCsv();
+    LeitorCsv(const LeitorCsv&) = delete;
+    LeitorCsv& operator=(const LeitorCsv&) = delete;
+
+    bool abrir(const std::string& caminho);
+    // false no fim do arquivo; as views valem até a próxima chamada
+    bool proximaLinha(LinhaCsv& linha);
+
+    std::size_t tamanho() const { return tamanho_; }
+
+private:
+    struct Trecho {
+        std::size_t ini, fim;
+        int aspas; // quantas '"' o campo tem
+    };
+
+    std::size_t proximoEvento();
+    void carregarBloco();
+
+    const char* base_ = nullptr;
+    std::size_t tamanho_ = 0;
+    std::size_t pos_ = 0;   // início da próxima linha
+    std::size_t bloco_ = 0; // offset do bloco de 64 bytes de 'mascara_'
+    std::uint64_t mascara_ = 0; // eventos ainda não consumidos do bloco
+    int numeroLinha_ = 0;
+    Trecho trechos_[MAX_CAMPOS_CSV];
+    std::vector<char> semAspas_;
+};
+
+// Converte como std::stoi (ignora espaços iniciais e o que vier depois dos
+// dígitos), mas sem exceções: false se não houver número ou se não couber em int
+bool lerInteiro(std::string_view texto, int& valor);
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "hashing_file.h"
+
+// Camada de leitura por RID para as ferramentas de consulta. Os arquivos ficam
+// abertos entre consultas (modo lote incluso) e cada consulta resolve todos os
+// seus resultados de uma vez: as páginas de RID do índice e os blocos de
+// artigos.dat são deduplicados, ordenados por offset e lidos com pread, uma
+// leitura por página/bloco distinto, devolvendo só os registros pedidos.
+
+class DadosComprimidos;
+
+enum EstadoRegistro {
+    REG_OK,
+    REG_VAZIO,           // posição livre ou registro não ocupado
+    REG_FORA_DO_ARQUIVO, // RID além do fim de artigos.dat
+    REG_ERRO_LEITURA,
+};
+
+struct RegistroLido {
+    long rid;
+    EstadoRegistro estado;
+    Artigo artigo;
+};
+
+class LeitorDeRegistros {
+public:
+    LeitorDeRegistros() = default;
+    ~LeitorDeRegistros();
+    LeitorDeRegistros(const LeitorDeRegistros&) = delete;
+    LeitorDeRegistros& operator=(const LeitorDeRegistros&) = delete;
+
+    // 'comprimidos', se aberto, substitui artigos.dat na leitura dos blocos
+    bool abrir(const std::string& caminhoIndice, const std::string& caminhoDados,
+               const DadosComprimidos* comprimidos = nullptr);
+
+    // Copia 'tamanho' bytes de uma página de dados do índice (offset de searchAll),
+    // conferindo o checksum da página quando o índice tem checksums
+    bool lerDoIndice(long offset, void* destino, std::size_t tamanho) const;
+    // RIDs gravados nas páginas 'offsets'; rids[i] = -1 se a página não pôde ser lida
+    void lerRids(const std::vector<long>& offsets, std::vector<long>& rids) const;
+    // Resolve os RIDs na ordem recebida; cada bloco distinto é lido uma vez
+    void buscar(const std::vector<long>& rids, std::vector<RegistroLido>& registros);
+
+    // blocos de dados lidos desde a abertura (ou desde zerarEstatisticas)
+    std::size_t blocosLidos() const { return blocosLidos_; }
+    void zerarEstatisticas() { blocosLidos_ = 0; }
+
+private:
+    bool lerBloco(std::size_t indice, Bloco& bloco) const;
+
+    int fdIndice_ = -1;
+    int fdDados_ = -1;
+    std::string caminhoIndice_;
+    std::string origem_;          // arquivo dos blocos, para as mensagens de checksum
+    std::size_t tamanhoValor_ = 0; // bytes cobertos pelo CRC das páginas do índice; 0 = sem checksum
+    const DadosComprimidos* comprimidos_ = nullptr;
+    std::size_t totalBlocos_ = 0;
+    std::size_t blocosLidos_ = 0;
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Codec LZ77 próprio (no estilo do formato de bloco do LZ4), sem dependências
+// externas. A saída é uma sequência de:
+//   token (4 bits de literais | 4 bits de match - LZ_MATCH_MIN)
+//   [extensão do número de literais: bytes 255 ... resto] literais
+//   offset (2 bytes, little endian) [extensão do tamanho do match]
+// A última sequência só tem literais. Sequências longas de bytes iguais (os
+// NULs de preenchimento dos campos de texto) viram matches com offset 1.
+
+constexpr std::size_t LZ_MATCH_MIN = 4;
+
+// Comprime 'n' bytes de 'src', anexando o resultado a 'saida'; devolve quantos
+// bytes foram anexados
+std::size_t lzComprimir(const char* src, std::size_t n, std::string& saida);
+
+// Descomprime em 'dst' (capacidade 'cap') até ter pelo menos 'necessario' bytes
+// ou consumir a entrada; devolve quantos bytes produziu, ou -1 se a entrada for
+// inválida. Parar cedo evita decodificar o grupo inteiro para ler um registro.
+long lzDescomprimir(const unsigned char* src, std::size_t n, char* dst, std::size_t cap, std::size_t necessario);
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "config.h"
+#include "hashing_file.h"
+
+// Operações de manutenção que reorganizam artigos.dat e precisam manter os
+// índices coerentes com os RIDs novos. Cada uma age sobre uma partição
+// (particoes.h), cujos caminhos recebe.
+
+// Aplica novoRid[ridAntigo] aos valores do índice primário e do secundário
+bool remapearRids(const std::vector<long>& novoRid, const Caminhos& c);
+
+// Reconstrói os Bloom filters de ID e de título a partir de artigos.dat,
+// dimensionados para os registros atuais e a taxa de BLOOM_FPR
+bool reconstruirBlooms(const Caminhos& c);
+
+// Reconstrói do zero, em uma varredura de artigos.dat, os índices derivados
+// que guardam RIDs ou são gravados de uma vez (índice invertido, de prefixos,
+// de autores, o composto ano/citações e o aprendido ID -> RID), além da cópia
+// comprimida de artigos.dat quando ativa. Deve ser
+// chamada depois de qualquer operação que remova ou mova registros (--delete,
+// compact, cluster); depois de um --append basta atualizarIndicesDerivados.
+bool reconstruirIndicesDerivados(const Caminhos& c);
+
+// O que um --append mudou em artigos.dat. Nenhum RID muda de lugar: os
+// registros novos ocupam RIDs novos e os atualizados ficam onde estavam.
+struct DeltaDeAppend {
+    std::vector<long> rids;                       // inseridos e atualizados
+    std::unordered_map<long, Artigo> anteriores;  // conteúdo de antes do delta dos atualizados
+    std::uint64_t tamanhoAnterior = 0;            // bytes de artigos.dat antes do delta
+    std::vector<long> blocosGravados;             // HashingFile::blocosGravadosNaCarga
+};
+
+// Aplica o delta aos índices derivados sem varrer artigos.dat: lê só os
+// registros do delta, intercala as postings e títulos deles nos índices
+// invertido, de autores e de prefixos, insere/remove as chaves do ano/citações
+// na B+ tree, intercala os IDs novos no aprendido e recomprime só os grupos de
+// artigos.lz com blocos gravados. Cai em reconstruirIndicesDerivados se o
+// delta tocou mais da metade dos registros ou se algum índice atual não abre
+// (base anterior a ele, arquivo corrompido).
+bool atualizarIndicesDerivados(const Caminhos& c, DeltaDeAppend& delta);
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+// Registro de métricas do processo. Contadores e gauges são atômicos
+// (memory_order_relaxed) e ficam em endereços estáveis, então os componentes
+// guardam a referência uma vez e incrementam sem trava. O registro pode ser
+// exportado como JSON (METRICS_JSON=<arquivo> ou "-" grava ao sair) ou como
+// texto do Prometheus (METRICS_PORT=<porta> em processos longos).
+
+class Counter {
+public:
+    void inc(std::uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+    std::uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> value_{0};
+};
+
+class Gauge {
+public:
+    void set(std::int64_t v) { value_.store(v, std::memory_order_relaxed); }
+    void add(std::int64_t n) { value_.fetch_add(n, std::memory_order_relaxed); }
+    std::int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::int64_t> value_{0};
+};
+
+// Histograma log-linear no estilo HDR: valores até 32 ficam em baldes exatos,
+// acima disso cada potência de 2 é dividida em 32 sub-baldes (erro relativo
+// <= ~3%). Gravar é lock-free; os percentis devolvem o maior valor do balde.
+class Histogram {
+public:
+    static constexpr int SUB_BITS = 5;
+    static constexpr int SUB_COUNT = 1 << SUB_BITS;
+    static constexpr int BUCKETS = (64 - SUB_BITS + 1) * SUB_COUNT;
+
+    void record(std::uint64_t v);
+    std::uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    std::uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+    std::uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+    double mean() const { return count() ? static_cast<double>(sum()) / count() : 0.0; }
+    std::uint64_t percentile(double p) const; // p em [0, 100]
+
+private:
+    static int bucketOf(std::uint64_t v);
+    static std::uint64_t highestIn(int bucket);
+
+    std::array<std::atomic<std::uint64_t>, BUCKETS> buckets_{};
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+// Cronômetro de escopo em nanossegundos: grava no histograma ao sair do
+// escopo, ou antes com stop() quando a fase termina no meio do bloco.
+// Com histograma nulo não mede nada.
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Histogram& h) : hist_(&h), start_(std::chrono::steady_clock::now()) {}
+    explicit ScopedTimer(Histogram* h) : hist_(h) {
+        if (hist_) start_ = std::chrono::steady_clock::now();
+    }
+    ~ScopedTimer() { stop(); }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    std::uint64_t stop() {
+        if (!hist_) return 0;
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+        hist_->record(static_cast<std::uint64_t>(ns));
+        hist_ = nullptr;
+        return static_cast<std::uint64_t>(ns);
+    }
+
+private:
+    Histogram* hist_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+class MetricsRegistry {
+public:
+    static MetricsRegistry& instance();
+
+    // Devolve a métrica com esse nome, criando-a na primeira chamada
+    Counter& counter(const std::string& name, const std::string& help);
+    Gauge& gauge(const std::string& name, const std::string& help);
+    Histogram& histogram(const std::string& name, const std::string& help);
+
+    void writeJson(std::ostream& out) const;
+    void writePrometheus(std::ostream& out) const;
+
+private:
+    MetricsRegistry() = default;
+
+    enum class Kind { Counter, Gauge, Histogram };
+
+    // Só o instrumento do tipo da entrada é alocado (um Histogram tem ~15 KB)
+    struct Entry {
+        std::string name;
+        std::string help;
+        Kind kind;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    Entry& find(const std::string& name, const std::string& help, Kind kind);
+
+    mutable std::mutex mutex_;
+    std::deque<Entry> entries_; // deque: inserir não move as entradas existentes
+};
+
+// Métricas dos componentes de armazenamento, registradas no primeiro uso
+struct StorageMetrics {
+    // B+ tree (FileManager)
+    Counter& bptreeNodeReads;
+    Counter& bptreeNodeWrites;
+    Counter& bptreeDataReads;
+    Counter& bptreeDataWrites;
+    Counter& bptreeBytesRead;
+    Counter& bptreeBytesWritten;
+    Counter& bptreeSeeks;
+    Counter& bptreeFlushes;
+    Counter& bptreeLeafSplits;
+    Counter& bptreeInternalSplits;
+    Counter& bptreeBorrows;
+    Counter& bptreeMerges;
+    Counter& bptreePagesAllocated;
+    Counter& bptreePagesReused;
+    Counter& bptreePagesFreed;
+    Counter& bptreePrefetches;
+
+    // HashingFile (artigos.dat + tabela_hash.idx)
+    Counter& hashBlocksRead;
+    Counter& hashBlocksWritten;
+    Counter& hashBytesRead;
+    Counter& hashBytesWritten;
+    Counter& hashSeeks;
+    Counter& hashFlushes;
+    Counter& hashWrites;
+    Counter& hashBufferHits;
+    Counter& hashTableReads;
+    Counter& hashTableWrites;
+    Counter& hashChainHops;
+    Counter& hashOverflowBlocks;
+    Counter& hashInserts;
+    Counter& hashUpdates;
+    Counter& hashRemovals;
+    Counter& hashLookups;
+    Counter& hashLookupMisses;
+
+    // leituras diretas de artigos.dat por RID (seek1/seek2)
+    Counter& dataFileBlocksRead;
+    Counter& dataFileBytesRead;
+    // cópia comprimida (artigos.lz): grupos descomprimidos e bytes comprimidos lidos
+    Counter& dataFileLzGroupsDecoded;
+    Counter& dataFileLzBytesRead;
+
+    // Bloom filters de ID/título
+    Counter& bloomChecks;
+    Counter& bloomNegatives;
+
+    // varredura paralela de artigos.dat (scan)
+    Counter& scanBlocksRead;
+    Counter& scanBytesRead;
+    Counter& scanRecordsMatched;
+
+    // páginas de artigos.dat ou das B+ trees com CRC32C que não confere
+    Counter& checksumFailures;
+
+    static StorageMetrics& get();
+};
+
+// Latência por fase das ferramentas de consulta (seek1, seek2, findrec), em ns.
+// Os histogramas se chamam <ferramenta>_<fase>_ns; fases que a ferramenta não
+// tem simplesmente ficam com contagem zero.
+struct QueryTimings {
+    Histogram& index;  // descida na árvore / leitura da tabela hash
+    Histogram& rid;    // leitura do RID na página de dados do índice
+    Histogram& fetch;  // leitura do bloco em artigos.dat
+    Histogram& output; // formatação e escrita em stdout
+    Histogram& total;
+
+    static QueryTimings forTool(const std::string& tool);
+
+    // Tabela com contagem, média e p50/p90/p99/p99.9/máx de cada fase
+    void printSummary(std::ostream& out) const;
+};
+
+// Sobe (uma vez) uma thread que serve GET /metrics no formato do Prometheus
+// se METRICS_PORT estiver definida; indicado para upload, bench e compact.
+// Escuta em 127.0.0.1, ou no endereço IPv4 de METRICS_ADDR.
+void startMetricsServerFromEnv();
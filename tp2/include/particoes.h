@@ -0,0 +1,46 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "config.h"
+
+// Particionamento (sharding) da base por hash do ID. Cada partição tem seu
+// próprio artigos.dat, tabela hash e índices, em um diretório que pode estar em
+// outro disco; os RIDs são locais à partição.
+//
+// O upload completo fixa as partições a partir de SHARDS (quantidade, padrão 1)
+// e SHARD_DIRS (pontos de montagem separados por ':'; a partição k fica em
+// <SHARD_DIRS[k % M]>/shard<k>, índices em .../db). Com mais de uma, grava a
+// lista de diretórios em DATA_DIR/shards.lst, que as demais ferramentas leem;
+// sem a lista, a base tem uma partição nos caminhos de config.h.
+//
+// Buscas por ID vão a uma só partição (particaoDoId); consultas por título,
+// termo, autor, ano e varreduras rodam em todas em paralelo e combinam os
+// resultados.
+
+// Número de partições da base (lido de shards.lst uma vez)
+int numParticoes();
+
+// Caminhos da partição k, 0 <= k < numParticoes()
+Caminhos caminhosDaParticao(int k);
+
+// Partição que guarda o ID
+int particaoDoId(int id, int total = numParticoes());
+
+// Fixa as partições de um upload completo (SHARDS/SHARD_DIRS): cria os
+// diretórios e grava ou remove shards.lst
+bool configurarParticoes();
+
+// Executa fn(k, caminhos) para cada partição, uma thread por partição;
+// true se todas as chamadas retornaram true
+bool paraCadaParticao(const std::function<bool(int, const Caminhos&)>& fn);
+
+// Divide um arquivo de linhas cujo primeiro campo (até o ';') é o ID em um
+// arquivo por partição, <dataDir da partição>/<nome>.parte. Linhas sem ID
+// válido (cabeçalho, linhas inválidas) vão para a partição 0, que as relata.
+// Com uma partição só, partes = {caminho} e nada é copiado.
+bool particionarPorId(const std::string& caminho, std::vector<std::string>& partes);
+
+// Remove os arquivos criados por particionarPorId
+void removerPartes(const std::string& caminho, const std::vector<std::string>& partes);
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Dicionário de títulos para busca por prefixo (autocomplete).
+//
+// Cada título normalizado vira uma sequência de IDs de palavra. Os IDs seguem
+// a ordem lexicográfica das palavras e o espaço é menor que qualquer caractere
+// de palavra, então ordenar as sequências equivale a ordenar os títulos.
+// Dois dicionários com front coding em baldes:
+//   - vocabulário: palavras ordenadas, em baldes de PALAVRAS_POR_BALDE; no balde,
+//     a primeira vem completa e as demais como (prefixo comum, sufixo)
+//   - títulos: sequências ordenadas, em baldes de TITULOS_POR_BALDE; cada uma
+//     grava quantas palavras iniciais repete da anterior e os IDs restantes
+//     (varint). Depois de cada título vêm os RIDs dele, como varint em delta.
+// Os vetores de offsets dos baldes permitem buscas binárias pelas cabeças.
+//
+// Arquivo (DB_DIR/prefixo.idx), mapeado com mmap nas consultas:
+//   cabeçalho (96 bytes) | offsets dos baldes de palavras | palavras
+//   | offsets dos baldes de títulos | títulos
+
+constexpr std::size_t TITULOS_POR_BALDE = 16;
+constexpr std::size_t PALAVRAS_POR_BALDE = 16;
+
+// Normalização usada na construção e nas consultas: minúsculas (ASCII), bytes
+// de controle e sequências de espaços viram um único espaço, sem espaços nas pontas
+std::string normalizarTitulo(const char* titulo, std::size_t maxLen);
+
+struct Artigo;
+
+class PrefixoBuilder {
+public:
+    void adicionar(long rid, const Artigo& artigo);
+    bool gravar(const std::string& caminho);
+
+    // Atualização de um índice já gravado (--append): o builder guarda só o
+    // lote, com os títulos novos (adicionar) e os RIDs cujo título antigo sai
+    // (retirar). mesclar intercala vocabulário e títulos do índice atual com
+    // os do lote e regrava 'caminho'; false se o índice atual não abre.
+    void retirar(long rid) { retirados_.push_back(rid); }
+    bool mesclar(const std::string& caminho);
+
+    std::size_t numTitulos() const { return distintos_; }
+    std::size_t numPalavras() const { return palavras_.size(); }
+    std::size_t bytesBrutos() const { return bytesBrutos_; }
+    std::size_t bytesGravados() const { return bytesGravados_; }
+
+private:
+    struct Entrada {
+        std::vector<std::uint32_t> ids; // IDs provisórios até gravar()
+        long rid;
+    };
+
+    // grava entradas_ já ordenadas, com os IDs das posições de 'vocab' (ordenado)
+    bool gravarOrdenado(const std::string& caminho, const std::vector<const std::string*>& vocab);
+
+    std::unordered_map<std::string, std::uint32_t> palavras_;
+    std::vector<Entrada> entradas_;
+    std::vector<long> retirados_;
+    std::size_t distintos_ = 0;
+    std::size_t bytesBrutos_ = 0;
+    std::size_t bytesGravados_ = 0;
+};
+
+struct Sugestao {
+    std::string titulo; // normalizado
+    std::vector<long> rids;
+};
+
+class IndicePrefixo {
+public:
+    IndicePrefixo() = default;
+    ~IndicePrefixo();
+    IndicePrefixo(const IndicePrefixo&) = delete;
+    IndicePrefixo& operator=(const IndicePrefixo&) = delete;
+
+    bool abrir(const std::string& caminho);
+
+    // Até 'limite' títulos distintos que começam com o prefixo (já normalizado),
+    // em ordem lexicográfica. Um espaço no fim do prefixo exige a palavra completa.
+    std::size_t buscar(const std::string& prefixo, std::size_t limite, std::vector<Sugestao>& saida) const;
+
+    std::size_t numTitulos() const;
+    std::size_t numPalavras() const;
+
+private:
+    friend class PrefixoBuilder; // mesclar decodifica o índice inteiro
+
+    std::string palavra(std::uint32_t id) const;
+    // primeiro ID cuja palavra é >= p
+    std::uint32_t lowerBoundPalavra(const std::string& p) const;
+    std::vector<std::uint32_t> cabecaDoBalde(std::size_t balde) const;
+
+    const unsigned char* base_ = nullptr;
+    std::size_t tamanho_ = 0;
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// Índice de cobertura: além do RID, a página de dados de cada entrada do índice
+// primário pode guardar algumas colunas do artigo, declaradas na criação do
+// índice (PROJECAO_PRIM no upload). Consultas que só precisam dessas colunas
+// são respondidas sem ler artigos.dat.
+//
+// O RID continua no início do valor, então BPlusTree<long> sobre o mesmo
+// arquivo (remoção, remapeamento de RIDs, exportação) segue funcionando: o
+// cabeçalho guarda o tamanho do valor gravado, o CRC32C da página cobre o valor
+// inteiro e as escritas de um long regravam a página sem mexer nas colunas
+// projetadas (FileManager::valueBytes).
+
+enum ColunaProjetada : std::uint32_t {
+    PROJ_TITULO = 1u << 0,
+    PROJ_ANO = 1u << 1,
+    PROJ_AUTORES = 1u << 2,
+    PROJ_CITACOES = 1u << 3,
+    PROJ_ATUALIZACAO = 1u << 4,
+};
+
+// os tamanhos dos textos são os mesmos de Artigo (hashing_file.h)
+struct ValorProjetado {
+    long rid;
+    int ano;
+    int citacoes;
+    char titulo[301];
+    char autores[151];
+    char atualizacao[20];
+};
+
+// Valor do índice para o artigo: colunas fora de 'colunas' ficam zeradas, de
+// modo que o mesmo artigo sempre gera os mesmos bytes (remove/update comparam
+// o valor inteiro)
+// (modelo sobre o tipo do registro porque algumas ferramentas têm a própria
+// declaração do layout de disco)
+template <typename A>
+ValorProjetado projetar(const A& art, long rid, std::uint32_t colunas) {
+    static_assert(sizeof(art.titulo) == sizeof(ValorProjetado::titulo) &&
+                  sizeof(art.autores) == sizeof(ValorProjetado::autores) &&
+                  sizeof(art.atualizacao) == sizeof(ValorProjetado::atualizacao),
+                  "ValorProjetado deve acompanhar os campos de Artigo");
+    ValorProjetado v;
+    std::memset(&v, 0, sizeof(v));
+    v.rid = rid;
+    if (colunas & PROJ_ANO) v.ano = art.ano;
+    if (colunas & PROJ_CITACOES) v.citacoes = art.citacoes;
+    if (colunas & PROJ_TITULO) std::memcpy(v.titulo, art.titulo, strnlen(art.titulo, sizeof(art.titulo)));
+    if (colunas & PROJ_AUTORES) std::memcpy(v.autores, art.autores, strnlen(art.autores, sizeof(art.autores)));
+    if (colunas & PROJ_ATUALIZACAO) std::memcpy(v.atualizacao, art.atualizacao, strnlen(art.atualizacao, sizeof(art.atualizacao)));
+    return v;
+}
+
+// "titulo,ano,..." -> máscara; false se algum nome não for uma coluna projetável
+inline bool lerColunas(const std::string& lista, std::uint32_t& colunas) {
+    colunas = 0;
+    std::size_t inicio = 0;
+    while (inicio <= lista.size()) {
+        std::size_t fim = lista.find(',', inicio);
+        if (fim == std::string::npos) fim = lista.size();
+        std::string nome = lista.substr(inicio, fim - inicio);
+        if (nome == "titulo") colunas |= PROJ_TITULO;
+        else if (nome == "ano") colunas |= PROJ_ANO;
+        else if (nome == "autores") colunas |= PROJ_AUTORES;
+        else if (nome == "citacoes") colunas |= PROJ_CITACOES;
+        else if (nome == "atualizacao") colunas |= PROJ_ATUALIZACAO;
+        else if (!nome.empty()) return false;
+        inicio = fim + 1;
+    }
+    return true;
+}
+
+inline std::string nomesDasColunas(std::uint32_t colunas) {
+    static const char* const NOMES[] = {"titulo", "ano", "autores", "citacoes", "atualizacao"};
+    std::string s;
+    for (int i = 0; i < 5; ++i) {
+        if (!(colunas & (1u << i))) continue;
+        if (!s.empty()) s += ',';
+        s += NOMES[i];
+    }
+    return s;
+}
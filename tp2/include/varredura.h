@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <climits>
+#include <map>
+#include <string>
+
+// Varredura completa de artigos.dat em paralelo, para consultas que não são
+// busca pontual. O arquivo é dividido em lotes de blocos consecutivos que as
+// threads pegam de um contador atômico; cada thread lê o lote com pread no seu
+// próprio descritor, aplica os predicados e agrega localmente. Os parciais só
+// são combinados no fim, então não há disputa entre threads durante a leitura.
+
+struct Artigo;
+
+// Predicados da varredura; os limites são inclusivos. atualizacao é comparada
+// como texto ("AAAA-MM-DD hh:mm:ss" ordena como data); limites vazios não filtram.
+struct FiltroScan {
+    int anoMin = INT_MIN;
+    int anoMax = INT_MAX;
+    int citacoesMin = INT_MIN;
+    int citacoesMax = INT_MAX;
+    std::string atualizacaoMin;
+    std::string atualizacaoMax;
+
+    bool aceita(const Artigo& art) const;
+};
+
+// count, soma, mínimo e máximo das citações de um grupo
+struct ResumoCitacoes {
+    std::uint64_t quantidade = 0;
+    std::int64_t soma = 0;
+    int minimo = INT_MAX;
+    int maximo = INT_MIN;
+
+    void adicionar(int citacoes);
+    void combinar(const ResumoCitacoes& outro);
+    double media() const { return quantidade ? static_cast<double>(soma) / quantidade : 0.0; }
+};
+
+struct AgregadoScan {
+    ResumoCitacoes total;
+    int anoMin = INT_MAX;
+    int anoMax = INT_MIN;
+    std::map<int, ResumoCitacoes> porAno; // só preenchido com agruparPorAno
+
+    std::uint64_t registrosLidos = 0;
+    std::uint64_t blocosLidos = 0;
+    std::uint64_t bytesLidos = 0;
+
+    void combinar(const AgregadoScan& outro);
+};
+
+struct OpcoesScan {
+    unsigned threads = 0;             // 0 = hardware_concurrency
+    std::size_t blocosPorLote = 256;  // unidade de trabalho (e tamanho do pread)
+    bool agruparPorAno = false;
+};
+
+// Varre 'caminho' (formato de artigos.dat) e agrega os registros ocupados que
+// passam no filtro; false se o arquivo não puder ser aberto ou lido.
+bool varrerParalelo(const std::string& caminho, const FiltroScan& filtro,
+                    const OpcoesScan& opcoes, AgregadoScan& resultado);
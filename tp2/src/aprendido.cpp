@@ -0,0 +1,178 @@
+#include "../include/aprendido.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <limits>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char APRENDIDO_MAGIC[4] = {'P', 'G', 'M', '1'};
+constexpr long PAGINA = 4096;
+
+struct Cabecalho {
+    char magic[4];
+    std::uint32_t erro;
+    std::uint64_t numEntradas;
+    std::uint64_t numSegmentos;
+    char reservado[40];
+};
+static_assert(sizeof(Cabecalho) == 64, "cabecalho do modelo aprendido deve ter 64 bytes");
+static_assert(sizeof(EntradaAprendida) == 16, "entrada do arranjo aprendido deve ter 16 bytes");
+
+bool lerTudo(int fd, char* destino, std::size_t n, off_t offset) {
+    while (n > 0) {
+        ssize_t r = pread(fd, destino, n, offset);
+        if (r <= 0) return false;
+        destino += r;
+        n -= static_cast<std::size_t>(r);
+        offset += r;
+    }
+    return true;
+}
+
+bool gravarArquivo(const std::string& caminho, const char* dados, std::size_t tamanho,
+                   const char* cabecalho = nullptr, std::size_t tamCabecalho = 0) {
+    std::string tmp = caminho + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        if (cabecalho) out.write(cabecalho, static_cast<std::streamsize>(tamCabecalho));
+        out.write(dados, static_cast<std::streamsize>(tamanho));
+        if (!out) return false;
+    }
+    return std::rename(tmp.c_str(), caminho.c_str()) == 0;
+}
+
+} // namespace
+
+bool gravarIndiceAprendido(const std::vector<std::pair<int, long>>& pares,
+                           const std::string& caminhoModelo, const std::string& caminhoArranjo,
+                           std::size_t* numSegmentos) {
+    using Segmento = IndiceAprendido::Segmento;
+    std::vector<EntradaAprendida> arranjo(pares.size());
+    for (std::size_t i = 0; i < pares.size(); ++i) arranjo[i] = {pares[i].first, 0, pares[i].second};
+
+    // Cone de inclinações que mantém todos os pontos do segmento a no máximo
+    // ERRO_APRENDIDO posições da reta; quando o ponto novo esvazia o cone, o
+    // segmento fecha com a inclinação do meio e o ponto abre o próximo.
+    std::vector<Segmento> segmentos;
+    std::size_t inicio = 0;
+    double minima = 0, maxima = std::numeric_limits<double>::infinity();
+    auto fechar = [&]() {
+        double inclinacao = std::isinf(maxima) ? minima : (minima + maxima) / 2;
+        segmentos.push_back({pares[inicio].first, 0, inclinacao, static_cast<std::int64_t>(inicio)});
+    };
+    for (std::size_t i = 1; i < pares.size(); ++i) {
+        double dx = static_cast<double>(static_cast<long long>(pares[i].first) - pares[inicio].first);
+        double dy = static_cast<double>(i - inicio);
+        double lo = (dy - ERRO_APRENDIDO) / dx;
+        double hi = (dy + ERRO_APRENDIDO) / dx;
+        if (std::max(minima, lo) > std::min(maxima, hi)) {
+            fechar();
+            inicio = i;
+            minima = 0;
+            maxima = std::numeric_limits<double>::infinity();
+            continue;
+        }
+        minima = std::max(minima, lo);
+        maxima = std::min(maxima, hi);
+    }
+    if (!pares.empty()) fechar();
+
+    Cabecalho cab{};
+    std::memcpy(cab.magic, APRENDIDO_MAGIC, sizeof(APRENDIDO_MAGIC));
+    cab.erro = ERRO_APRENDIDO;
+    cab.numEntradas = arranjo.size();
+    cab.numSegmentos = segmentos.size();
+    if (numSegmentos) *numSegmentos = segmentos.size();
+    return gravarArquivo(caminhoArranjo, reinterpret_cast<const char*>(arranjo.data()), arranjo.size() * sizeof(EntradaAprendida)) &&
+           gravarArquivo(caminhoModelo, reinterpret_cast<const char*>(segmentos.data()), segmentos.size() * sizeof(Segmento),
+                         reinterpret_cast<const char*>(&cab), sizeof(cab));
+}
+
+bool mesclarIndiceAprendido(const std::vector<std::pair<int, long>>& novos,
+                            const std::string& caminhoModelo, const std::string& caminhoArranjo,
+                            std::size_t* numSegmentos, std::size_t* numEntradas) {
+    std::vector<EntradaAprendida> arranjo;
+    {
+        IndiceAprendido atual;
+        if (!atual.abrir(caminhoModelo, caminhoArranjo)) return false;
+        arranjo.resize(atual.numEntradas());
+        if (!lerTudo(atual.fd_, reinterpret_cast<char*>(arranjo.data()), arranjo.size() * sizeof(EntradaAprendida), 0)) {
+            return false;
+        }
+    }
+
+    std::vector<std::pair<int, long>> pares;
+    pares.reserve(arranjo.size() + novos.size());
+    std::size_t j = 0;
+    for (const EntradaAprendida& e : arranjo) {
+        for (; j < novos.size() && novos[j].first < e.id; ++j) pares.push_back(novos[j]);
+        if (j < novos.size() && novos[j].first == e.id) continue; // substituída pela nova
+        pares.push_back({e.id, static_cast<long>(e.rid)});
+    }
+    pares.insert(pares.end(), novos.begin() + static_cast<long>(j), novos.end());
+    if (numEntradas) *numEntradas = pares.size();
+    return gravarIndiceAprendido(pares, caminhoModelo, caminhoArranjo, numSegmentos);
+}
+
+IndiceAprendido::~IndiceAprendido() {
+    if (fd_ >= 0) ::close(fd_);
+}
+
+bool IndiceAprendido::abrir(const std::string& caminhoModelo, const std::string& caminhoArranjo) {
+    std::ifstream modelo(caminhoModelo, std::ios::binary);
+    Cabecalho cab{};
+    if (!modelo.read(reinterpret_cast<char*>(&cab), sizeof(cab)) ||
+        std::memcmp(cab.magic, APRENDIDO_MAGIC, sizeof(APRENDIDO_MAGIC)) != 0 || cab.erro != ERRO_APRENDIDO) {
+        return false;
+    }
+    segmentos_.resize(cab.numSegmentos);
+    if (!modelo.read(reinterpret_cast<char*>(segmentos_.data()),
+                     static_cast<std::streamsize>(segmentos_.size() * sizeof(Segmento)))) {
+        return false;
+    }
+
+    fd_ = ::open(caminhoArranjo.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd_ < 0 || fstat(fd_, &st) != 0 ||
+        static_cast<std::uint64_t>(st.st_size) != cab.numEntradas * sizeof(EntradaAprendida)) {
+        return false;
+    }
+    numEntradas_ = cab.numEntradas;
+    // cada busca lê uma janela pequena em um ponto qualquer do arranjo
+    posix_fadvise(fd_, 0, 0, POSIX_FADV_RANDOM);
+    janela_.resize(2 * ERRO_APRENDIDO + 3);
+    return true;
+}
+
+long IndiceAprendido::buscar(int id, int& paginas) const {
+    paginas = 0;
+    if (fd_ < 0 || segmentos_.empty() || id < segmentos_.front().chave) return -1;
+
+    auto seg = std::upper_bound(segmentos_.begin(), segmentos_.end(), id,
+                                [](int chave, const Segmento& s) { return chave < s.chave; }) - 1;
+    double previsto = static_cast<double>(seg->inicio) +
+                      seg->inclinacao * static_cast<double>(static_cast<long long>(id) - seg->chave);
+    // +1 de folga para o arredondamento da previsão
+    long long centro = std::llround(previsto);
+    long long primeira = std::max<long long>(0, centro - ERRO_APRENDIDO - 1);
+    long long ultima = std::min<long long>(static_cast<long long>(numEntradas_) - 1, centro + ERRO_APRENDIDO + 1);
+    if (primeira > ultima) return -1;
+
+    std::size_t n = static_cast<std::size_t>(ultima - primeira + 1);
+    off_t offset = static_cast<off_t>(primeira) * static_cast<off_t>(sizeof(EntradaAprendida));
+    std::size_t bytes = n * sizeof(EntradaAprendida);
+    if (!lerTudo(fd_, reinterpret_cast<char*>(janela_.data()), bytes, offset)) return -1;
+    paginas = static_cast<int>((offset + static_cast<off_t>(bytes) - 1) / PAGINA - offset / PAGINA + 1);
+
+    auto it = std::lower_bound(janela_.begin(), janela_.begin() + static_cast<long>(n), id,
+                               [](const EntradaAprendida& e, int chave) { return e.id < chave; });
+    if (it == janela_.begin() + static_cast<long>(n) || it->id != id) return -1;
+    return static_cast<long>(it->rid);
+}
@@ -0,0 +1,462 @@
+#include "../include/hashing_file.h"
+#include "../include/BPlusTree.hpp"
+#include "../include/config.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Benchmark do motor de armazenamento: carga, buscas pontuais por ID e por
+// título, varreduras por faixa e carga mista, cada uma com chaves uniformes e
+// Zipfian. Gera JSON com vazão, latências p50/p99/p999 e blocos lidos/escritos
+// por operação. Os arquivos são criados em um diretório próprio (BENCH_DIR) e
+// apagados ao fim de cada distribuição, salvo com --manter.
+
+const int TAMANHO_TABELA_HASH = 100000;
+
+struct BenchConfig {
+    std::size_t registros = 20000;
+    std::size_t operacoes = 20000;
+    std::size_t larguraScan = 100;
+    std::uint64_t semente = 42;
+    std::string dir = getEnv("BENCH_DIR", DB_DIR + "/bench");
+    std::string saida; // vazio = stdout
+    bool manter = false; // deixa os arquivos de cada distribuição em dir
+};
+
+// Gerador Zipfian (Gray et al., o mesmo do YCSB): devolve posições em [0, n)
+// com a posição 0 sendo a mais popular
+class Zipf {
+public:
+    Zipf(std::size_t n, double theta = 0.99) : n(n), theta(theta) {
+        zetan = zeta(n);
+        double zeta2 = zeta(2);
+        alpha = 1.0 / (1.0 - theta);
+        eta = (1.0 - std::pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+    }
+
+    std::size_t next(std::mt19937_64& rng) {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        double uz = u * zetan;
+        if (uz < 1.0) return 0;
+        if (uz < 1.0 + std::pow(0.5, theta)) return 1;
+        std::size_t r = static_cast<std::size_t>(n * std::pow(eta * u - eta + 1.0, alpha));
+        return std::min(r, n - 1);
+    }
+
+private:
+    double zeta(std::size_t count) const {
+        double sum = 0;
+        for (std::size_t i = 1; i <= count; ++i) sum += 1.0 / std::pow(static_cast<double>(i), theta);
+        return sum;
+    }
+
+    std::size_t n;
+    double theta, zetan, alpha, eta;
+};
+
+// Escolhe posições em [0, n): uniforme ou Zipfian com a popularidade
+// espalhada por uma permutação (as chaves quentes não ficam vizinhas)
+class Distribuicao {
+public:
+    Distribuicao(bool zipfian, std::size_t n, std::mt19937_64& rng)
+        : zipfian(zipfian), n(n), rng(rng), zipf(n) {
+        perm.resize(n);
+        for (std::size_t i = 0; i < n; ++i) perm[i] = i;
+        std::shuffle(perm.begin(), perm.end(), rng);
+    }
+
+    std::size_t proximo() {
+        if (!zipfian) return std::uniform_int_distribution<std::size_t>(0, n - 1)(rng);
+        return perm[zipf.next(rng)];
+    }
+
+private:
+    bool zipfian;
+    std::size_t n;
+    std::mt19937_64& rng;
+    Zipf zipf;
+    std::vector<std::size_t> perm;
+};
+
+struct Resultado {
+    Resultado(std::string w, std::string d) : workload(std::move(w)), distribuicao(std::move(d)) {}
+
+    std::string workload;
+    std::string distribuicao;
+    std::vector<std::uint64_t> latenciasNs;
+    double segundos = 0;
+    std::size_t dadosLidos = 0, dadosEscritos = 0;
+    std::size_t indiceLidos = 0, indiceEscritos = 0;
+};
+
+// Cronometra cada operação e acumula a latência em ns
+class Cronometro {
+public:
+    explicit Cronometro(Resultado& r) : r(r), inicio(std::chrono::steady_clock::now()) {}
+
+    template <typename F>
+    void medir(F op) {
+        auto t0 = std::chrono::steady_clock::now();
+        op();
+        auto t1 = std::chrono::steady_clock::now();
+        r.latenciasNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+    }
+
+    ~Cronometro() {
+        r.segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    }
+
+private:
+    Resultado& r;
+    std::chrono::steady_clock::time_point inicio;
+};
+
+static std::string tituloSintetico(int id) {
+    return "Artigo sintetico numero " + std::to_string(id);
+}
+
+static Artigo artigoSintetico(int id, std::mt19937_64& rng) {
+    Artigo art = {};
+    art.ocupado = true;
+    art.id = id;
+    std::strncpy(art.titulo, tituloSintetico(id).c_str(), 300);
+    art.ano = 1990 + static_cast<int>(rng() % 35);
+    std::strncpy(art.autores, "Autor A|Autor B", 150);
+    art.citacoes = static_cast<int>(rng() % 1000);
+    std::memcpy(art.atualizacao, "2016-07-13 12:00:00", 19);
+    std::memset(art.snippet, 'x', 512);
+    return art;
+}
+
+static int chaveTitulo(const std::string& titulo) {
+    // mesmo FNV-1a 32 do upload/seek2
+    std::uint32_t hash = 2166136261u;
+    for (unsigned char c : titulo) {
+        hash ^= c;
+        hash *= 16777619u;
+    }
+    return static_cast<int>(hash);
+}
+
+// IDs do conjunto de dados: uniformes e esparsos em [1, 10n], ou com saltos
+// Zipfian (trechos densos separados por buracos ocasionais grandes)
+static std::vector<int> gerarIds(bool zipfian, std::size_t n, std::mt19937_64& rng) {
+    std::vector<int> ids;
+    ids.reserve(n);
+    if (!zipfian) {
+        std::vector<int> universo(n * 10);
+        for (std::size_t i = 0; i < universo.size(); ++i) universo[i] = static_cast<int>(i + 1);
+        std::shuffle(universo.begin(), universo.end(), rng);
+        ids.assign(universo.begin(), universo.begin() + n);
+    } else {
+        Zipf saltos(1000);
+        int atual = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            atual += 1 + static_cast<int>(saltos.next(rng));
+            ids.push_back(atual);
+        }
+        std::shuffle(ids.begin(), ids.end(), rng);
+    }
+    return ids;
+}
+
+static void registrarIO(Resultado& r, HashingFile& hash, std::size_t idxLidos, std::size_t idxEscritos) {
+    r.dadosLidos = hash.getBlocosLidos();
+    r.dadosEscritos = hash.getBlocosEscritos();
+    r.indiceLidos = idxLidos;
+    r.indiceEscritos = idxEscritos;
+}
+
+static std::uint64_t percentil(std::vector<std::uint64_t>& ordenadas, double p) {
+    if (ordenadas.empty()) return 0;
+    std::size_t idx = static_cast<std::size_t>(std::ceil(p * ordenadas.size())) ;
+    if (idx > 0) idx--;
+    return ordenadas[std::min(idx, ordenadas.size() - 1)];
+}
+
+static void escreverJson(std::ostream& out, const BenchConfig& cfg, std::vector<Resultado>& resultados) {
+    out << std::fixed << std::setprecision(3);
+    out << "{\n  \"benchmark\": \"tp2-storage\",\n";
+    out << "  \"config\": {\"registros\": " << cfg.registros
+        << ", \"operacoes\": " << cfg.operacoes
+        << ", \"largura_scan\": " << cfg.larguraScan
+        << ", \"semente\": " << cfg.semente
+        << ", \"tamanho_tabela_hash\": " << TAMANHO_TABELA_HASH
+        << ", \"ordem_bptree\": " << M << "},\n";
+    out << "  \"results\": [\n";
+    for (std::size_t i = 0; i < resultados.size(); ++i) {
+        Resultado& r = resultados[i];
+        std::vector<std::uint64_t> ord = r.latenciasNs;
+        std::sort(ord.begin(), ord.end());
+        double ops = static_cast<double>(ord.size());
+        double porOp = ops > 0 ? 1.0 / ops : 0;
+        out << "    {\"workload\": \"" << r.workload << "\", \"distribution\": \"" << r.distribuicao << "\""
+            << ", \"ops\": " << ord.size()
+            << ", \"seconds\": " << r.segundos
+            << ", \"throughput_ops_per_sec\": " << (r.segundos > 0 ? ops / r.segundos : 0)
+            << ", \"latency_ns\": {\"p50\": " << percentil(ord, 0.50)
+            << ", \"p99\": " << percentil(ord, 0.99)
+            << ", \"p999\": " << percentil(ord, 0.999)
+            << ", \"max\": " << (ord.empty() ? 0 : ord.back()) << "}"
+            << ", \"blocks_read_per_op\": {\"data\": " << r.dadosLidos * porOp
+            << ", \"index\": " << r.indiceLidos * porOp << "}"
+            << ", \"blocks_written_per_op\": {\"data\": " << r.dadosEscritos * porOp
+            << ", \"index\": " << r.indiceEscritos * porOp << "}}"
+            << (i + 1 < resultados.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+static void executarDistribuicao(const BenchConfig& cfg, bool zipfian, std::vector<Resultado>& resultados) {
+    const std::string nomeDist = zipfian ? "zipfian" : "uniform";
+    const std::string dir = cfg.dir + "/" + nomeDist;
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const std::string dat = dir + "/artigos.dat";
+    const std::string tabela = dir + "/tabela_hash.idx";
+    const std::string prim = dir + "/prim_index.idx";
+    const std::string sec = dir + "/sec_index.idx";
+
+    std::mt19937_64 rng(cfg.semente + (zipfian ? 1 : 0));
+    std::vector<int> ids = gerarIds(zipfian, cfg.registros, rng);
+    std::vector<std::pair<int, long>> entradasPrim;
+    std::vector<std::pair<int, long>> entradasSec;
+    entradasPrim.reserve(ids.size());
+    entradasSec.reserve(ids.size());
+
+    HashingFile hash(dat, TAMANHO_TABELA_HASH, tabela);
+    BPlusTree<long> idxPrim(prim);
+    BPlusTree<long> idxSec(sec);
+
+    std::cerr << "[bench] " << nomeDist << ": carga de " << ids.size() << " registros" << std::endl;
+    {
+        Resultado r{"bulk_load_hash", nomeDist};
+        hash.zerarEstatisticas();
+        {
+            Cronometro c(r);
+            for (int id : ids) {
+                Artigo art = artigoSintetico(id, rng);
+                c.medir([&] {
+                    long rid = hash.inserirArtigo(art);
+                    entradasPrim.push_back({id, rid});
+                    entradasSec.push_back({chaveTitulo(tituloSintetico(id)), rid});
+                });
+            }
+        }
+        registrarIO(r, hash, 0, 0);
+        resultados.push_back(std::move(r));
+    }
+
+    auto porChave = [](const std::pair<int, long>& a, const std::pair<int, long>& b) { return a.first < b.first; };
+    std::sort(entradasPrim.begin(), entradasPrim.end(), porChave);
+    std::sort(entradasSec.begin(), entradasSec.end(), porChave);
+
+    auto cargaIndice = [&](const char* nome, BPlusTree<long>& idx, std::vector<std::pair<int, long>>& entradas) {
+        Resultado r{nome, nomeDist};
+        hash.zerarEstatisticas();
+        idx.resetStats();
+        {
+            Cronometro c(r);
+            for (auto& e : entradas) c.medir([&] { idx.insert(e.first, &e.second); });
+        }
+        registrarIO(r, hash, idx.getBlocksRead(), idx.getBlocksWritten());
+        resultados.push_back(std::move(r));
+    };
+    cargaIndice("bulk_load_bptree_prim", idxPrim, entradasPrim);
+    cargaIndice("bulk_load_bptree_sec", idxSec, entradasSec);
+
+    // ordem de popularidade sobre as chaves ordenadas
+    std::vector<int> chaves(entradasPrim.size());
+    for (std::size_t i = 0; i < chaves.size(); ++i) chaves[i] = entradasPrim[i].first;
+    Distribuicao dist(zipfian, chaves.size(), rng);
+
+    std::cerr << "[bench] " << nomeDist << ": buscas pontuais" << std::endl;
+    {
+        Resultado r{"point_lookup_id_hash", nomeDist};
+        hash.zerarEstatisticas();
+        {
+            Cronometro c(r);
+            for (std::size_t i = 0; i < cfg.operacoes; ++i) {
+                int id = chaves[dist.proximo()];
+                c.medir([&] {
+                    int blocos = 0;
+                    hash.buscarPorId(id, blocos);
+                });
+            }
+        }
+        registrarIO(r, hash, 0, 0);
+        resultados.push_back(std::move(r));
+    }
+
+    {
+        Resultado r{"point_lookup_id_bptree", nomeDist};
+        hash.zerarEstatisticas();
+        idxPrim.resetStats();
+        {
+            Cronometro c(r);
+            for (std::size_t i = 0; i < cfg.operacoes; ++i) {
+                int id = chaves[dist.proximo()];
+                c.medir([&] {
+                    for (long off : idxPrim.searchAll(id)) {
+                        long rid;
+                        Artigo art;
+                        if (idxPrim.readValue(off, rid)) hash.lerPorRid(rid, art);
+                    }
+                });
+            }
+        }
+        registrarIO(r, hash, idxPrim.getBlocksRead(), idxPrim.getBlocksWritten());
+        resultados.push_back(std::move(r));
+    }
+
+    {
+        Resultado r{"point_lookup_title_bptree", nomeDist};
+        hash.zerarEstatisticas();
+        idxSec.resetStats();
+        {
+            Cronometro c(r);
+            for (std::size_t i = 0; i < cfg.operacoes; ++i) {
+                std::string titulo = tituloSintetico(chaves[dist.proximo()]);
+                c.medir([&] {
+                    for (long off : idxSec.searchAll(chaveTitulo(titulo))) {
+                        long rid;
+                        Artigo art;
+                        if (idxSec.readValue(off, rid) && hash.lerPorRid(rid, art) && titulo == art.titulo) break;
+                    }
+                });
+            }
+        }
+        registrarIO(r, hash, idxSec.getBlocksRead(), idxSec.getBlocksWritten());
+        resultados.push_back(std::move(r));
+    }
+
+    std::cerr << "[bench] " << nomeDist << ": varreduras por faixa" << std::endl;
+    {
+        Resultado r{"range_scan_bptree", nomeDist};
+        hash.zerarEstatisticas();
+        idxPrim.resetStats();
+        std::size_t nScans = std::max<std::size_t>(1, cfg.operacoes / 10);
+        {
+            Cronometro c(r);
+            for (std::size_t i = 0; i < nScans; ++i) {
+                std::size_t inicio = dist.proximo();
+                std::size_t fim = std::min(inicio + cfg.larguraScan - 1, chaves.size() - 1);
+                c.medir([&] {
+                    idxPrim.scanRange(chaves[inicio], chaves[fim], [&](int, long off) {
+                        long rid;
+                        Artigo art;
+                        if (idxPrim.readValue(off, rid)) hash.lerPorRid(rid, art);
+                        return true;
+                    });
+                });
+            }
+        }
+        registrarIO(r, hash, idxPrim.getBlocksRead(), idxPrim.getBlocksWritten());
+        resultados.push_back(std::move(r));
+    }
+
+    std::cerr << "[bench] " << nomeDist << ": carga mista" << std::endl;
+    {
+        // 50% inserções de IDs novos (hash + dois índices), 50% buscas pelo índice primário
+        Resultado r{"mixed_insert_lookup", nomeDist};
+        hash.zerarEstatisticas();
+        idxPrim.resetStats();
+        idxSec.resetStats();
+        int proximoId = chaves.back() + 1;
+        {
+            Cronometro c(r);
+            for (std::size_t i = 0; i < cfg.operacoes; ++i) {
+                if (rng() & 1) {
+                    Artigo art = artigoSintetico(proximoId++, rng);
+                    c.medir([&] {
+                        long rid = hash.inserirArtigo(art);
+                        idxPrim.insert(art.id, &rid);
+                        idxSec.insert(chaveTitulo(art.titulo), &rid);
+                    });
+                } else {
+                    int id = chaves[dist.proximo()];
+                    c.medir([&] {
+                        for (long off : idxPrim.searchAll(id)) {
+                            long rid;
+                            Artigo art;
+                            if (idxPrim.readValue(off, rid)) hash.lerPorRid(rid, art);
+                        }
+                    });
+                }
+            }
+        }
+        registrarIO(r, hash, idxPrim.getBlocksRead() + idxSec.getBlocksRead(),
+                    idxPrim.getBlocksWritten() + idxSec.getBlocksWritten());
+        resultados.push_back(std::move(r));
+    }
+}
+
+int main(int argc, char* argv[]) {
+    startMetricsServerFromEnv();
+    BenchConfig cfg;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto valor = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                std::cerr << "Faltou o valor de " << arg << std::endl;
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        try {
+            if (arg == "--registros") cfg.registros = std::stoul(valor());
+            else if (arg == "--operacoes") cfg.operacoes = std::stoul(valor());
+            else if (arg == "--largura-scan") cfg.larguraScan = std::stoul(valor());
+            else if (arg == "--semente") cfg.semente = std::stoull(valor());
+            else if (arg == "--dir") cfg.dir = valor();
+            else if (arg == "--saida") cfg.saida = valor();
+            else if (arg == "--manter") cfg.manter = true;
+            else {
+                std::cerr << "Uso: " << argv[0] << " [--registros N] [--operacoes N] [--largura-scan N]"
+                          << " [--semente S] [--dir DIR] [--manter] [--saida ARQUIVO.json]" << std::endl;
+                return 1;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Valor invalido para " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (cfg.registros < 2 || cfg.larguraScan == 0) {
+        std::cerr << "Use --registros >= 2 e --largura-scan >= 1" << std::endl;
+        return 1;
+    }
+
+    // o HashingFile escreve avisos em stdout; o JSON sai pelo stdout original
+    std::streambuf* stdoutOriginal = std::cout.rdbuf(std::cerr.rdbuf());
+
+    std::vector<Resultado> resultados;
+    for (bool zipfian : {false, true}) {
+        executarDistribuicao(cfg, zipfian, resultados);
+        // executarDistribuicao já fechou os arquivos
+        if (!cfg.manter) std::filesystem::remove_all(cfg.dir + (zipfian ? "/zipfian" : "/uniform"));
+    }
+    if (!cfg.manter) {
+        std::error_code ec;
+        std::filesystem::remove(cfg.dir, ec); // só se ficou vazio
+    }
+
+    if (cfg.saida.empty()) {
+        std::ostream out(stdoutOriginal);
+        escreverJson(out, cfg, resultados);
+    } else {
+        std::ofstream out(cfg.saida);
+        escreverJson(out, cfg, resultados);
+        std::cerr << "[bench] resultados em " << cfg.saida << std::endl;
+    }
+    std::cout.rdbuf(stdoutOriginal);
+    return 0;
+}
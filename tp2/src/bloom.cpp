@@ -0,0 +1,168 @@
+#include "../include/bloom.h"
+#include "../include/config.h"
+#include "../include/metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char BLOOM_MAGIC[4] = {'B', 'L', 'M', '1'};
+
+// finalizador do splitmix64: espalha bem chaves pequenas/sequenciais
+static std::uint64_t mix64(std::uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+std::uint64_t bloomHashId(int id) {
+    return mix64(static_cast<std::uint64_t>(static_cast<std::uint32_t>(id)) + 0x9e3779b97f4a7c15ULL);
+}
+
+std::uint64_t bloomHashTitulo(const std::string& tituloNormalizado) {
+    std::uint64_t hash = 14695981039346656037ULL; // FNV-1a 64
+    for (unsigned char c : tituloNormalizado) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return mix64(hash);
+}
+
+double bloomFprFromEnv() {
+    double fpr = std::atof(getEnv("BLOOM_FPR", "0.01").c_str());
+    if (!(fpr > 0.0 && fpr < 1.0)) fpr = 0.01;
+    return fpr;
+}
+
+BloomFilter::~BloomFilter() {
+    liberar();
+}
+
+void BloomFilter::liberar() {
+    if (map_) munmap(map_, mapLen_);
+    map_ = nullptr;
+    mapLen_ = 0;
+    own_.clear();
+    words_ = nullptr;
+}
+
+void BloomFilter::criar(std::size_t capacidade, double fpr) {
+    liberar();
+    capacidade = std::max<std::size_t>(capacidade, 1);
+
+    // bits por chave do Bloom clássico; o blocado perde um pouco de precisão
+    // pela variância da ocupação dos blocos, compensada com ~20% a mais de bits
+    double bitsPorChave = -std::log(fpr) / (std::log(2.0) * std::log(2.0)) * 1.2;
+    std::size_t bits = static_cast<std::size_t>(std::ceil(bitsPorChave * static_cast<double>(capacidade)));
+    std::size_t numBlocos = std::max<std::size_t>(1, (bits + BLOCK_BITS - 1) / BLOCK_BITS);
+    int k = static_cast<int>(std::lround(bitsPorChave / 1.2 * std::log(2.0)));
+    k = std::min(std::max(k, 1), 16);
+
+    std::memcpy(header_.magic, BLOOM_MAGIC, sizeof(BLOOM_MAGIC));
+    header_.k = static_cast<std::uint32_t>(k);
+    header_.numBlocos = numBlocos;
+    header_.capacidade = capacidade;
+    header_.inseridos = 0;
+    header_.fpr = fpr;
+
+    own_.assign(numBlocos * WORDS_PER_BLOCK, 0);
+    words_ = own_.data();
+}
+
+bool BloomFilter::carregar(const std::string& caminho) {
+    liberar();
+    std::ifstream in(caminho, std::ios::binary);
+    if (!in.is_open()) return false;
+    if (!in.read(reinterpret_cast<char*>(&header_), sizeof(Header))) return false;
+    if (std::memcmp(header_.magic, BLOOM_MAGIC, sizeof(BLOOM_MAGIC)) != 0 || header_.numBlocos == 0) return false;
+
+    own_.resize(header_.numBlocos * WORDS_PER_BLOCK);
+    if (!in.read(reinterpret_cast<char*>(own_.data()), static_cast<std::streamsize>(tamanhoBytes()))) {
+        own_.clear();
+        return false;
+    }
+    words_ = own_.data();
+    return true;
+}
+
+bool BloomFilter::abrir(const std::string& caminho) {
+    liberar();
+    int fd = ::open(caminho.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(Header)) {
+        ::close(fd);
+        return false;
+    }
+    void* p = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+    // acesso aleatório: não vale a pena o kernel ler páginas vizinhas
+    madvise(p, static_cast<std::size_t>(st.st_size), MADV_RANDOM);
+
+    std::memcpy(&header_, p, sizeof(Header));
+    std::size_t esperado = sizeof(Header) + header_.numBlocos * BLOCK_BYTES;
+    if (std::memcmp(header_.magic, BLOOM_MAGIC, sizeof(BLOOM_MAGIC)) != 0 || header_.numBlocos == 0 ||
+        static_cast<std::size_t>(st.st_size) < esperado) {
+        munmap(p, static_cast<std::size_t>(st.st_size));
+        return false;
+    }
+    map_ = p;
+    mapLen_ = static_cast<std::size_t>(st.st_size);
+    words_ = reinterpret_cast<const std::uint64_t*>(static_cast<const char*>(p) + sizeof(Header));
+    return true;
+}
+
+bool BloomFilter::salvar(const std::string& caminho) const {
+    if (!words_) return false;
+    // grava em arquivo temporário e renomeia: leitores nunca veem um filtro pela metade
+    std::string tmp = caminho + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        out.write(reinterpret_cast<const char*>(&header_), sizeof(Header));
+        out.write(reinterpret_cast<const char*>(words_), static_cast<std::streamsize>(tamanhoBytes()));
+        if (!out.good()) return false;
+    }
+    return std::rename(tmp.c_str(), caminho.c_str()) == 0;
+}
+
+void BloomFilter::add(std::uint64_t hash) {
+    // bloco pela metade alta (multiply-shift), bits pela metade baixa com hashing duplo
+    std::size_t bloco = static_cast<std::size_t>(((hash >> 32) * header_.numBlocos) >> 32);
+    std::uint32_t h1 = static_cast<std::uint32_t>(hash);
+    std::uint32_t h2 = static_cast<std::uint32_t>(mix64(hash) >> 32) | 1u;
+    std::uint64_t* w = own_.data() + bloco * WORDS_PER_BLOCK;
+    for (std::uint32_t i = 0; i < header_.k; ++i) {
+        std::uint32_t bit = (h1 + i * h2) & (BLOCK_BITS - 1);
+        w[bit >> 6] |= std::uint64_t{1} << (bit & 63);
+    }
+    header_.inseridos++;
+}
+
+bool BloomFilter::mayContain(std::uint64_t hash) const {
+    if (!words_) return true; // sem filtro, tudo "talvez"
+    StorageMetrics& metrics = StorageMetrics::get();
+    metrics.bloomChecks.inc();
+
+    std::size_t bloco = static_cast<std::size_t>(((hash >> 32) * header_.numBlocos) >> 32);
+    std::uint32_t h1 = static_cast<std::uint32_t>(hash);
+    std::uint32_t h2 = static_cast<std::uint32_t>(mix64(hash) >> 32) | 1u;
+    const std::uint64_t* w = words_ + bloco * WORDS_PER_BLOCK;
+    for (std::uint32_t i = 0; i < header_.k; ++i) {
+        std::uint32_t bit = (h1 + i * h2) & (BLOCK_BITS - 1);
+        if (!(w[bit >> 6] & (std::uint64_t{1} << (bit & 63)))) {
+            metrics.bloomNegatives.inc();
+            return false;
+        }
+    }
+    return true;
+}
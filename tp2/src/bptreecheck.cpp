@@ -0,0 +1,190 @@
+#include "../include/BPlusTree.hpp"
+#include "../include/config.h"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// Verificação da B+ tree sob churn: inserções avulsas e em lote e remoções
+// aleatórias, com chaves repetidas, conferindo a árvore contra um
+// std::multimap a cada rodada (varredura completa em ordem e busca de cada
+// chave). Compilada com uma ordem pequena (make check-bptree usa -DM=2),
+// splits, empréstimos, fusões e o reaproveitamento de páginas liberadas
+// acontecem a cada poucas operações; com poucas chaves (--chaves 30) as
+// repetidas se espalham por várias folhas e separadores.
+// Com --payloads, a mesma carga passa por insertSortedPayloads/removePayload,
+// com o valor no slot da folha (como o índice ano/citações); --carga N parte
+// de uma árvore montada por bulkLoadPayloads com N entradas.
+
+struct CheckConfig {
+    int sementes = 20;
+    int operacoes = 4000;
+    int chaves = 400;   // universo de chaves
+    int entradas = 200; // inserções param quando a árvore chega a esse tamanho
+    int carga = 0;      // entradas do bulkLoadPayloads inicial (implica --payloads)
+    std::string arquivo = DB_DIR + "/bptreecheck.idx";
+    bool payloads = false;
+};
+
+// valor de uma entrada: o próprio slot da folha, ou a página de dados apontada por ele
+static bool lerValor(BPlusTree<long>& arvore, bool payloads, long slot, long& valor) {
+    if (payloads) {
+        valor = slot;
+        return true;
+    }
+    return arvore.readValue(slot, valor);
+}
+
+// Entre chaves iguais a árvore não garante a ordem dos valores: a varredura
+// tem de sair em ordem de chave e, ordenada também pelo valor, bater com o modelo
+static bool conferir(BPlusTree<long>& arvore, bool payloads, const std::multimap<int, long>& modelo, std::string& erro) {
+    std::vector<std::pair<int, long>> vistos;
+    arvore.scanRange(INT_MIN, INT_MAX, [&](int chave, long slot) {
+        long valor = -1;
+        lerValor(arvore, payloads, slot, valor);
+        vistos.push_back({chave, valor});
+        return vistos.size() <= modelo.size(); // árvore com entradas a mais: não varre para sempre
+    });
+    if (vistos.size() != modelo.size()) {
+        erro = "varredura com " + std::to_string(vistos.size()) + " entradas, esperadas " + std::to_string(modelo.size());
+        return false;
+    }
+    for (std::size_t i = 1; i < vistos.size(); ++i) {
+        if (vistos[i].first < vistos[i - 1].first) {
+            erro = "varredura fora de ordem na posicao " + std::to_string(i) + ": chave " +
+                   std::to_string(vistos[i].first) + " depois de " + std::to_string(vistos[i - 1].first);
+            return false;
+        }
+    }
+    std::vector<std::pair<int, long>> esperados(modelo.begin(), modelo.end());
+    std::sort(vistos.begin(), vistos.end());
+    std::sort(esperados.begin(), esperados.end());
+    for (std::size_t i = 0; i < vistos.size(); ++i) {
+        if (vistos[i] != esperados[i]) {
+            erro = "posicao " + std::to_string(i) + " da varredura ordenada: (" + std::to_string(vistos[i].first) + ", " +
+                   std::to_string(vistos[i].second) + "), esperado (" + std::to_string(esperados[i].first) + ", " +
+                   std::to_string(esperados[i].second) + ")";
+            return false;
+        }
+    }
+    for (auto it = modelo.begin(); it != modelo.end(); it = modelo.upper_bound(it->first)) {
+        auto faixa = modelo.equal_range(it->first);
+        std::vector<long> esperado, achado;
+        for (auto e = faixa.first; e != faixa.second; ++e) esperado.push_back(e->second);
+        for (long slot : arvore.searchAll(it->first)) {
+            long valor = -1;
+            lerValor(arvore, payloads, slot, valor);
+            achado.push_back(valor);
+        }
+        std::sort(esperado.begin(), esperado.end());
+        std::sort(achado.begin(), achado.end());
+        if (achado != esperado) {
+            erro = "busca da chave " + std::to_string(it->first) + " achou " + std::to_string(achado.size()) +
+                   " valores, esperados " + std::to_string(esperado.size());
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool rodar(const CheckConfig& cfg, int semente) {
+    std::remove(cfg.arquivo.c_str());
+    std::mt19937 rng(static_cast<unsigned>(semente));
+    std::multimap<int, long> modelo;
+    long proximoValor = 1;
+    bool ok = true;
+    {
+        BPlusTree<long> arvore(cfg.arquivo);
+        std::uniform_int_distribution<int> chave(0, cfg.chaves - 1);
+        std::uniform_int_distribution<int> operacao(0, 9);
+        if (cfg.carga > 0) {
+            std::vector<std::pair<int, long>> entradas;
+            for (int j = 0; j < cfg.carga; ++j) entradas.push_back({chave(rng), proximoValor++});
+            std::stable_sort(entradas.begin(), entradas.end(),
+                             [](const std::pair<int, long>& a, const std::pair<int, long>& b) { return a.first < b.first; });
+            arvore.bulkLoadPayloads(entradas);
+            modelo.insert(entradas.begin(), entradas.end());
+            std::string erro;
+            if (!conferir(arvore, true, modelo, erro)) {
+                std::cerr << "semente " << semente << ", carga inicial: " << erro << std::endl;
+                ok = false;
+            }
+        }
+        for (int op = 1; ok && op <= cfg.operacoes; ++op) {
+            int tipo = operacao(rng);
+            if (tipo < 4) {
+                if (static_cast<int>(modelo.size()) >= cfg.entradas) continue;
+                int k = chave(rng);
+                long v = proximoValor++;
+                if (cfg.payloads) arvore.insertSortedPayloads({{k, v}});
+                else arvore.insert(k, &v);
+                modelo.insert({k, v});
+            } else if (tipo < 5) {
+                if (static_cast<int>(modelo.size()) >= cfg.entradas) continue;
+                // lote ordenado, possivelmente com chaves repetidas
+                std::multimap<int, long> lote;
+                for (int j = 0; j < 8; ++j) lote.insert({chave(rng), proximoValor++});
+                std::vector<std::pair<int, long>> entradas(lote.begin(), lote.end());
+                if (cfg.payloads) arvore.insertSortedPayloads(entradas);
+                else arvore.insertSorted(entradas);
+                modelo.insert(lote.begin(), lote.end());
+            } else if (!modelo.empty()) {
+                // uma das entradas (ao acaso) da primeira chave >= a sorteada
+                auto it = modelo.lower_bound(chave(rng));
+                if (it == modelo.end()) it = modelo.begin();
+                auto fim = modelo.upper_bound(it->first);
+                std::advance(it, std::uniform_int_distribution<long>(0, std::distance(it, fim) - 1)(rng));
+                bool removida = cfg.payloads ? arvore.removePayload(it->first, it->second) : arvore.remove(it->first, it->second);
+                if (!removida) {
+                    std::cerr << "semente " << semente << ", operacao " << op << ": remove(" << it->first
+                              << ") nao achou a entrada" << std::endl;
+                    ok = false;
+                }
+                modelo.erase(it);
+            }
+            std::string erro;
+            if (ok && op % 50 == 0 && !conferir(arvore, cfg.payloads, modelo, erro)) {
+                std::cerr << "semente " << semente << ", operacao " << op << ": " << erro << std::endl;
+                ok = false;
+            }
+        }
+    }
+    std::remove(cfg.arquivo.c_str());
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    CheckConfig cfg;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--payloads") cfg.payloads = true;
+        else if (arg == "--carga" && i + 1 < argc) cfg.carga = std::atoi(argv[++i]);
+        else if (arg == "--entradas" && i + 1 < argc) cfg.entradas = std::atoi(argv[++i]);
+        else if (arg == "--sementes" && i + 1 < argc) cfg.sementes = std::atoi(argv[++i]);
+        else if (arg == "--operacoes" && i + 1 < argc) cfg.operacoes = std::atoi(argv[++i]);
+        else if (arg == "--chaves" && i + 1 < argc) cfg.chaves = std::atoi(argv[++i]);
+        else if (arg == "--arquivo" && i + 1 < argc) cfg.arquivo = argv[++i];
+        else {
+            std::cerr << "Uso: " << argv[0] << " [--payloads] [--carga N] [--entradas N] [--sementes N] [--operacoes N] [--chaves N] [--arquivo ARQUIVO]" << std::endl;
+            return 1;
+        }
+    }
+    if (cfg.carga > 0) cfg.payloads = true;
+    // uma árvore com um nó pendurado na folha errada pode entrar em laço
+    alarm(600);
+
+    int falhas = 0;
+    for (int s = 1; s <= cfg.sementes; ++s) {
+        if (!rodar(cfg, s)) falhas++;
+    }
+    std::cout << "bptreecheck (M=" << M << ", " << cfg.chaves << " chaves" << (cfg.payloads ? ", payloads" : "")
+              << (cfg.carga > 0 ? ", carga " + std::to_string(cfg.carga) : "") << "): " << cfg.sementes - falhas << "/" << cfg.sementes
+              << " sementes ok, " << cfg.operacoes << " operacoes cada" << std::endl;
+    return falhas == 0 ? 0 : 1;
+}
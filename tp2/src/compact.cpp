@@ -0,0 +1,65 @@
+#include "../include/hashing_file.h"
+#include "../include/manutencao.h"
+#include "../include/metrics.h"
+#include "../include/particoes.h"
+#include "../include/config.h"
+#include <iostream>
+#include <chrono>
+#include <vector>
+
+const int TAMANHO_TABELA = 100000; // mesmo tamanho de tabela do upload
+
+// Compacta as cadeias de overflow de artigos.dat de uma partição: cada bucket
+// passa a ocupar blocos cheios e contíguos, e os RIDs dos índices B+ são
+// atualizados.
+static bool compactaParticao(const Caminhos& c) {
+    std::vector<long> novoRid;
+    long blocosAntes, blocosDepois;
+    {
+        HashingFile arquivoHash(c.dados, TAMANHO_TABELA, c.tabelaHash);
+        blocosAntes = arquivoHash.getTotalBlocos();
+        if (blocosAntes == 0) {
+            std::cerr << "Erro: arquivo de dados " << c.dados << " vazio ou inexistente. Execute o upload primeiro." << std::endl;
+            return false;
+        }
+
+        std::cout << "--- Compactando " << c.dados << " (" << blocosAntes << " blocos) ---" << std::endl;
+        if (!arquivoHash.compactar(novoRid)) {
+            std::cerr << "Erro na compactacao. Abortando." << std::endl;
+            return false;
+        }
+        blocosDepois = arquivoHash.getTotalBlocos();
+    }
+
+    std::size_t movidos = 0;
+    for (std::size_t rid = 0; rid < novoRid.size(); ++rid) {
+        if (novoRid[rid] >= 0 && novoRid[rid] != static_cast<long>(rid)) movidos++;
+    }
+    std::cout << c.dados << ": blocos " << blocosAntes << " -> " << blocosDepois
+              << " | registros que mudaram de RID: " << movidos << std::endl;
+
+    std::cout << "--- Atualizando RIDs dos indices ---" << std::endl;
+    if (!remapearRids(novoRid, c)) {
+        std::cerr << "Erro ao atualizar os indices. Abortando." << std::endl;
+        return false;
+    }
+    if (!reconstruirIndicesDerivados(c)) {
+        std::cerr << "Erro ao reconstruir os indices derivados. Abortando." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// As partições são compactadas em paralelo
+int main() {
+    startMetricsServerFromEnv();
+    std::cout << "DATA_DIR: " << DATA_DIR << " (" << numParticoes() << " particoes)" << std::endl;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    if (!paraCadaParticao([](int, const Caminhos& c) { return compactaParticao(c); })) return 1;
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "--- Compactacao finalizada em " << elapsed << "ms ---" << std::endl;
+    return 0;
+}
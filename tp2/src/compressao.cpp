@@ -0,0 +1,231 @@
+#include "../include/compressao.h"
+#include "../include/hashing_file.h"
+#include "../include/lz.h"
+#include "../include/metrics.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char COMPRESSAO_MAGIC[4] = {'L', 'Z', 'D', '1'};
+
+struct Cabecalho {
+    char magic[4];
+    std::uint32_t blocosPorGrupo;
+    std::uint64_t tamanhoBloco;   // sizeof(Bloco) de quem gravou
+    std::uint64_t numBlocos;
+    std::uint64_t numGrupos;
+    std::uint64_t offTabela;
+    std::uint64_t tamanhoOrigem;  // tamanho de artigos.dat na geração
+    std::uint64_t tamanho;
+    char reservado[8];
+};
+static_assert(sizeof(Cabecalho) == 64, "cabecalho dos dados comprimidos deve ter 64 bytes");
+
+inline void copiarTexto(char* destino, const char* origem, std::size_t tam) {
+    std::memcpy(destino, origem, strnlen(origem, tam));
+}
+
+// Cópia do bloco com tudo que não é dado zerado: bytes de alinhamento, o que
+// vem depois do terminador dos textos e slots livres ou além de num_registros_usados
+void normalizar(const Bloco& origem, Bloco& limpo) {
+    std::memset(&limpo, 0, sizeof(Bloco));
+    limpo.num_registros_usados = origem.num_registros_usados;
+    limpo.proximo_bloco_offset = origem.proximo_bloco_offset;
+    for (int i = 0; i < origem.num_registros_usados && i < REGISTROS_POR_BLOCO; ++i) {
+        const Artigo& a = origem.artigos[i];
+        if (!a.ocupado) continue;
+        Artigo& b = limpo.artigos[i];
+        b.ocupado = true;
+        b.id = a.id;
+        b.ano = a.ano;
+        b.citacoes = a.citacoes;
+        copiarTexto(b.titulo, a.titulo, sizeof(a.titulo));
+        copiarTexto(b.autores, a.autores, sizeof(a.autores));
+        copiarTexto(b.atualizacao, a.atualizacao, sizeof(a.atualizacao));
+        copiarTexto(b.snippet, a.snippet, sizeof(a.snippet));
+    }
+    // o checksum do original cobria os bytes descartados; o da cópia é refeito
+    selarBloco(limpo);
+}
+
+} // namespace
+
+// ===== construção =====
+
+bool CompressorDeDados::iniciar(const std::string& caminho) {
+    caminho_ = caminho;
+    out_.open(caminho_ + ".tmp", std::ios::binary | std::ios::trunc);
+    if (!out_.is_open()) return false;
+    Cabecalho cab{};
+    out_.write(reinterpret_cast<const char*>(&cab), sizeof(cab)); // regravado em finalizar()
+    grupo_.assign(BLOCOS_POR_GRUPO * sizeof(Bloco), 0);
+    noGrupo_ = 0;
+    offsets_.assign(1, sizeof(Cabecalho));
+    numBlocos_ = 0;
+    bytesOriginais_ = 0;
+    return out_.good();
+}
+
+bool CompressorDeDados::adicionarBloco(const Bloco& bloco) {
+    normalizar(bloco, *reinterpret_cast<Bloco*>(grupo_.data() + noGrupo_ * sizeof(Bloco)));
+    noGrupo_++;
+    numBlocos_++;
+    bytesOriginais_ += sizeof(Bloco);
+    return noGrupo_ < BLOCOS_POR_GRUPO || fecharGrupo();
+}
+
+bool CompressorDeDados::fecharGrupo() {
+    if (noGrupo_ == 0) return true;
+    comprimido_.clear();
+    lzComprimir(grupo_.data(), noGrupo_ * sizeof(Bloco), comprimido_);
+    out_.write(comprimido_.data(), static_cast<std::streamsize>(comprimido_.size()));
+    offsets_.push_back(offsets_.back() + comprimido_.size());
+    noGrupo_ = 0;
+    return out_.good();
+}
+
+bool CompressorDeDados::finalizar() {
+    if (!fecharGrupo()) return false;
+    Cabecalho cab{};
+    std::memcpy(cab.magic, COMPRESSAO_MAGIC, sizeof(COMPRESSAO_MAGIC));
+    cab.blocosPorGrupo = static_cast<std::uint32_t>(BLOCOS_POR_GRUPO);
+    cab.tamanhoBloco = sizeof(Bloco);
+    cab.numBlocos = numBlocos_;
+    cab.numGrupos = offsets_.size() - 1;
+    cab.offTabela = offsets_.back();
+    cab.tamanhoOrigem = bytesOriginais_;
+    cab.tamanho = cab.offTabela + offsets_.size() * sizeof(std::uint64_t);
+
+    out_.write(reinterpret_cast<const char*>(offsets_.data()), static_cast<std::streamsize>(offsets_.size() * sizeof(std::uint64_t)));
+    out_.seekp(0);
+    out_.write(reinterpret_cast<const char*>(&cab), sizeof(cab));
+    out_.close();
+    if (!out_) return false;
+    std::string tmp = caminho_ + ".tmp";
+    return std::rename(tmp.c_str(), caminho_.c_str()) == 0;
+}
+
+bool CompressorDeDados::atualizar(const std::string& caminho, const std::string& dados, std::uint64_t tamanhoAnterior,
+                                  const std::vector<long>& blocosAlterados) {
+    std::ifstream atual(caminho, std::ios::binary);
+    Cabecalho cab{};
+    if (!atual.read(reinterpret_cast<char*>(&cab), sizeof(cab)) ||
+        std::memcmp(cab.magic, COMPRESSAO_MAGIC, sizeof(COMPRESSAO_MAGIC)) != 0 ||
+        cab.blocosPorGrupo != BLOCOS_POR_GRUPO || cab.tamanhoBloco != sizeof(Bloco) ||
+        cab.tamanhoOrigem != tamanhoAnterior) {
+        return false;
+    }
+    std::vector<std::uint64_t> tabela(cab.numGrupos + 1);
+    atual.seekg(static_cast<std::streamoff>(cab.offTabela));
+    if (!atual.read(reinterpret_cast<char*>(tabela.data()), static_cast<std::streamsize>(tabela.size() * sizeof(std::uint64_t)))) {
+        return false;
+    }
+    std::ifstream origem(dados, std::ios::binary | std::ios::ate);
+    if (!origem.is_open()) return false;
+    const std::size_t total = static_cast<std::size_t>(origem.tellg()) / sizeof(Bloco);
+    if (total < cab.numBlocos || !iniciar(caminho)) return false;
+
+    std::vector<char> copia;
+    Bloco bloco;
+    std::size_t k = 0;
+    for (std::size_t primeiro = 0; primeiro < total; primeiro += BLOCOS_POR_GRUPO) {
+        const std::size_t fim = std::min(primeiro + BLOCOS_POR_GRUPO, total);
+        while (k < blocosAlterados.size() && static_cast<std::size_t>(blocosAlterados[k]) < primeiro) ++k;
+        bool alterado = k < blocosAlterados.size() && static_cast<std::size_t>(blocosAlterados[k]) < fim;
+
+        if (!alterado && fim <= cab.numBlocos) {
+            // grupo igual ao da cópia atual (mesmos blocos, nenhum regravado)
+            std::size_t g = primeiro / BLOCOS_POR_GRUPO;
+            copia.resize(tabela[g + 1] - tabela[g]);
+            atual.seekg(static_cast<std::streamoff>(tabela[g]));
+            if (!atual.read(copia.data(), static_cast<std::streamsize>(copia.size()))) return false;
+            out_.write(copia.data(), static_cast<std::streamsize>(copia.size()));
+            offsets_.push_back(offsets_.back() + copia.size());
+            numBlocos_ += fim - primeiro;
+            bytesOriginais_ += (fim - primeiro) * sizeof(Bloco);
+            continue;
+        }
+        origem.seekg(static_cast<std::streamoff>(primeiro * sizeof(Bloco)));
+        for (std::size_t b = primeiro; b < fim; ++b) {
+            if (!origem.read(reinterpret_cast<char*>(&bloco), sizeof(Bloco)) || !conferirBloco(bloco, dados, b)) return false;
+            if (!adicionarBloco(bloco)) return false;
+        }
+    }
+    return out_.good() && finalizar();
+}
+
+// ===== consulta =====
+
+DadosComprimidos::~DadosComprimidos() {
+    if (base_) munmap(const_cast<unsigned char*>(base_), tamanho_);
+}
+
+bool DadosComprimidos::abrir(const std::string& caminho, const std::string& caminhoOrigem) {
+    struct stat origem;
+    if (stat(caminhoOrigem.c_str(), &origem) != 0) return false;
+
+    int fd = ::open(caminho.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(Cabecalho)) {
+        ::close(fd);
+        return false;
+    }
+    void* p = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+
+    const Cabecalho* cab = static_cast<const Cabecalho*>(p);
+    if (std::memcmp(cab->magic, COMPRESSAO_MAGIC, sizeof(COMPRESSAO_MAGIC)) != 0 ||
+        cab->blocosPorGrupo != BLOCOS_POR_GRUPO || cab->tamanhoBloco != sizeof(Bloco) ||
+        cab->tamanho > static_cast<std::uint64_t>(st.st_size) ||
+        cab->tamanhoOrigem != static_cast<std::uint64_t>(origem.st_size)) {
+        munmap(p, static_cast<std::size_t>(st.st_size));
+        return false;
+    }
+    // cada consulta toca um grupo só; não vale ler adiante
+    madvise(p, static_cast<std::size_t>(st.st_size), MADV_RANDOM);
+    base_ = static_cast<const unsigned char*>(p);
+    tamanho_ = static_cast<std::size_t>(st.st_size);
+    return true;
+}
+
+std::size_t DadosComprimidos::numBlocos() const {
+    return base_ ? reinterpret_cast<const Cabecalho*>(base_)->numBlocos : 0;
+}
+
+bool DadosComprimidos::lerBloco(std::size_t indice, Bloco& bloco) const {
+    if (!base_) return false;
+    const Cabecalho* cab = reinterpret_cast<const Cabecalho*>(base_);
+    if (indice >= cab->numBlocos) return false;
+    const std::uint64_t* tabela = reinterpret_cast<const std::uint64_t*>(base_ + cab->offTabela);
+    std::size_t g = indice / BLOCOS_POR_GRUPO;
+    std::uint64_t inicio = tabela[g];
+    std::uint64_t fim = tabela[g + 1];
+    if (inicio > fim || fim > cab->offTabela) return false;
+
+    std::size_t necessario = (indice % BLOCOS_POR_GRUPO + 1) * sizeof(Bloco);
+    if (buffer_.size() < BLOCOS_POR_GRUPO * sizeof(Bloco)) buffer_.resize(BLOCOS_POR_GRUPO * sizeof(Bloco));
+    long produzidos = lzDescomprimir(base_ + inicio, static_cast<std::size_t>(fim - inicio),
+                                     buffer_.data(), buffer_.size(), necessario);
+    if (produzidos < static_cast<long>(necessario)) return false;
+
+    StorageMetrics& metrics = StorageMetrics::get();
+    metrics.dataFileLzGroupsDecoded.inc();
+    metrics.dataFileLzBytesRead.inc(fim - inicio);
+    std::memcpy(&bloco, buffer_.data() + necessario - sizeof(Bloco), sizeof(Bloco));
+    return true;
+}
+
+bool compressaoDadosAtiva(const std::string& caminho) {
+    const char* valor = std::getenv("COMPRESSAO_DADOS");
+    if (valor && *valor && std::strcmp(valor, "0") != 0) return true;
+    return access(caminho.c_str(), F_OK) == 0;
+}
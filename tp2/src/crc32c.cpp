@@ -0,0 +1,142 @@
+#include "../include/crc32c.h"
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#define CRC32C_X86 1
+#endif
+
+namespace {
+
+const std::uint32_t POLINOMIO = 0x82F63B78u; // Castagnoli, refletido
+
+// fatia[k][b]: CRC (sem as inversões) do byte b seguido de k bytes zero
+struct Tabelas {
+    std::uint32_t fatia[8][256];
+
+    Tabelas() {
+        for (std::uint32_t b = 0; b < 256; ++b) {
+            std::uint32_t c = b;
+            for (int i = 0; i < 8; ++i) c = (c & 1) ? (c >> 1) ^ POLINOMIO : c >> 1;
+            fatia[0][b] = c;
+        }
+        for (int k = 1; k < 8; ++k) {
+            for (std::uint32_t b = 0; b < 256; ++b) {
+                fatia[k][b] = (fatia[k - 1][b] >> 8) ^ fatia[0][fatia[k - 1][b] & 0xff];
+            }
+        }
+    }
+};
+
+const Tabelas& tabelas() {
+    static const Tabelas t;
+    return t;
+}
+
+std::uint32_t crcSoftware(std::uint32_t crc, const unsigned char* p, std::size_t n) {
+    const Tabelas& t = tabelas();
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (n >= 8) {
+        std::uint32_t lo, hi;
+        std::memcpy(&lo, p, 4);
+        std::memcpy(&hi, p + 4, 4);
+        lo ^= crc;
+        crc = t.fatia[7][lo & 0xff] ^ t.fatia[6][(lo >> 8) & 0xff] ^ t.fatia[5][(lo >> 16) & 0xff] ^
+              t.fatia[4][lo >> 24] ^ t.fatia[3][hi & 0xff] ^ t.fatia[2][(hi >> 8) & 0xff] ^
+              t.fatia[1][(hi >> 16) & 0xff] ^ t.fatia[0][hi >> 24];
+        p += 8;
+        n -= 8;
+    }
+#endif
+    while (n--) crc = (crc >> 8) ^ t.fatia[0][(crc ^ *p++) & 0xff];
+    return crc;
+}
+
+#ifdef CRC32C_X86
+// Avança um CRC por 'n' bytes zero (multiplica por x^(8n) mod P). A operação é
+// linear, então vira quatro consultas de tabela montadas a partir da imagem
+// de cada bit.
+struct Deslocamento {
+    std::uint32_t t[4][256];
+
+    explicit Deslocamento(std::size_t n) {
+        const Tabelas& tab = tabelas();
+        std::uint32_t base[32];
+        for (int bit = 0; bit < 32; ++bit) {
+            std::uint32_t c = 1u << bit;
+            for (std::size_t i = 0; i < n; ++i) c = (c >> 8) ^ tab.fatia[0][c & 0xff];
+            base[bit] = c;
+        }
+        for (int k = 0; k < 4; ++k) {
+            t[k][0] = 0;
+            for (std::uint32_t b = 1; b < 256; ++b) {
+                t[k][b] = t[k][b & (b - 1)] ^ base[8 * k + __builtin_ctz(b)];
+            }
+        }
+    }
+
+    std::uint32_t operator()(std::uint32_t c) const {
+        return t[0][c & 0xff] ^ t[1][(c >> 8) & 0xff] ^ t[2][(c >> 16) & 0xff] ^ t[3][c >> 24];
+    }
+};
+
+inline std::uint64_t ler64(const unsigned char* p) {
+    std::uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+// A instrução crc32 tem latência de ~3 ciclos e vazão de 1 por ciclo: três
+// fluxos independentes sobre trechos vizinhos de TRECHO bytes mantêm a unidade
+// ocupada, e os CRCs parciais são combinados deslocando os dois primeiros.
+template <std::size_t TRECHO>
+__attribute__((target("sse4.2")))
+std::uint32_t tresFluxos(std::uint32_t crc, const unsigned char*& p, std::size_t& n) {
+    static const Deslocamento porUm(TRECHO), porDois(2 * TRECHO);
+    while (n >= 3 * TRECHO) {
+        std::uint64_t a = crc, b = 0, c = 0;
+        for (std::size_t i = 0; i < TRECHO; i += 8) {
+            a = _mm_crc32_u64(a, ler64(p + i));
+            b = _mm_crc32_u64(b, ler64(p + TRECHO + i));
+            c = _mm_crc32_u64(c, ler64(p + 2 * TRECHO + i));
+        }
+        crc = porDois(static_cast<std::uint32_t>(a)) ^ porUm(static_cast<std::uint32_t>(b)) ^
+              static_cast<std::uint32_t>(c);
+        p += 3 * TRECHO;
+        n -= 3 * TRECHO;
+    }
+    return crc;
+}
+
+// trechos longos em rodadas de 3 x 256 bytes; o que sobra (nós pela metade
+// ficam nessa faixa) em rodadas de 3 x 64, e o resto em série
+__attribute__((target("sse4.2")))
+std::uint32_t crcHardware(std::uint32_t crc, const unsigned char* p, std::size_t n) {
+    if (n >= 3 * 256) crc = tresFluxos<256>(crc, p, n);
+    if (n >= 3 * 64) crc = tresFluxos<64>(crc, p, n);
+    std::uint64_t c64 = crc;
+    for (; n >= 8; n -= 8, p += 8) c64 = _mm_crc32_u64(c64, ler64(p));
+    crc = static_cast<std::uint32_t>(c64);
+    for (; n > 0; --n) crc = _mm_crc32_u8(crc, *p++);
+    return crc;
+}
+#endif
+
+} // namespace
+
+bool crc32cPorHardware() {
+#ifdef CRC32C_X86
+    static const bool sse42 = __builtin_cpu_supports("sse4.2");
+    return sse42;
+#else
+    return false;
+#endif
+}
+
+std::uint32_t crc32c(const void* dados, std::size_t n, std::uint32_t crc) {
+    const unsigned char* p = static_cast<const unsigned char*>(dados);
+#ifdef CRC32C_X86
+    if (crc32cPorHardware()) return ~crcHardware(~crc, p, n);
+#endif
+    return ~crcSoftware(~crc, p, n);
+}
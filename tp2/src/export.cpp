@@ -0,0 +1,390 @@
+#include "../include/BPlusTree.hpp"
+#include "../include/hashing_file.h"
+#include "../include/metrics.h"
+#include "../include/particoes.h"
+#include "../include/config.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+// Exporta a tabela inteira em ordem de ID: percorre a cadeia de folhas do
+// índice primário e resolve os RIDs em lotes, lendo artigos.dat em ordem de
+// bloco (blocos vizinhos saem numa única leitura) e escrevendo por um buffer
+// grande com write(2). Com partições (particoes.h), cada uma tem um cursor
+// pela sua cadeia de folhas (os lotes continuam resolvidos por partição) e
+// os registros são intercalados por ID num merge de k vias.
+
+// Saída bufferizada direto no descritor; um write por buffer cheio
+class SaidaBuffer {
+public:
+    SaidaBuffer(int fd, std::size_t tamanho) : fd(fd), buf(tamanho), pos(0) {}
+    ~SaidaBuffer() { flush(); }
+
+    void put(char c) {
+        if (pos == buf.size()) flush();
+        buf[pos++] = c;
+    }
+    void put(const char* s, std::size_t n) {
+        if (pos + n > buf.size()) flush();
+        if (n > buf.size()) {
+            escrever(s, n);
+            return;
+        }
+        std::memcpy(&buf[pos], s, n);
+        pos += n;
+    }
+    void putNum(long v) {
+        char tmp[24];
+        int n = 0;
+        bool negativo = v < 0;
+        unsigned long u = negativo ? 0UL - static_cast<unsigned long>(v) : static_cast<unsigned long>(v);
+        do {
+            tmp[n++] = static_cast<char>('0' + u % 10);
+            u /= 10;
+        } while (u);
+        if (negativo) put('-');
+        while (n) put(tmp[--n]);
+    }
+    void flush() {
+        if (pos) escrever(buf.data(), pos);
+        pos = 0;
+    }
+    bool ok() const { return !falhou; }
+    std::uint64_t bytes() const { return escritos + pos; }
+
+private:
+    void escrever(const char* p, std::size_t n) {
+        while (n > 0 && !falhou) {
+            ssize_t w = ::write(fd, p, n);
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                falhou = true;
+                break;
+            }
+            p += w;
+            n -= static_cast<std::size_t>(w);
+            escritos += static_cast<std::uint64_t>(w);
+        }
+    }
+
+    int fd;
+    std::vector<char> buf;
+    std::size_t pos;
+    std::uint64_t escritos = 0;
+    bool falhou = false;
+};
+
+enum class Formato { CSV, NDJSON };
+
+// campo entre aspas, como no artigo.csv; aspas internas são dobradas
+static void campoCsv(SaidaBuffer& out, const char* s, std::size_t max) {
+    std::size_t n = strnlen(s, max);
+    out.put('"');
+    for (std::size_t i = 0; i < n; ++i) {
+        if (s[i] == '"') out.put('"');
+        out.put(s[i]);
+    }
+    out.put('"');
+}
+
+static void textoJson(SaidaBuffer& out, const char* s, std::size_t max) {
+    static const char HEX[] = "0123456789abcdef";
+    std::size_t n = strnlen(s, max);
+    out.put('"');
+    for (std::size_t i = 0; i < n; ++i) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c == '"' || c == '\\') {
+            out.put('\\');
+            out.put(static_cast<char>(c));
+        } else if (c == '\n') {
+            out.put("\\n", 2);
+        } else if (c == '\t') {
+            out.put("\\t", 2);
+        } else if (c < 0x20) {
+            char esc[6] = {'\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0xF]};
+            out.put(esc, sizeof(esc));
+        } else {
+            out.put(static_cast<char>(c));
+        }
+    }
+    out.put('"');
+}
+
+static void escreverArtigo(SaidaBuffer& out, const Artigo& art, Formato formato) {
+    if (formato == Formato::CSV) {
+        out.put('"'); out.putNum(art.id); out.put("\";", 2);
+        campoCsv(out, art.titulo, sizeof(art.titulo)); out.put(';');
+        out.put('"'); out.putNum(art.ano); out.put("\";", 2);
+        campoCsv(out, art.autores, sizeof(art.autores)); out.put(';');
+        out.put('"'); out.putNum(art.citacoes); out.put("\";", 2);
+        campoCsv(out, art.atualizacao, sizeof(art.atualizacao)); out.put(';');
+        campoCsv(out, art.snippet, sizeof(art.snippet));
+    } else {
+        out.put("{\"id\":", 6); out.putNum(art.id);
+        out.put(",\"titulo\":", 10); textoJson(out, art.titulo, sizeof(art.titulo));
+        out.put(",\"ano\":", 7); out.putNum(art.ano);
+        out.put(",\"autores\":", 11); textoJson(out, art.autores, sizeof(art.autores));
+        out.put(",\"citacoes\":", 12); out.putNum(art.citacoes);
+        out.put(",\"atualizacao\":", 15); textoJson(out, art.atualizacao, sizeof(art.atualizacao));
+        out.put(",\"snippet\":", 11); textoJson(out, art.snippet, sizeof(art.snippet));
+        out.put('}');
+    }
+    out.put('\n');
+}
+
+static bool lerTudo(int fd, char* destino, std::size_t n, off_t offset) {
+    while (n > 0) {
+        ssize_t r = pread(fd, destino, n, offset);
+        if (r <= 0) return false;
+        destino += r;
+        n -= static_cast<std::size_t>(r);
+        offset += r;
+    }
+    return true;
+}
+
+struct Entrada {
+    int id;
+    long dataOffset; // página do RID no índice primário
+    long rid;
+};
+
+struct Estatisticas {
+    std::uint64_t exportados = 0;
+    std::uint64_t inconsistentes = 0; // RID sem registro ocupado com o mesmo ID
+    std::uint64_t leituras = 0;       // preads em artigos.dat
+    std::uint64_t blocos = 0;
+};
+
+// Resolve um lote (em ordem de ID) nos registros válidos, na mesma ordem
+static bool processarLote(BPlusTree<long>& idx, const std::string& caminhoDados, int fdDados, std::size_t numBlocos, std::vector<Entrada>& lote,
+                          std::size_t maxBlocosPorLeitura, std::vector<Artigo>& artigos, Estatisticas& est) {
+    // RIDs: páginas de dados do índice em ordem de offset
+    std::vector<std::size_t> ordem(lote.size());
+    for (std::size_t i = 0; i < ordem.size(); ++i) ordem[i] = i;
+    std::sort(ordem.begin(), ordem.end(), [&](std::size_t a, std::size_t b) { return lote[a].dataOffset < lote[b].dataOffset; });
+    for (std::size_t i : ordem) {
+        if (!idx.readValue(lote[i].dataOffset, lote[i].rid)) lote[i].rid = -1;
+    }
+
+    // blocos distintos do lote, em ordem de arquivo
+    std::vector<long> blocos;
+    blocos.reserve(lote.size());
+    for (const Entrada& e : lote) {
+        if (e.rid >= 0 && static_cast<std::size_t>(e.rid / REGISTROS_POR_BLOCO) < numBlocos) {
+            blocos.push_back(e.rid / REGISTROS_POR_BLOCO);
+        }
+    }
+    std::sort(blocos.begin(), blocos.end());
+    blocos.erase(std::unique(blocos.begin(), blocos.end()), blocos.end());
+
+    // sequências de blocos consecutivos viram uma leitura só
+    std::vector<Bloco> lidos(blocos.size());
+    std::size_t i = 0;
+    while (i < blocos.size()) {
+        std::size_t j = i + 1;
+        while (j < blocos.size() && blocos[j] == blocos[j - 1] + 1 && j - i < maxBlocosPorLeitura) ++j;
+        if (!lerTudo(fdDados, reinterpret_cast<char*>(&lidos[i]), (j - i) * sizeof(Bloco),
+                     static_cast<off_t>(blocos[i]) * static_cast<off_t>(sizeof(Bloco)))) {
+            return false;
+        }
+        // registros de um bloco corrompido contam como inconsistentes
+        for (std::size_t k = i; k < j; ++k) {
+            if (!conferirBloco(lidos[k], caminhoDados, static_cast<std::size_t>(blocos[k]))) lidos[k].num_registros_usados = 0;
+        }
+        est.leituras++;
+        est.blocos += j - i;
+        StorageMetrics::get().dataFileBlocksRead.inc(j - i);
+        StorageMetrics::get().dataFileBytesRead.inc((j - i) * sizeof(Bloco));
+        i = j;
+    }
+
+    for (const Entrada& e : lote) {
+        if (e.rid < 0) {
+            est.inconsistentes++;
+            continue;
+        }
+        auto it = std::lower_bound(blocos.begin(), blocos.end(), e.rid / REGISTROS_POR_BLOCO);
+        if (it == blocos.end() || *it != e.rid / REGISTROS_POR_BLOCO) {
+            est.inconsistentes++;
+            continue;
+        }
+        const Bloco& bloco = lidos[static_cast<std::size_t>(it - blocos.begin())];
+        int pos = static_cast<int>(e.rid % REGISTROS_POR_BLOCO);
+        const Artigo& art = bloco.artigos[pos];
+        if (pos >= bloco.num_registros_usados || !art.ocupado || art.id != e.id) {
+            est.inconsistentes++;
+            continue;
+        }
+        artigos.push_back(art);
+    }
+    lote.clear();
+    return true;
+}
+
+// Cursor de uma partição: cada lote retoma a varredura do índice primário
+// logo depois do último ID lido (IDs não se repetem nele) e já sai resolvido
+struct Fonte {
+    Caminhos c;
+    int fdDados = -1;
+    std::size_t numBlocos = 0;
+    std::unique_ptr<BPlusTree<long>> idx;
+    std::vector<Entrada> lote;
+    std::vector<Artigo> artigos;
+    std::size_t pos = 0;
+    long proximoId = INT_MIN;
+
+    bool fim() const { return pos >= artigos.size(); }
+    const Artigo& atual() const { return artigos[pos]; }
+
+    // Lê lotes até ter algum registro válido ou a cadeia acabar
+    bool carregar(std::size_t tamLote, Estatisticas& est) {
+        const std::size_t maxBlocosPorLeitura = 64;
+        artigos.clear();
+        pos = 0;
+        while (artigos.empty() && proximoId <= INT_MAX) {
+            idx->scanRange(static_cast<int>(proximoId), INT_MAX, [&](int key, long dataOffset) {
+                lote.push_back({key, dataOffset, -1});
+                return lote.size() < tamLote;
+            });
+            if (lote.empty()) break;
+            proximoId = static_cast<long>(lote.back().id) + 1;
+            if (!processarLote(*idx, c.dados, fdDados, numBlocos, lote, maxBlocosPorLeitura, artigos, est)) return false;
+        }
+        return true;
+    }
+};
+
+static void uso(const char* prog) {
+    std::cerr << "Uso: " << prog << " [--formato csv|ndjson] [--saida ARQUIVO] [--lote N] [--buffer MB]\n"
+              << "  --formato   csv (mesmo formato do artigo.csv, padrao) ou ndjson (um objeto JSON por linha)\n"
+              << "  --saida     arquivo de destino (padrao: stdout)\n"
+              << "  --lote      IDs resolvidos por lote (padrao 8192)\n"
+              << "  --buffer    tamanho do buffer de saida em MB (padrao 4)" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    Formato formato = Formato::CSV;
+    std::string caminhoSaida;
+    std::size_t tamLote = 8192;
+    std::size_t bufferMb = 4;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool temValor = i + 1 < argc;
+        if (arg == "--formato" && temValor) {
+            std::string f = argv[++i];
+            if (f == "csv") formato = Formato::CSV;
+            else if (f == "ndjson" || f == "json") formato = Formato::NDJSON;
+            else {
+                uso(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--saida" && temValor) {
+            caminhoSaida = argv[++i];
+        } else if (arg == "--lote" && temValor) {
+            tamLote = std::max<std::size_t>(1, static_cast<std::size_t>(std::atol(argv[++i])));
+        } else if (arg == "--buffer" && temValor) {
+            bufferMb = std::max<std::size_t>(1, static_cast<std::size_t>(std::atol(argv[++i])));
+        } else if (arg == "--help" || arg == "-h") {
+            uso(argv[0]);
+            return 0;
+        } else {
+            uso(argv[0]);
+            return 1;
+        }
+    }
+    startMetricsServerFromEnv();
+
+    // o construtor da árvore criaria um índice vazio
+    int total = numParticoes();
+    for (int k = 0; k < total; ++k) {
+        Caminhos c = caminhosDaParticao(k);
+        struct stat st;
+        if (stat(c.primario.c_str(), &st) != 0) {
+            std::cerr << "Erro: indice primario '" << c.primario << "' ausente. Execute o upload primeiro." << std::endl;
+            return 1;
+        }
+    }
+
+    int fdSaida = STDOUT_FILENO;
+    if (!caminhoSaida.empty()) {
+        fdSaida = ::open(caminhoSaida.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fdSaida < 0) {
+            std::cerr << "Erro: nao foi possivel criar '" << caminhoSaida << "'" << std::endl;
+            return 1;
+        }
+    }
+
+    auto inicio = std::chrono::steady_clock::now();
+    Estatisticas est;
+    std::size_t paginasIndice = 0;
+    bool ok = true;
+    std::vector<Fonte> fontes(static_cast<std::size_t>(total));
+    for (int k = 0; k < total && ok; ++k) {
+        Fonte& f = fontes[k];
+        f.c = caminhosDaParticao(k);
+        struct stat st;
+        f.fdDados = ::open(f.c.dados.c_str(), O_RDONLY);
+        if (f.fdDados < 0 || fstat(f.fdDados, &st) != 0) {
+            std::cerr << "Erro: nao foi possivel abrir '" << f.c.dados << "'" << std::endl;
+            ok = false;
+            break;
+        }
+        f.numBlocos = static_cast<std::size_t>(st.st_size) / sizeof(Bloco);
+#ifdef POSIX_FADV_SEQUENTIAL
+        posix_fadvise(f.fdDados, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+        f.idx.reset(new BPlusTree<long>(f.c.primario));
+        f.lote.reserve(tamLote);
+    }
+    if (ok) {
+        SaidaBuffer out(fdSaida, bufferMb << 20);
+        // merge de k vias por ID; com uma partição é a própria cadeia de folhas
+        auto maior = [&](std::size_t a, std::size_t b) { return fontes[a].atual().id > fontes[b].atual().id; };
+        std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(maior)> heap(maior);
+        for (std::size_t i = 0; i < fontes.size() && ok; ++i) {
+            ok = fontes[i].carregar(tamLote, est);
+            if (ok && !fontes[i].fim()) heap.push(i);
+        }
+        while (ok && !heap.empty()) {
+            std::size_t i = heap.top();
+            heap.pop();
+            escreverArtigo(out, fontes[i].atual(), formato);
+            est.exportados++;
+            if (++fontes[i].pos == fontes[i].artigos.size()) ok = fontes[i].carregar(tamLote, est) && out.ok();
+            if (ok && !fontes[i].fim()) heap.push(i);
+        }
+        out.flush();
+        ok = ok && out.ok();
+    }
+    for (Fonte& f : fontes) {
+        if (f.idx) paginasIndice += f.idx->getBlocksRead();
+        if (f.fdDados >= 0) ::close(f.fdDados);
+    }
+    auto fim = std::chrono::steady_clock::now();
+    if (fdSaida != STDOUT_FILENO && ::close(fdSaida) != 0) ok = false;
+    if (!ok) {
+        std::cerr << "Erro: falha de leitura ou escrita durante a exportacao" << std::endl;
+        return 1;
+    }
+
+    double segundos = std::chrono::duration<double>(fim - inicio).count();
+    double mbDados = static_cast<double>(est.blocos) * sizeof(Bloco) / (1024.0 * 1024.0);
+    std::cerr << "Exportados: " << est.exportados << " registros";
+    if (est.inconsistentes) std::cerr << " (" << est.inconsistentes << " entradas do indice sem registro valido)";
+    std::cerr << "\nLeituras em artigos.dat: " << est.leituras << " (" << est.blocos << " blocos)" << std::endl;
+    std::cerr << "Paginas do indice lidas: " << paginasIndice << std::endl;
+    std::cerr << "Tempo: " << segundos * 1e3 << "ms (" << (segundos > 0 ? mbDados / segundos : 0.0) << " MB/s de dados)" << std::endl;
+    return 0;
+}
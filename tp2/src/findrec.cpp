@@ -1,9 +1,26 @@
 #include "../include/hashing_file.h"
+#include "../include/bloom.h"
+#include "../include/particoes.h"
 #include "../include/config.h" 
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
+const int TAMANHO_TABELA = 100000; // mesmo tamanho de tabela do upload
+
+// Tabela hash e Bloom filter de uma partição (particoes.h); cada ID é buscado
+// só na partição que o guarda
+struct Particao {
+    HashingFile arquivoHash;
+    BloomFilter bloom;
+
+    explicit Particao(const Caminhos& c) : arquivoHash(c.dados, TAMANHO_TABELA, c.tabelaHash) {
+        bloom.abrir(c.bloomId); // sem o arquivo, todas as consultas vão à tabela hash
+    }
+};
+
 void imprimirArtigoCompleto(const Artigo& art) {
     if (art.ocupado) {
         std::cout << "--- Registro Encontrado ---" << std::endl;
@@ -20,27 +37,91 @@ void imprimirArtigoCompleto(const Artigo& art) {
 }
 
 
+// Modo lote: um ID por linha (arquivo ou "-" para stdin); ao final imprime os
+// percentis de latência de cada fase da consulta.
+// Busca pelo ID consultando antes o Bloom filter: um ID ausente não lê a tabela hash nem a cadeia
+Artigo buscar(HashingFile& arquivoHash, const BloomFilter& bloom, int id, int& blocosLidos, const QueryTimings& tempos) {
+    blocosLidos = 0;
+    {
+        ScopedTimer tBloom(tempos.index);
+        if (!bloom.mayContain(bloomHashId(id))) return {};
+    }
+    return arquivoHash.buscarPorId(id, blocosLidos, &tempos);
+}
+
+int executarLote(std::vector<std::unique_ptr<Particao>>& particoes, const std::string& caminho, const QueryTimings& tempos) {
+    std::ifstream arquivo;
+    if (caminho != "-") {
+        arquivo.open(caminho);
+        if (!arquivo.is_open()) {
+            std::cerr << "Erro: nao foi possivel abrir o arquivo de IDs '" << caminho << "'." << std::endl;
+            return 1;
+        }
+    }
+    std::istream& in = caminho == "-" ? std::cin : arquivo;
+
+    long consultas = 0, encontrados = 0, blocosTotais = 0;
+    std::string linha;
+    while (std::getline(in, linha)) {
+        int id;
+        try {
+            id = std::stoi(linha);
+        } catch (const std::exception&) {
+            continue; // linha vazia ou cabeçalho
+        }
+        ScopedTimer tTotal(tempos.total);
+        int blocosLidos = 0;
+        Particao& p = *particoes[particaoDoId(id)];
+        Artigo resultado = buscar(p.arquivoHash, p.bloom, id, blocosLidos, tempos);
+        {
+            ScopedTimer tSaida(tempos.output);
+            imprimirArtigoCompleto(resultado);
+        }
+        consultas++;
+        if (resultado.ocupado) encontrados++;
+        blocosTotais += blocosLidos;
+    }
+
+    std::cout << "\n=== LOTE ===" << std::endl;
+    std::cout << "Consultas: " << consultas << " (encontradas: " << encontrados << ")" << std::endl;
+    if (consultas > 0) {
+        std::cout << "Media de blocos lidos por consulta: " << static_cast<double>(blocosTotais) / consultas << std::endl;
+    }
+    tempos.printSummary(std::cout);
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        std::cerr << "Uso: ./findrec <ID_do_artigo>" << std::endl;
+    bool lote = argc == 3 && std::string(argv[1]) == "--batch";
+    if (argc != 2 && !lote) {
+        std::cerr << "Uso: ./findrec <ID_do_artigo> | ./findrec --batch <ARQUIVO_IDS|->" << std::endl;
         return 1;
     }
 
-    const int TAMANHO_TABELA = 100000; // mesmo tamanho de tabela do upload
+    QueryTimings tempos = QueryTimings::forTool("findrec");
+
+    if (lote) {
+        startMetricsServerFromEnv();
+        std::vector<std::unique_ptr<Particao>> particoes;
+        for (int k = 0; k < numParticoes(); ++k) particoes.emplace_back(new Particao(caminhosDaParticao(k)));
+        return executarLote(particoes, argv[2], tempos);
+    }
     
     try {
         int id_para_buscar = std::stoi(argv[1]);
         
-        HashingFile arquivoHash(ARTIGO_DAT, TAMANHO_TABELA);  
+        Particao p(caminhosDaParticao(particaoDoId(id_para_buscar)));
+        HashingFile& arquivoHash = p.arquivoHash;
         
         int blocosLidos = 0;
-        Artigo resultado = arquivoHash.buscarPorId(id_para_buscar, blocosLidos);
+        Artigo resultado = buscar(arquivoHash, p.bloom, id_para_buscar, blocosLidos, tempos);
         
         imprimirArtigoCompleto(resultado);
 
         std::cout << "\n----------------------------------------" << std::endl;
         std::cout << "Blocos lidos para encontrar o registro: " << blocosLidos << std::endl;
         std::cout << "Quantidade total de blocos do arquivo de dados: " << arquivoHash.getTotalBlocos() << std::endl;
+        std::cout << "Tempo (tabela hash + cadeia): " << (tempos.index.sum() + tempos.fetch.sum()) / 1e6 << "ms" << std::endl;
 
     } catch (const std::exception& e) {
         std::cerr << "Erro: O ID informado nao e um numero valido ou o arquivo de dados nao existe." << std::endl;
@@ -49,4 +130,4 @@ int main(int argc, char* argv[]) {
     }
 
     return 0;
-}
\ No newline at end of file
+}
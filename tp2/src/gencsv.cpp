@@ -0,0 +1,362 @@
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Gerador de artigo.csv sintético para testes de escala. Produz linhas no
+// formato que o upload espera (7 campos entre aspas separados por ';'):
+//   "id";"titulo";"ano";"autores";"citacoes";"atualizacao";"snippet"
+// A saída é determinística para uma mesma semente e é escrita em blocos
+// grandes, sem alocação por linha.
+
+// xoshiro256** com semente via splitmix64: mesmo fluxo em qualquer
+// plataforma (as distribuições da std não garantem isso)
+class Rng {
+public:
+    explicit Rng(std::uint64_t semente) {
+        for (auto& v : s) {
+            semente += 0x9E3779B97F4A7C15ull;
+            std::uint64_t z = semente;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            v = z ^ (z >> 31);
+        }
+    }
+
+    std::uint64_t next() {
+        std::uint64_t result = rotl(s[1] * 5, 7) * 9;
+        std::uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // inteiro em [lo, hi]
+    long entre(long lo, long hi) {
+        return lo + static_cast<long>(next() % static_cast<std::uint64_t>(hi - lo + 1));
+    }
+
+    // real em [0, 1)
+    double real() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    bool chance(double p) { return real() < p; }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+    std::uint64_t s[4];
+};
+
+// Distribuição de comprimentos: "fixa", "uniforme", "geometrica" ou "normal", com média
+struct DistComprimento {
+    std::string tipo = "uniforme";
+    double media = 1;
+
+    long sortear(Rng& rng) const {
+        if (tipo == "fixa") return std::lround(media);
+        if (tipo == "geometrica") {
+            double p = 1.0 / std::max(1.0, media);
+            return 1 + static_cast<long>(std::log(1.0 - rng.real()) / std::log(1.0 - std::min(p, 0.999999)));
+        }
+        if (tipo == "normal") {
+            // Box-Muller, desvio de um terço da média
+            double u1 = rng.real() + 1e-12, u2 = rng.real();
+            double z = std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+            return std::max(0L, std::lround(media + z * media / 3.0));
+        }
+        return rng.entre(0, std::max(0L, std::lround(2 * media)));
+    }
+};
+
+static bool lerDist(const std::string& texto, DistComprimento& dist) {
+    std::size_t sep = texto.find(':');
+    if (sep == std::string::npos) return false;
+    dist.tipo = texto.substr(0, sep);
+    if (dist.tipo != "fixa" && dist.tipo != "uniforme" && dist.tipo != "geometrica" && dist.tipo != "normal") return false;
+    try {
+        dist.media = std::stod(texto.substr(sep + 1));
+    } catch (const std::exception&) {
+        return false;
+    }
+    return dist.media >= 0;
+}
+
+struct GenConfig {
+    long linhas = 1000000;
+    std::string ids = "dense";    // dense, sparse, clustered
+    long passo = 10;              // sparse: distância média entre IDs
+    long cluster = 1000;          // clustered: IDs consecutivos por cluster
+    long espacoCluster = 100;     // clustered: fator entre o início de clusters
+    double dupTitulo = 0.01;      // probabilidade de repetir um título já gerado
+    double colisao = 0.0;         // probabilidade do ID cair em um bucket "quente"
+    long bucketsQuentes = 16;
+    long tabela = 100000;         // mesmo TAMANHO_TABELA do upload
+    double snippetNulo = 0.05;
+    DistComprimento autores{"geometrica", 3};
+    DistComprimento snippet{"normal", 400};
+    std::uint64_t semente = 42;
+    std::string saida;            // vazio = stdout
+};
+
+// Saída com buffer grande; cada linha é montada direto no buffer
+class Saida {
+public:
+    explicit Saida(std::FILE* f) : f(f), buf(1 << 22), pos(0) {}
+    ~Saida() { flush(); }
+
+    void garantir(std::size_t n) {
+        if (pos + n > buf.size()) flush();
+    }
+    void put(char c) { buf[pos++] = c; }
+    void put(const char* s, std::size_t n) {
+        std::memcpy(&buf[pos], s, n);
+        pos += n;
+    }
+    void putNum(long v) {
+        char tmp[24];
+        int n = 0;
+        bool negativo = v < 0;
+        unsigned long u = negativo ? 0UL - static_cast<unsigned long>(v) : static_cast<unsigned long>(v);
+        do {
+            tmp[n++] = static_cast<char>('0' + u % 10);
+            u /= 10;
+        } while (u);
+        if (negativo) put('-');
+        while (n) put(tmp[--n]);
+    }
+    // inteiro com zeros à esquerda (datas)
+    void putFixo(long v, int digitos) {
+        for (int d = digitos - 1; d >= 0; --d) {
+            long p = 1;
+            for (int k = 0; k < d; ++k) p *= 10;
+            put(static_cast<char>('0' + (v / p) % 10));
+        }
+    }
+    void flush() {
+        if (pos) std::fwrite(buf.data(), 1, pos, f);
+        pos = 0;
+    }
+
+private:
+    std::FILE* f;
+    std::vector<char> buf;
+    std::size_t pos;
+};
+
+// vocabulário sintético: sílabas combinadas em palavras sem ';', '"' ou quebras
+static std::vector<std::string> gerarVocabulario(Rng& rng, std::size_t tamanho) {
+    static const char* silabas[] = {"da", "ta", "ba", "se", "mo", "rin", "lu", "ca", "ne", "tro", "pi", "vel",
+                                     "gra", "fo", "qui", "dor", "mes", "la", "ri", "zen", "cor", "ma", "ti", "po"};
+    const std::size_t nSil = sizeof(silabas) / sizeof(silabas[0]);
+    std::vector<std::string> vocab;
+    vocab.reserve(tamanho);
+    for (std::size_t i = 0; i < tamanho; ++i) {
+        std::string w;
+        long n = rng.entre(2, 4);
+        for (long k = 0; k < n; ++k) w += silabas[rng.next() % nSil];
+        vocab.push_back(w);
+    }
+    return vocab;
+}
+
+// Escreve até 'limite' bytes de palavras do vocabulário separadas por espaço
+static std::size_t escreverTexto(Saida& out, Rng& rng, const std::vector<std::string>& vocab, long alvo, long limite) {
+    std::size_t escritos = 0;
+    while (static_cast<long>(escritos) < alvo) {
+        const std::string& w = vocab[rng.next() % vocab.size()];
+        std::size_t extra = w.size() + (escritos ? 1 : 0);
+        if (static_cast<long>(escritos + extra) > limite) break;
+        if (escritos) out.put(' ');
+        out.put(w.data(), w.size());
+        escritos += extra;
+    }
+    return escritos;
+}
+
+// IDs "normais" crescentes com limite superior conhecido, para que os IDs
+// forçados a colidir (acima desse limite) nunca repitam um ID normal
+static long idNormal(const GenConfig& cfg, long i, Rng& rng) {
+    if (cfg.ids == "sparse") return i * cfg.passo + 1 + rng.entre(0, cfg.passo - 1);
+    if (cfg.ids == "clustered") return (i / cfg.cluster) * cfg.cluster * cfg.espacoCluster + (i % cfg.cluster) + 1;
+    return i + 1;
+}
+
+static long limiteIdsNormais(const GenConfig& cfg) {
+    if (cfg.ids == "sparse") return cfg.linhas * cfg.passo;
+    if (cfg.ids == "clustered") return ((cfg.linhas - 1) / cfg.cluster + 1) * cfg.cluster * cfg.espacoCluster;
+    return cfg.linhas;
+}
+
+static void uso(const char* prog) {
+    std::cerr << "Uso: " << prog << " [opcoes]\n"
+              << "  --linhas N                 numero de linhas (padrao 1000000)\n"
+              << "  --ids dense|sparse|clustered\n"
+              << "  --passo N                  sparse: distancia media entre IDs (padrao 10)\n"
+              << "  --cluster N                clustered: IDs consecutivos por cluster (padrao 1000)\n"
+              << "  --espaco-cluster N         clustered: fator de espacamento entre clusters (padrao 100)\n"
+              << "  --dup-titulo P             probabilidade de repetir um titulo (padrao 0.01)\n"
+              << "  --colisao P                probabilidade do ID cair em um bucket quente (padrao 0)\n"
+              << "  --buckets-quentes N        quantidade de buckets quentes (padrao 16)\n"
+              << "  --tabela N                 tamanho da tabela hash alvo (padrao 100000)\n"
+              << "  --autores DIST:MEDIA       autores por artigo: fixa|uniforme|geometrica|normal (padrao geometrica:3)\n"
+              << "  --snippet DIST:MEDIA       tamanho do snippet em bytes (padrao normal:400)\n"
+              << "  --snippet-nulo P           probabilidade de snippet NULL (padrao 0.05)\n"
+              << "  --semente S                semente (padrao 42)\n"
+              << "  --saida ARQUIVO            destino (padrao stdout)\n";
+}
+
+int main(int argc, char* argv[]) {
+    GenConfig cfg;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            uso(argv[0]);
+            return 1;
+        }
+        std::string v = argv[++i];
+        try {
+            if (arg == "--linhas") cfg.linhas = std::stol(v);
+            else if (arg == "--ids") cfg.ids = v;
+            else if (arg == "--passo") cfg.passo = std::stol(v);
+            else if (arg == "--cluster") cfg.cluster = std::stol(v);
+            else if (arg == "--espaco-cluster") cfg.espacoCluster = std::stol(v);
+            else if (arg == "--dup-titulo") cfg.dupTitulo = std::stod(v);
+            else if (arg == "--colisao") cfg.colisao = std::stod(v);
+            else if (arg == "--buckets-quentes") cfg.bucketsQuentes = std::stol(v);
+            else if (arg == "--tabela") cfg.tabela = std::stol(v);
+            else if (arg == "--snippet-nulo") cfg.snippetNulo = std::stod(v);
+            else if (arg == "--semente") cfg.semente = std::stoull(v);
+            else if (arg == "--saida") cfg.saida = v;
+            else if (arg == "--autores") {
+                if (!lerDist(v, cfg.autores)) throw std::invalid_argument(v);
+            } else if (arg == "--snippet") {
+                if (!lerDist(v, cfg.snippet)) throw std::invalid_argument(v);
+            } else {
+                uso(argv[0]);
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Valor invalido para " << arg << ": " << v << std::endl;
+            return 1;
+        }
+    }
+
+    if (cfg.ids != "dense" && cfg.ids != "sparse" && cfg.ids != "clustered") {
+        std::cerr << "--ids deve ser dense, sparse ou clustered" << std::endl;
+        return 1;
+    }
+    if (cfg.linhas < 0 || cfg.passo < 1 || cfg.cluster < 1 || cfg.espacoCluster < 1
+        || cfg.tabela < 1 || cfg.bucketsQuentes < 1 || cfg.bucketsQuentes > cfg.tabela) {
+        std::cerr << "Parametros numericos invalidos." << std::endl;
+        return 1;
+    }
+    long limite = limiteIdsNormais(cfg);
+    if (limite > INT_MAX) {
+        std::cerr << "Os IDs nao cabem em int (limite " << limite << "). Reduza --linhas ou o espacamento." << std::endl;
+        return 1;
+    }
+
+    std::FILE* f = cfg.saida.empty() ? stdout : std::fopen(cfg.saida.c_str(), "wb");
+    if (!f) {
+        std::cerr << "Erro: nao foi possivel criar '" << cfg.saida << "'" << std::endl;
+        return 1;
+    }
+
+    Rng rng(cfg.semente);
+    std::vector<std::string> palavras = gerarVocabulario(rng, 4096);
+    std::vector<std::string> nomes = gerarVocabulario(rng, 1024);
+
+    // buckets quentes e o próximo múltiplo livre (acima dos IDs normais) de cada um
+    std::vector<long> quentes(cfg.bucketsQuentes);
+    std::vector<long> proximoMultiplo(cfg.bucketsQuentes, limite / cfg.tabela + 1);
+    for (auto& b : quentes) b = rng.entre(0, cfg.tabela - 1);
+    bool avisouEstouro = false;
+
+    // títulos recentes para duplicação (anel)
+    const std::size_t ANEL = 4096;
+    std::vector<std::string> recentes;
+    recentes.reserve(ANEL);
+    std::string titulo;
+
+    Saida out(f);
+    for (long i = 0; i < cfg.linhas; ++i) {
+        long id = idNormal(cfg, i, rng);
+        if (cfg.colisao > 0 && rng.chance(cfg.colisao)) {
+            std::size_t q = static_cast<std::size_t>(rng.next() % quentes.size());
+            long candidato = quentes[q] + proximoMultiplo[q] * cfg.tabela;
+            if (candidato <= INT_MAX) {
+                id = candidato;
+                proximoMultiplo[q]++;
+            } else if (!avisouEstouro) {
+                std::cerr << "[AVISO] bucket quente sem IDs livres em int; usando IDs normais" << std::endl;
+                avisouEstouro = true;
+            }
+        }
+
+        if (!recentes.empty() && rng.chance(cfg.dupTitulo)) {
+            titulo = recentes[rng.next() % recentes.size()];
+        } else {
+            titulo.clear();
+            long nPalavras = rng.entre(3, 14);
+            for (long k = 0; k < nPalavras && titulo.size() < 280; ++k) {
+                if (k) titulo += ' ';
+                titulo += palavras[rng.next() % palavras.size()];
+            }
+            if (titulo.size() > 300) titulo.resize(300);
+            if (recentes.size() < ANEL) recentes.push_back(titulo);
+            else recentes[rng.next() % ANEL] = titulo;
+        }
+
+        // pior caso da linha: campos limitados ao tamanho das colunas + aspas/separadores
+        out.garantir(1600);
+        out.put('"'); out.putNum(id); out.put("\";\"", 3);
+        out.put(titulo.data(), titulo.size()); out.put("\";\"", 3);
+        out.putNum(rng.entre(1950, 2025)); out.put("\";\"", 3);
+
+        long nAutores = std::max(1L, cfg.autores.sortear(rng));
+        std::size_t usados = 0;
+        for (long a = 0; a < nAutores; ++a) {
+            const std::string& nome = nomes[rng.next() % nomes.size()];
+            const std::string& sobrenome = nomes[rng.next() % nomes.size()];
+            std::size_t extra = nome.size() + 1 + sobrenome.size() + (a ? 1 : 0);
+            if (usados + extra > 150) break;
+            if (a) out.put('|');
+            out.put(nome.data(), nome.size());
+            out.put(' ');
+            out.put(sobrenome.data(), sobrenome.size());
+            usados += extra;
+        }
+        out.put("\";\"", 3);
+
+        // citações com cauda longa (poucos artigos muito citados)
+        out.putNum(static_cast<long>(std::pow(rng.real(), 4.0) * 5000)); out.put("\";\"", 3);
+
+        out.putFixo(rng.entre(2000, 2025), 4); out.put('-');
+        out.putFixo(rng.entre(1, 12), 2); out.put('-');
+        out.putFixo(rng.entre(1, 28), 2); out.put(' ');
+        out.putFixo(rng.entre(0, 23), 2); out.put(':');
+        out.putFixo(rng.entre(0, 59), 2); out.put(':');
+        out.putFixo(rng.entre(0, 59), 2);
+        out.put("\";", 2);
+
+        if (rng.chance(cfg.snippetNulo)) {
+            out.put("NULL", 4);
+        } else {
+            out.put('"');
+            escreverTexto(out, rng, palavras, std::min(1024L, cfg.snippet.sortear(rng)), 1024);
+            out.put('"');
+        }
+        out.put('\n');
+    }
+    out.flush();
+
+    if (f != stdout) std::fclose(f);
+    return 0;
+}
@@ -1,10 +1,13 @@
 #include "../include/hashing_file.h"
 #include "../include/config.h" 
+#include "../include/metrics.h"
+#include <algorithm>
 #include <iostream>
 #include <vector>
+#include <cstdio>
 
-HashingFile::HashingFile(const std::string& filename, int table_size)
-    : nomeArquivo(filename), TAMANHO_TABELA(table_size) {
+HashingFile::HashingFile(const std::string& filename, int table_size, const std::string& tabela)
+    : nomeArquivo(filename), nomeTabela(tabela), TAMANHO_TABELA(table_size) {
     arquivo.open(nomeArquivo, std::ios::in | std::ios::out | std::ios::binary);
     if (!arquivo.is_open()) {
         std::cerr << "AVISO: Arquivo de dados '" << nomeArquivo << "' nao encontrado." << std::endl;
@@ -12,6 +15,7 @@ HashingFile::HashingFile(const std::string& filename, int table_size)
 }
 
 HashingFile::~HashingFile() {
+    terminarCarga();
     if (arquivo.is_open()) {
         arquivo.close();
     }
@@ -22,39 +26,64 @@ void HashingFile::criarArquivos() {
     dataFile.close();
     std::cout << "Arquivo '" << nomeArquivo << "' criado." << std::endl;
 
-    std::string nomeTabela = TABELA_HASH;  
     std::ofstream tabela(nomeTabela, std::ios::out | std::ios::binary);
     if (tabela.is_open()) {
         long offset_vazio = -1;
         for (int i = 0; i < TAMANHO_TABELA; ++i) {
             tabela.write(reinterpret_cast<const char*>(&offset_vazio), sizeof(long));
         }
+        tabela.write(reinterpret_cast<const char*>(&offset_vazio), sizeof(long)); // lista livre
         tabela.close();
         std::cout << "Arquivo de indice '" << nomeTabela << "' criado com " << TAMANHO_TABELA << " posicoes." << std::endl;
     }
 }
 
-long HashingFile::inserirArtigo(Artigo& novoArtigo) {
-    if (!arquivo.is_open()) {
-        criarArquivos();
-        arquivo.open(nomeArquivo, std::ios::in | std::ios::out | std::ios::binary);
-        if(!arquivo.is_open()){
-             std::cerr << "Erro: Nao foi possivel abrir o arquivo de dados para insercao." << std::endl;
-             return -1;
-        }
+bool HashingFile::abrirOuCriar() {
+    if (arquivo.is_open()) return true;
+    criarArquivos();
+    arquivo.open(nomeArquivo, std::ios::in | std::ios::out | std::ios::binary);
+    if(!arquivo.is_open()){
+         std::cerr << "Erro: Nao foi possivel abrir o arquivo de dados para insercao." << std::endl;
+         return false;
     }
+    return true;
+}
+
+long HashingFile::lerCabeca(std::fstream& tabela, int endereco) {
+    if (emCarga()) return tabelaCarga[endereco];
+    long offset = -1;
+    tabela.seekg(endereco * sizeof(long));
+    tabela.read(reinterpret_cast<char*>(&offset), sizeof(long));
+    StorageMetrics::get().hashTableReads.inc();
+    return offset;
+}
+
+void HashingFile::gravarCabeca(std::fstream& tabela, int endereco, long offset) {
+    if (emCarga()) {
+        tabelaCarga[endereco] = offset;
+        tabelaCargaAlterada = true;
+        return;
+    }
+    tabela.seekp(endereco * sizeof(long));
+    tabela.write(reinterpret_cast<const char*>(&offset), sizeof(long));
+    StorageMetrics::get().hashTableWrites.inc();
+}
+
+long HashingFile::inserirArtigo(Artigo& novoArtigo) {
+    if (!abrirOuCriar()) return -1;
 
     int endereco = novoArtigo.id % TAMANHO_TABELA;
-    std::string nomeTabela = TABELA_HASH; 
-    std::fstream tabela(nomeTabela, std::ios::in | std::ios::out | std::ios::binary);
-    if (!tabela.is_open()) {
-        std::cerr << "Erro: Nao foi possivel abrir o arquivo de indice '" << nomeTabela << "'." << std::endl;
-        return -1;
+    std::fstream tabela;
+    if (!emCarga()) {
+        tabela.open(nomeTabela, std::ios::in | std::ios::out | std::ios::binary);
+        if (!tabela.is_open()) {
+            std::cerr << "Erro: Nao foi possivel abrir o arquivo de indice '" << nomeTabela << "'." << std::endl;
+            return -1;
+        }
     }
 
-    long offset_inicio_cadeia;
-    tabela.seekg(endereco * sizeof(long));
-    tabela.read(reinterpret_cast<char*>(&offset_inicio_cadeia), sizeof(long));
+    long rid = -1;
+    long offset_inicio_cadeia = lerCabeca(tabela, endereco);
 
     if (offset_inicio_cadeia == -1) {
         // cadeia vazia, criamos um novo bloco
@@ -63,26 +92,24 @@ long HashingFile::inserirArtigo(Artigo& novoArtigo) {
         novo_bloco.num_registros_usados = 1;
         novo_bloco.proximo_bloco_offset = -1;
 
-        arquivo.seekg(0, std::ios::end);
-        long nova_posicao_bloco = arquivo.tellg();
-        arquivo.write(reinterpret_cast<const char*>(&novo_bloco), sizeof(Bloco));
+        long nova_posicao_bloco = alocarBloco(tabela);
+        gravarBloco(nova_posicao_bloco, novo_bloco);
 
         // atualiza tabela
-        tabela.seekp(endereco * sizeof(long));
-        tabela.write(reinterpret_cast<const char*>(&nova_posicao_bloco), sizeof(long));
+        gravarCabeca(tabela, endereco, nova_posicao_bloco);
+        rid = calcularRid(nova_posicao_bloco, 0);
     } else {
         // cadeia já existe, procura por um espaço livre
         long offset_bloco_atual = offset_inicio_cadeia;
         Bloco bloco_temp;
         while (true) {
-            arquivo.seekg(offset_bloco_atual);
-            arquivo.read(reinterpret_cast<char*>(&bloco_temp), sizeof(Bloco));
+            if (!lerBloco(offset_bloco_atual, bloco_temp)) break;
 
             if (bloco_temp.num_registros_usados < REGISTROS_POR_BLOCO) {
+                rid = calcularRid(offset_bloco_atual, bloco_temp.num_registros_usados);
                 bloco_temp.artigos[bloco_temp.num_registros_usados] = novoArtigo;
                 bloco_temp.num_registros_usados++;
-                arquivo.seekp(offset_bloco_atual);
-                arquivo.write(reinterpret_cast<const char*>(&bloco_temp), sizeof(Bloco));
+                gravarBloco(offset_bloco_atual, bloco_temp);
                 break;
             } else if (bloco_temp.proximo_bloco_offset == -1) {
                 // bloco está cheio e é o último da cadeia, cria um novo bloco de overflow
@@ -91,43 +118,512 @@ long HashingFile::inserirArtigo(Artigo& novoArtigo) {
                 novo_bloco_overflow.num_registros_usados = 1;
                 novo_bloco_overflow.proximo_bloco_offset = -1;
 
-                arquivo.seekg(0, std::ios::end);
-                long nova_posicao_bloco_overflow = arquivo.tellg();
-                arquivo.write(reinterpret_cast<const char*>(&novo_bloco_overflow), sizeof(Bloco));
+                long nova_posicao_bloco_overflow = alocarBloco(tabela);
+                StorageMetrics::get().hashOverflowBlocks.inc();
+                gravarBloco(nova_posicao_bloco_overflow, novo_bloco_overflow);
+                rid = calcularRid(nova_posicao_bloco_overflow, 0);
 
                 // atualizamos o bloco anterior
                 bloco_temp.proximo_bloco_offset = nova_posicao_bloco_overflow;
-                arquivo.seekp(offset_bloco_atual);
-                arquivo.write(reinterpret_cast<const char*>(&bloco_temp), sizeof(Bloco));
+                gravarBloco(offset_bloco_atual, bloco_temp);
                 break;
             } else {
                 // bloco cheio
                 offset_bloco_atual = bloco_temp.proximo_bloco_offset;
+                StorageMetrics::get().hashChainHops.inc();
             }
         }
     }
     tabela.close();
-    return 0;
+    if (rid != -1) StorageMetrics::get().hashInserts.inc();
+    return rid;
 }
 
-Artigo HashingFile::buscarPorId(int id, int& blocosLidos) {
-    blocosLidos = 0;
-    if (!arquivo.is_open()) return {};
+long HashingFile::atualizarArtigo(const Artigo& artigo, Artigo* anterior) {
+    if (!arquivo.is_open()) return -1;
+
+    int endereco = artigo.id % TAMANHO_TABELA;
+    std::fstream tabela;
+    if (!emCarga()) {
+        tabela.open(nomeTabela, std::ios::in | std::ios::binary);
+        if (!tabela.is_open()) return -1;
+    }
+    long offset_bloco_atual = lerCabeca(tabela, endereco);
+    tabela.close();
+
+    // percorre a cadeia do bucket e sobrescreve o registro no mesmo lugar (o RID nao muda)
+    while (offset_bloco_atual != -1) {
+        Bloco bloco_temp;
+        if (!lerBloco(offset_bloco_atual, bloco_temp)) return -1;
+
+        for (int i = 0; i < bloco_temp.num_registros_usados; ++i) {
+            if (bloco_temp.artigos[i].ocupado && bloco_temp.artigos[i].id == artigo.id) {
+                if (anterior) *anterior = bloco_temp.artigos[i];
+                bloco_temp.artigos[i] = artigo;
+                gravarBloco(offset_bloco_atual, bloco_temp);
+                StorageMetrics::get().hashUpdates.inc();
+                return calcularRid(offset_bloco_atual, i);
+            }
+        }
+        offset_bloco_atual = bloco_temp.proximo_bloco_offset;
+    }
+    return -1;
+}
+
+bool HashingFile::compactar(std::vector<long>& novoRid) {
+    if (!arquivo.is_open() || !terminarCarga()) return false;
+
+    std::ifstream tabela(nomeTabela, std::ios::binary);
+    if (!tabela.is_open()) return false;
+    std::vector<long> cabecas(TAMANHO_TABELA, -1);
+    tabela.read(reinterpret_cast<char*>(cabecas.data()), static_cast<std::streamsize>(TAMANHO_TABELA * sizeof(long)));
+    tabela.close();
+
+    long totalBlocos = getTotalBlocos();
+    novoRid.assign(static_cast<std::size_t>(totalBlocos) * REGISTROS_POR_BLOCO, -1);
+
+    // escreve ao lado e troca no final, assim leitores nunca veem um arquivo pela metade
+    std::string nomeNovo = nomeArquivo + ".compact";
+    std::ofstream novo(nomeNovo, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!novo.is_open()) {
+        std::cerr << "Erro: Nao foi possivel criar '" << nomeNovo << "'." << std::endl;
+        return false;
+    }
+
+    long offset_escrita = 0;
+    std::vector<Artigo> registros;
+    for (int endereco = 0; endereco < TAMANHO_TABELA; ++endereco) {
+        registros.clear();
+        std::vector<long> ridsAntigos;
+        long offset_bloco_atual = cabecas[endereco];
+        while (offset_bloco_atual != -1) {
+            Bloco bloco_temp;
+            // um bloco corrompido aborta a reescrita: o arquivo atual fica como está
+            if (!lerBloco(offset_bloco_atual, bloco_temp)) {
+                novo.close();
+                std::remove(nomeNovo.c_str());
+                return false;
+            }
+            for (int i = 0; i < bloco_temp.num_registros_usados; ++i) {
+                if (!bloco_temp.artigos[i].ocupado) continue;
+                registros.push_back(bloco_temp.artigos[i]);
+                ridsAntigos.push_back(calcularRid(offset_bloco_atual, i));
+            }
+            offset_bloco_atual = bloco_temp.proximo_bloco_offset;
+        }
+
+        if (registros.empty()) {
+            cabecas[endereco] = -1;
+            continue;
+        }
+
+        // a cadeia vira uma sequência de blocos cheios e adjacentes
+        cabecas[endereco] = offset_escrita;
+        for (std::size_t r = 0; r < registros.size(); r += REGISTROS_POR_BLOCO) {
+            Bloco bloco = {};
+            for (int i = 0; i < REGISTROS_POR_BLOCO && r + i < registros.size(); ++i) {
+                bloco.artigos[i] = registros[r + i];
+                bloco.num_registros_usados++;
+                novoRid[ridsAntigos[r + i]] = calcularRid(offset_escrita, i);
+            }
+            bool ultimo = r + REGISTROS_POR_BLOCO >= registros.size();
+            bloco.proximo_bloco_offset = ultimo ? -1 : offset_escrita + static_cast<long>(sizeof(Bloco));
+            selarBloco(bloco);
+            novo.write(reinterpret_cast<const char*>(&bloco), sizeof(Bloco));
+            offset_escrita += sizeof(Bloco);
+        }
+    }
+    novo.close();
+    return substituirArquivos(nomeNovo, cabecas);
+}
+
+bool HashingFile::clusterizar(const std::function<long long(const Artigo&)>& chave, std::vector<long>& novoRid) {
+    if (!arquivo.is_open() || !terminarCarga()) return false;
+
+    struct Entrada {
+        long long chave;
+        long rid;
+        int endereco;
+    };
+    long totalBlocos = getTotalBlocos();
+    novoRid.assign(static_cast<std::size_t>(totalBlocos) * REGISTROS_POR_BLOCO, -1);
+    std::vector<Entrada> entradas;
+    for (long b = 0; b < totalBlocos; ++b) {
+        long offset = b * static_cast<long>(sizeof(Bloco));
+        Bloco bloco_temp;
+        if (!lerBloco(offset, bloco_temp)) return false;
+        for (int i = 0; i < bloco_temp.num_registros_usados; ++i) {
+            const Artigo& art = bloco_temp.artigos[i];
+            if (!art.ocupado) continue;
+            entradas.push_back({chave(art), calcularRid(offset, i), art.id % TAMANHO_TABELA});
+        }
+    }
+    std::sort(entradas.begin(), entradas.end(), [](const Entrada& a, const Entrada& b) {
+        return a.chave != b.chave ? a.chave < b.chave : a.rid < b.rid;
+    });
+
+    // bloco de cada registro: o anterior, se for do mesmo bucket e tiver vaga
+    std::vector<long> blocoDe(entradas.size());
+    std::vector<int> enderecoDoBloco;
+    int noBloco = REGISTROS_POR_BLOCO;
+    for (std::size_t r = 0; r < entradas.size(); ++r) {
+        if (noBloco == REGISTROS_POR_BLOCO || enderecoDoBloco.back() != entradas[r].endereco) {
+            enderecoDoBloco.push_back(entradas[r].endereco);
+            noBloco = 0;
+        }
+        blocoDe[r] = static_cast<long>(enderecoDoBloco.size()) - 1;
+        novoRid[entradas[r].rid] = blocoDe[r] * REGISTROS_POR_BLOCO + noBloco++;
+    }
+
+    // encadeia os blocos de cada bucket na ordem do arquivo
+    std::vector<long> cabecas(TAMANHO_TABELA, -1);
+    std::vector<long> proximo(enderecoDoBloco.size(), -1);
+    for (std::size_t b = enderecoDoBloco.size(); b-- > 0;) {
+        long& cabeca = cabecas[enderecoDoBloco[b]];
+        proximo[b] = cabeca;
+        cabeca = static_cast<long>(b * sizeof(Bloco));
+    }
+
+    std::string nomeNovo = nomeArquivo + ".cluster";
+    std::ofstream novo(nomeNovo, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!novo.is_open()) {
+        std::cerr << "Erro: Nao foi possivel criar '" << nomeNovo << "'." << std::endl;
+        return false;
+    }
+    Bloco lido;
+    long offsetLido = -1;
+    std::size_t r = 0;
+    for (std::size_t b = 0; b < enderecoDoBloco.size(); ++b) {
+        Bloco bloco = {};
+        for (; r < entradas.size() && blocoDe[r] == static_cast<long>(b); ++r) {
+            long offset = (entradas[r].rid / REGISTROS_POR_BLOCO) * static_cast<long>(sizeof(Bloco));
+            if (offset != offsetLido) {
+                if (!lerBloco(offset, lido)) {
+                    novo.close();
+                    std::remove(nomeNovo.c_str());
+                    return false;
+                }
+                offsetLido = offset;
+            }
+            bloco.artigos[bloco.num_registros_usados++] = lido.artigos[entradas[r].rid % REGISTROS_POR_BLOCO];
+        }
+        bloco.proximo_bloco_offset = proximo[b];
+        selarBloco(bloco);
+        novo.write(reinterpret_cast<const char*>(&bloco), sizeof(Bloco));
+    }
+    novo.close();
+    if (!novo) return false;
+    return substituirArquivos(nomeNovo, cabecas);
+}
+
+bool HashingFile::substituirArquivos(const std::string& dadosNovos, const std::vector<long>& cabecas) {
+    std::string tabelaNova = nomeTabela + ".novo";
+    std::ofstream tabelaOut(tabelaNova, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!tabelaOut.is_open()) {
+        std::cerr << "Erro: Nao foi possivel criar '" << tabelaNova << "'." << std::endl;
+        return false;
+    }
+    long lista_vazia = -1;
+    tabelaOut.write(reinterpret_cast<const char*>(cabecas.data()), static_cast<std::streamsize>(TAMANHO_TABELA * sizeof(long)));
+    tabelaOut.write(reinterpret_cast<const char*>(&lista_vazia), sizeof(long));
+    tabelaOut.close();
+
+    arquivo.close();
+    if (std::rename(dadosNovos.c_str(), nomeArquivo.c_str()) != 0
+        || std::rename(tabelaNova.c_str(), nomeTabela.c_str()) != 0) {
+        std::cerr << "Erro: Nao foi possivel substituir os arquivos reescritos." << std::endl;
+        return false;
+    }
+    arquivo.open(nomeArquivo, std::ios::in | std::ios::out | std::ios::binary);
+    return arquivo.is_open();
+}
+
+long HashingFile::lerListaLivre(std::fstream& tabela) {
+    if (emCarga()) return tabelaCarga[TAMANHO_TABELA];
+    long offset = -1;
+    tabela.seekg(static_cast<long>(TAMANHO_TABELA) * sizeof(long));
+    StorageMetrics::get().hashTableReads.inc();
+    if (!tabela.read(reinterpret_cast<char*>(&offset), sizeof(long))) {
+        // tabela gerada antes da lista livre existir
+        tabela.clear();
+        offset = -1;
+    }
+    return offset;
+}
+
+void HashingFile::gravarListaLivre(std::fstream& tabela, long offset) {
+    if (emCarga()) {
+        tabelaCarga[TAMANHO_TABELA] = offset;
+        tabelaCargaAlterada = true;
+        return;
+    }
+    tabela.seekp(static_cast<long>(TAMANHO_TABELA) * sizeof(long));
+    tabela.write(reinterpret_cast<const char*>(&offset), sizeof(long));
+    StorageMetrics::get().hashTableWrites.inc();
+}
+
+long HashingFile::alocarBloco(std::fstream& tabela) {
+    long livre = lerListaLivre(tabela);
+    if (livre != -1) {
+        Bloco bloco_livre;
+        if (lerBloco(livre, bloco_livre)) {
+            gravarListaLivre(tabela, bloco_livre.proximo_bloco_offset);
+            return livre;
+        }
+        // encadeamento corrompido: a lista livre é descartada
+        gravarListaLivre(tabela, -1);
+    }
+    if (emCarga()) {
+        long offset = fimCarga;
+        fimCarga += sizeof(Bloco);
+        return offset;
+    }
+    arquivo.seekg(0, std::ios::end);
+    return arquivo.tellg();
+}
+
+bool HashingFile::lerBloco(long offset, Bloco& bloco) {
+    if (emCarga()) {
+        auto it = bufferCarga.find(offset);
+        if (it != bufferCarga.end()) {
+            bloco = it->second;
+            StorageMetrics::get().hashBufferHits.inc();
+            return true;
+        }
+    }
+    arquivo.seekg(offset);
+    arquivo.read(reinterpret_cast<char*>(&bloco), sizeof(Bloco));
+    blocosLidosTotal++;
+
+    StorageMetrics& metrics = StorageMetrics::get();
+    metrics.hashBlocksRead.inc();
+    metrics.hashSeeks.inc();
+    metrics.hashBytesRead.inc(sizeof(Bloco));
+    if (!arquivo.good()) {
+        arquivo.clear();
+        return false;
+    }
+    return conferirBloco(bloco, nomeArquivo, static_cast<std::size_t>(offset / static_cast<long>(sizeof(Bloco))));
+}
+
+void HashingFile::gravarBloco(long offset, Bloco& bloco) {
+    if (emCarga()) {
+        // o checksum é calculado na descarga; até lá o bloco pode mudar de novo
+        bufferCarga[offset] = bloco;
+        if (bufferCarga.size() >= capacidadeCarga) descarregarBlocos();
+        return;
+    }
+    selarBloco(bloco);
+    arquivo.seekp(offset);
+    arquivo.write(reinterpret_cast<const char*>(&bloco), sizeof(Bloco));
+    blocosEscritosTotal++;
+
+    StorageMetrics& metrics = StorageMetrics::get();
+    metrics.hashBlocksWritten.inc();
+    metrics.hashWrites.inc();
+    metrics.hashSeeks.inc();
+    metrics.hashBytesWritten.inc(sizeof(Bloco));
+}
+
+bool HashingFile::iniciarCarga(std::size_t capacidadeBlocos) {
+    if (emCarga()) return true;
+    if (!abrirOuCriar()) return false;
+    std::ifstream tabela(nomeTabela, std::ios::binary);
+    if (!tabela.is_open()) {
+        std::cerr << "Erro: Nao foi possivel abrir o arquivo de indice '" << nomeTabela << "'." << std::endl;
+        return false;
+    }
+    // numa tabela gerada antes da lista livre a última entrada não existe e fica -1
+    tabelaCarga.assign(static_cast<std::size_t>(TAMANHO_TABELA) + 1, -1);
+    tabela.read(reinterpret_cast<char*>(tabelaCarga.data()),
+                static_cast<std::streamsize>(tabelaCarga.size() * sizeof(long)));
+    StorageMetrics::get().hashTableReads.inc();
+    tabelaCargaAlterada = false;
+
+    arquivo.seekg(0, std::ios::end);
+    fimCarga = arquivo.tellg();
+    capacidadeCarga = std::max<std::size_t>(capacidadeBlocos, 1);
+    gravadosCarga.clear();
+    return true;
+}
+
+bool HashingFile::descarregarBlocos() {
+    StorageMetrics& metrics = StorageMetrics::get();
+    std::vector<char> sequencia;
+    bool ok = true;
+    for (auto it = bufferCarga.begin(); it != bufferCarga.end();) {
+        const long inicio = it->first;
+        long proximo = inicio;
+        sequencia.clear();
+        for (; it != bufferCarga.end() && it->first == proximo; ++it, proximo += sizeof(Bloco)) {
+            gravadosCarga.push_back(proximo / static_cast<long>(sizeof(Bloco)));
+            selarBloco(it->second);
+            const char* p = reinterpret_cast<const char*>(&it->second);
+            sequencia.insert(sequencia.end(), p, p + sizeof(Bloco));
+        }
+        arquivo.seekp(inicio);
+        arquivo.write(sequencia.data(), static_cast<std::streamsize>(sequencia.size()));
+        ok = ok && arquivo.good();
+
+        long blocos = (proximo - inicio) / static_cast<long>(sizeof(Bloco));
+        blocosEscritosTotal += blocos;
+        metrics.hashBlocksWritten.inc(blocos);
+        metrics.hashWrites.inc();
+        metrics.hashSeeks.inc();
+        metrics.hashBytesWritten.inc(sequencia.size());
+    }
+    bufferCarga.clear();
+    return ok;
+}
+
+bool HashingFile::terminarCarga() {
+    if (!emCarga()) return true;
+    bool ok = descarregarBlocos();
+    if (tabelaCargaAlterada) {
+        std::fstream tabela(nomeTabela, std::ios::in | std::ios::out | std::ios::binary);
+        tabela.write(reinterpret_cast<const char*>(tabelaCarga.data()),
+                     static_cast<std::streamsize>(tabelaCarga.size() * sizeof(long)));
+        StorageMetrics::get().hashTableWrites.inc();
+        ok = ok && tabela.good();
+    }
+    arquivo.flush();
+    StorageMetrics::get().hashFlushes.inc();
+    std::vector<long>().swap(tabelaCarga);
+    if (!ok) std::cerr << "Erro: Nao foi possivel gravar o buffer de carga em '" << nomeArquivo << "'." << std::endl;
+    return ok && arquivo.good();
+}
+
+std::vector<long> HashingFile::blocosGravadosNaCarga() const {
+    std::vector<long> blocos = gravadosCarga;
+    std::sort(blocos.begin(), blocos.end());
+    blocos.erase(std::unique(blocos.begin(), blocos.end()), blocos.end());
+    return blocos;
+}
+
+bool HashingFile::lerPorRid(long rid, Artigo& artigo) {
+    if (!arquivo.is_open() || rid < 0) return false;
+    long offset = (rid / REGISTROS_POR_BLOCO) * static_cast<long>(sizeof(Bloco));
+    int posicao = static_cast<int>(rid % REGISTROS_POR_BLOCO);
+
+    Bloco bloco;
+    if (!lerBloco(offset, bloco)) return false;
+    if (posicao >= bloco.num_registros_usados || !bloco.artigos[posicao].ocupado) return false;
+    artigo = bloco.artigos[posicao];
+    return true;
+}
+
+long HashingFile::calcularRid(long offsetBloco, int posicao) {
+    return (offsetBloco / static_cast<long>(sizeof(Bloco))) * REGISTROS_POR_BLOCO + posicao;
+}
+
+bool HashingFile::removerArtigo(int id, Remocao& resultado) {
+    resultado = {};
+    resultado.rid = -1;
+    if (!arquivo.is_open() || !terminarCarga()) return false;
 
     int endereco = id % TAMANHO_TABELA;
-    std::string nomeTabela = TABELA_HASH;
-    std::fstream tabela(nomeTabela, std::ios::in | std::ios::binary);
-    if (!tabela.is_open()) return {};
+    std::fstream tabela(nomeTabela, std::ios::in | std::ios::out | std::ios::binary);
+    if (!tabela.is_open()) return false;
 
-    long offset_bloco_atual;
+    long offset_inicio_cadeia;
     tabela.seekg(endereco * sizeof(long));
-    tabela.read(reinterpret_cast<char*>(&offset_bloco_atual), sizeof(long));
+    tabela.read(reinterpret_cast<char*>(&offset_inicio_cadeia), sizeof(long));
+    StorageMetrics::get().hashTableReads.inc();
+
+    // percorre a cadeia inteira: a vaga aberta e preenchida pelo ultimo registro do ultimo bloco
+    std::vector<long> cadeia;
+    long offset_alvo = -1;
+    int posicao_alvo = -1;
+    long offset_bloco_atual = offset_inicio_cadeia;
+    Bloco bloco_temp;
+    while (offset_bloco_atual != -1) {
+        if (!lerBloco(offset_bloco_atual, bloco_temp)) return false;
+        cadeia.push_back(offset_bloco_atual);
+
+        for (int i = 0; offset_alvo == -1 && i < bloco_temp.num_registros_usados; ++i) {
+            if (bloco_temp.artigos[i].ocupado && bloco_temp.artigos[i].id == id) {
+                offset_alvo = offset_bloco_atual;
+                posicao_alvo = i;
+            }
+        }
+        offset_bloco_atual = bloco_temp.proximo_bloco_offset;
+    }
+    if (offset_alvo == -1) return false;
+
+    long offset_ultimo = cadeia.back();
+    Bloco ultimo = bloco_temp;
+    int posicao_ultima = ultimo.num_registros_usados - 1;
+
+    resultado.rid = calcularRid(offset_alvo, posicao_alvo);
+    if (offset_alvo == offset_ultimo) {
+        resultado.removido = ultimo.artigos[posicao_alvo];
+        if (posicao_alvo != posicao_ultima) {
+            resultado.houveMovimento = true;
+            resultado.ridOrigem = calcularRid(offset_ultimo, posicao_ultima);
+            resultado.movido = ultimo.artigos[posicao_ultima];
+            ultimo.artigos[posicao_alvo] = resultado.movido;
+        }
+    } else {
+        Bloco alvo;
+        if (!lerBloco(offset_alvo, alvo)) return false;
+        resultado.removido = alvo.artigos[posicao_alvo];
+        resultado.houveMovimento = true;
+        resultado.ridOrigem = calcularRid(offset_ultimo, posicao_ultima);
+        resultado.movido = ultimo.artigos[posicao_ultima];
+        alvo.artigos[posicao_alvo] = resultado.movido;
+        gravarBloco(offset_alvo, alvo);
+    }
+    ultimo.artigos[posicao_ultima] = {};
+    ultimo.num_registros_usados--;
+
+    if (ultimo.num_registros_usados == 0) {
+        // bloco vazio sai da cadeia e vai para a lista livre
+        long fim_cadeia = -1;
+        if (cadeia.size() == 1) {
+            tabela.seekp(endereco * sizeof(long));
+            tabela.write(reinterpret_cast<const char*>(&fim_cadeia), sizeof(long));
+            StorageMetrics::get().hashTableWrites.inc();
+        } else {
+            long offset_anterior = cadeia[cadeia.size() - 2];
+            Bloco anterior;
+            if (!lerBloco(offset_anterior, anterior)) return false;
+            anterior.proximo_bloco_offset = fim_cadeia;
+            gravarBloco(offset_anterior, anterior);
+        }
+        ultimo.proximo_bloco_offset = lerListaLivre(tabela);
+        gravarListaLivre(tabela, offset_ultimo);
+    }
+    gravarBloco(offset_ultimo, ultimo);
+    arquivo.flush();
+    StorageMetrics::get().hashFlushes.inc();
+    StorageMetrics::get().hashRemovals.inc();
+
     tabela.close();
+    return true;
+}
+
+Artigo HashingFile::buscarPorId(int id, int& blocosLidos, const QueryTimings* tempos) {
+    blocosLidos = 0;
+    if (!arquivo.is_open()) return {};
+    StorageMetrics& metrics = StorageMetrics::get();
+    metrics.hashLookups.inc();
+
+    ScopedTimer tTabela(tempos ? &tempos->index : nullptr);
+    int endereco = id % TAMANHO_TABELA;
+    std::fstream tabela;
+    if (!emCarga()) {
+        tabela.open(nomeTabela, std::ios::in | std::ios::binary);
+        if (!tabela.is_open()) return {};
+    }
+    long offset_bloco_atual = lerCabeca(tabela, endereco);
+    tabela.close();
+    tTabela.stop();
+
+    ScopedTimer tCadeia(tempos ? &tempos->fetch : nullptr);
 
     while (offset_bloco_atual != -1) {
         Bloco bloco_temp;
-        arquivo.seekg(offset_bloco_atual);
-        arquivo.read(reinterpret_cast<char*>(&bloco_temp), sizeof(Bloco));
+        if (!lerBloco(offset_bloco_atual, bloco_temp)) break;
         blocosLidos++;
 
         for (int i = 0; i < bloco_temp.num_registros_usados; ++i) {
@@ -136,8 +632,10 @@ Artigo HashingFile::buscarPorId(int id, int& blocosLidos) {
             }
         }
         offset_bloco_atual = bloco_temp.proximo_bloco_offset;
+        if (offset_bloco_atual != -1) metrics.hashChainHops.inc();
     }
 
+    metrics.hashLookupMisses.inc();
     return {};
 }
 
@@ -145,6 +643,7 @@ long HashingFile::getTotalBlocos() {
     if (!arquivo.is_open() || sizeof(Bloco) == 0) {
         return 0;
     }
+    if (emCarga()) return fimCarga / static_cast<long>(sizeof(Bloco));
     arquivo.seekg(0, std::ios::end);
     long tamanho_total_bytes = arquivo.tellg();
     return tamanho_total_bytes / sizeof(Bloco);
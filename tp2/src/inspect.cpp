@@ -0,0 +1,715 @@
+#include "../include/BPlusTree.hpp"
+#include "../include/hashing_file.h"
+#include "../include/projecao.h"
+#include "../include/metrics.h"
+#include "../include/particoes.h"
+#include "../include/config.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Inspeção dos arquivos em disco: cadeias da tabela hash (tabela_hash.idx +
+// artigos.dat) e as B+ trees (primária, secundária e ano/citações). Só lê os
+// arquivos (pread, várias threads por nível da árvore ou faixa de buckets),
+// valida os invariantes da estrutura e imprime um relatório em JSON com
+// histogramas, para acompanhar a saúde dos índices entre cargas.
+
+using No = BPlusTree<long>::BPlusTreeNode;
+
+static const std::size_t MAX_EXEMPLOS = 20;
+
+static bool lerTudo(int fd, char* destino, std::size_t n, off_t offset) {
+    while (n > 0) {
+        ssize_t r = pread(fd, destino, n, offset);
+        if (r <= 0) return false;
+        destino += r;
+        n -= static_cast<std::size_t>(r);
+        offset += r;
+    }
+    return true;
+}
+
+// Violações de invariantes: todas são contadas, as primeiras vão para o relatório
+class Problemas {
+public:
+    void registrar(const std::string& mensagem) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        total_++;
+        if (exemplos_.size() < MAX_EXEMPLOS) exemplos_.push_back(mensagem);
+    }
+    std::size_t total() const { return total_; }
+    const std::vector<std::string>& exemplos() const { return exemplos_; }
+
+private:
+    std::mutex mutex_;
+    std::size_t total_ = 0;
+    std::vector<std::string> exemplos_;
+};
+
+struct Histograma {
+    std::vector<std::string> rotulos;
+    std::vector<std::uint64_t> contagens;
+
+    explicit Histograma(std::vector<std::string> r) : rotulos(std::move(r)), contagens(rotulos.size(), 0) {}
+    void somar(const Histograma& outro) {
+        for (std::size_t i = 0; i < contagens.size(); ++i) contagens[i] += outro.contagens[i];
+    }
+};
+
+// 0, 1, ..., 15 e "16+"
+static std::vector<std::string> rotulosComprimento() {
+    std::vector<std::string> r;
+    for (int i = 0; i < 16; ++i) r.push_back(std::to_string(i));
+    r.push_back("16+");
+    return r;
+}
+static std::size_t faixaComprimento(std::size_t n) { return std::min<std::size_t>(n, 16); }
+
+static std::vector<std::string> rotulosOcupacao() {
+    std::vector<std::string> r;
+    for (int i = 0; i < 10; ++i) r.push_back(std::to_string(i * 10) + "-" + std::to_string(i * 10 + 10) + "%");
+    return r;
+}
+static std::size_t faixaOcupacao(int usados, int capacidade) {
+    return std::min<std::size_t>(9, static_cast<std::size_t>(usados) * 10 / static_cast<std::size_t>(capacidade));
+}
+
+// Distância entre páginas/blocos visitados em sequência (cadeia de folhas ou
+// de overflow), em unidades de página/bloco
+static std::vector<std::string> rotulosDistancia() {
+    return {"adjacente", "ate_8", "ate_64", "ate_512", "mais_de_512", "para_tras"};
+}
+static std::size_t faixaDistancia(long delta) {
+    if (delta == 1) return 0;
+    if (delta <= 0) return 5;
+    if (delta <= 8) return 1;
+    if (delta <= 64) return 2;
+    if (delta <= 512) return 3;
+    return 4;
+}
+
+// Divide [0, n) em fatias contíguas, uma por thread; fn(fatia, inicio, fim)
+template <typename F>
+static void emParalelo(std::size_t n, unsigned threads, F fn) {
+    std::size_t fatias = std::max<std::size_t>(1, std::min<std::size_t>(threads, n));
+    std::vector<std::thread> pool;
+    for (std::size_t f = 1; f < fatias; ++f) {
+        pool.emplace_back(fn, f, n * f / fatias, n * (f + 1) / fatias);
+    }
+    fn(0, 0, n / fatias);
+    for (std::thread& t : pool) t.join();
+}
+
+// ===== tabela hash + artigos.dat =====
+
+struct RelatorioHash {
+    bool presente = false;
+    std::size_t tamanhoTabela = 0;
+    std::size_t totalBlocos = 0;
+    std::size_t bucketsUsados = 0;
+    std::size_t registros = 0;
+    std::size_t blocosEmCadeias = 0;
+    std::size_t blocosLivres = 0;
+    std::size_t blocosOrfaos = 0;
+    std::size_t maiorCadeia = 0;
+    std::uint64_t saltos = 0;
+    std::size_t blocosSemChecksum = 0;   // gravados antes dos checksums
+    std::size_t checksumsInvalidos = 0;
+    Histograma comprimentoCadeia{rotulosComprimento()};
+    Histograma registrosPorBucket{rotulosComprimento()};
+    Histograma registrosPorBloco{{"0", "1", "2"}};
+    Histograma distanciaSaltos{rotulosDistancia()};
+
+    void somar(const RelatorioHash& p) {
+        bucketsUsados += p.bucketsUsados;
+        registros += p.registros;
+        blocosEmCadeias += p.blocosEmCadeias;
+        maiorCadeia = std::max(maiorCadeia, p.maiorCadeia);
+        saltos += p.saltos;
+        blocosSemChecksum += p.blocosSemChecksum;
+        checksumsInvalidos += p.checksumsInvalidos;
+        comprimentoCadeia.somar(p.comprimentoCadeia);
+        registrosPorBucket.somar(p.registrosPorBucket);
+        registrosPorBloco.somar(p.registrosPorBloco);
+        distanciaSaltos.somar(p.distanciaSaltos);
+    }
+};
+
+static void inspecionarHash(const Caminhos& c, unsigned threads, RelatorioHash& rel, Problemas& problemas) {
+    int fdTabela = ::open(c.tabelaHash.c_str(), O_RDONLY);
+    int fdDados = ::open(c.dados.c_str(), O_RDONLY);
+    struct stat stTabela, stDados;
+    if (fdTabela < 0 || fdDados < 0 || fstat(fdTabela, &stTabela) != 0 || fstat(fdDados, &stDados) != 0) {
+        if (fdTabela >= 0) ::close(fdTabela);
+        if (fdDados >= 0) ::close(fdDados);
+        return;
+    }
+    rel.presente = true;
+
+    // tabela: uma cabeça de cadeia por bucket e, no fim, a cabeça da lista livre
+    std::size_t entradas = static_cast<std::size_t>(stTabela.st_size) / sizeof(long);
+    std::vector<long> tabela(entradas, -1);
+    if (entradas < 2 || !lerTudo(fdTabela, reinterpret_cast<char*>(tabela.data()), entradas * sizeof(long), 0)) {
+        problemas.registrar("tabela hash vazia ou ilegivel");
+        ::close(fdTabela);
+        ::close(fdDados);
+        return;
+    }
+    ::close(fdTabela);
+    rel.tamanhoTabela = entradas - 1;
+    rel.totalBlocos = static_cast<std::size_t>(stDados.st_size) / sizeof(Bloco);
+    if (static_cast<std::size_t>(stDados.st_size) % sizeof(Bloco) != 0) {
+        problemas.registrar("artigos.dat nao tem um numero inteiro de blocos");
+    }
+
+    // marca de cada bloco: 1 quando alguma cadeia (ou a lista livre) passou por ele
+    std::vector<std::atomic<unsigned char>> marca(rel.totalBlocos);
+    const long tamBloco = static_cast<long>(sizeof(Bloco));
+    auto blocoValido = [&](long offset) {
+        return offset >= 0 && offset % tamBloco == 0 && static_cast<std::size_t>(offset / tamBloco) < rel.totalBlocos;
+    };
+
+    std::vector<RelatorioHash> parciais(std::max(1u, threads));
+    emParalelo(rel.tamanhoTabela, threads, [&](std::size_t fatia, std::size_t inicio, std::size_t fim) {
+        RelatorioHash& p = parciais[fatia];
+        Bloco bloco;
+        for (std::size_t b = inicio; b < fim; ++b) {
+            std::size_t comprimento = 0, registros = 0;
+            long offset = tabela[b];
+            while (offset != -1) {
+                if (!blocoValido(offset)) {
+                    problemas.registrar("bucket " + std::to_string(b) + ": offset de bloco invalido " + std::to_string(offset));
+                    break;
+                }
+                if (marca[static_cast<std::size_t>(offset / tamBloco)].exchange(1)) {
+                    problemas.registrar("bucket " + std::to_string(b) + ": bloco " + std::to_string(offset / tamBloco) +
+                                        " ja visitado (ciclo ou bloco em duas cadeias)");
+                    break;
+                }
+                if (!lerTudo(fdDados, reinterpret_cast<char*>(&bloco), sizeof(Bloco), offset)) {
+                    problemas.registrar("bucket " + std::to_string(b) + ": falha ao ler bloco " + std::to_string(offset / tamBloco));
+                    break;
+                }
+                comprimento++;
+                // o encadeamento de um bloco corrompido não é seguido
+                if (bloco.crc == 0) {
+                    p.blocosSemChecksum++;
+                } else if (bloco.crc != crcDoBloco(bloco)) {
+                    p.checksumsInvalidos++;
+                    problemas.registrar("bloco " + std::to_string(offset / tamBloco) + ": checksum invalido");
+                    break;
+                }
+                int usados = bloco.num_registros_usados;
+                if (usados < 1 || usados > REGISTROS_POR_BLOCO) {
+                    problemas.registrar("bloco " + std::to_string(offset / tamBloco) + ": num_registros_usados = " + std::to_string(usados));
+                    usados = std::max(0, std::min(usados, REGISTROS_POR_BLOCO));
+                }
+                p.registrosPorBloco.contagens[static_cast<std::size_t>(usados)]++;
+                for (int i = 0; i < usados; ++i) {
+                    const Artigo& art = bloco.artigos[i];
+                    if (!art.ocupado) {
+                        problemas.registrar("bloco " + std::to_string(offset / tamBloco) + ": posicao " + std::to_string(i) + " livre antes de num_registros_usados");
+                    } else if (static_cast<std::size_t>(art.id % static_cast<int>(rel.tamanhoTabela)) != b) {
+                        problemas.registrar("ID " + std::to_string(art.id) + " na cadeia do bucket " + std::to_string(b));
+                    } else {
+                        registros++;
+                    }
+                }
+                long proximo = bloco.proximo_bloco_offset;
+                if (proximo != -1) {
+                    p.saltos++;
+                    p.distanciaSaltos.contagens[faixaDistancia((proximo - offset) / tamBloco)]++;
+                }
+                offset = proximo;
+            }
+            if (comprimento) p.bucketsUsados++;
+            p.blocosEmCadeias += comprimento;
+            p.registros += registros;
+            p.maiorCadeia = std::max(p.maiorCadeia, comprimento);
+            p.comprimentoCadeia.contagens[faixaComprimento(comprimento)]++;
+            p.registrosPorBucket.contagens[faixaComprimento(registros)]++;
+        }
+    });
+    for (const RelatorioHash& p : parciais) rel.somar(p);
+
+    // lista livre: blocos vazios encadeados a partir da última entrada da tabela
+    Bloco bloco;
+    for (long offset = tabela[rel.tamanhoTabela]; offset != -1; offset = bloco.proximo_bloco_offset) {
+        if (!blocoValido(offset)) {
+            problemas.registrar("lista livre: offset invalido " + std::to_string(offset));
+            break;
+        }
+        if (marca[static_cast<std::size_t>(offset / tamBloco)].exchange(1)) {
+            problemas.registrar("lista livre: bloco " + std::to_string(offset / tamBloco) + " ja visitado (ciclo ou bloco em uso)");
+            break;
+        }
+        if (!lerTudo(fdDados, reinterpret_cast<char*>(&bloco), sizeof(Bloco), offset)) break;
+        if (bloco.num_registros_usados != 0) {
+            problemas.registrar("lista livre: bloco " + std::to_string(offset / tamBloco) + " com registros");
+        }
+        rel.blocosLivres++;
+    }
+    ::close(fdDados);
+
+    for (std::size_t b = 0; b < rel.totalBlocos; ++b) {
+        if (!marca[b].load()) rel.blocosOrfaos++;
+    }
+}
+
+// ===== B+ trees =====
+
+struct NivelArvore {
+    std::size_t nos = 0;
+    std::size_t folhas = 0;
+    std::uint64_t chaves = 0;
+    int minChaves = INT_MAX;
+    int maxChaves = 0;
+    std::size_t abaixoDoMinimo = 0; // nós (fora a raiz) com menos de M chaves
+    Histograma ocupacao{rotulosOcupacao()};
+
+    void somar(const NivelArvore& n) {
+        nos += n.nos;
+        folhas += n.folhas;
+        chaves += n.chaves;
+        minChaves = std::min(minChaves, n.minChaves);
+        maxChaves = std::max(maxChaves, n.maxChaves);
+        abaixoDoMinimo += n.abaixoDoMinimo;
+        ocupacao.somar(n.ocupacao);
+    }
+};
+
+static const int FAIXAS_DISPERSAO = 16;
+
+struct RelatorioArvore {
+    std::string nome;
+    std::string caminho;
+    bool comPaginasDeDados = true; // false: o long da folha é o próprio valor
+    bool presente = false;
+    std::size_t tamValor = sizeof(long);
+    FileManager::FileHeader cabecalho{};
+    std::size_t paginasNoArquivo = 0;
+    std::size_t paginasDeNos = 0;
+    std::size_t paginasDeDados = 0;
+    std::size_t paginasLivres = 0;
+    std::size_t paginasOrfas = 0;
+    std::size_t checksumsInvalidos = 0; // nós; as páginas de dados não são lidas
+    std::uint64_t entradas = 0;
+    std::uint64_t chavesDistintas = 0;
+    std::vector<NivelArvore> niveis;
+    long long chaveMin = 0;
+    long long chaveMax = 0;
+    std::vector<std::uint64_t> dispersao = std::vector<std::uint64_t>(FAIXAS_DISPERSAO, 0);
+    Histograma distanciaFolhas{rotulosDistancia()};
+    double fragmentacaoFolhas = 0;
+};
+
+// Nó a visitar com os limites que as chaves do pai impõem (inclusivos: com
+// chaves repetidas, a mesma chave pode aparecer dos dois lados do separador)
+struct Pendente {
+    long offset;
+    long long lo;
+    long long hi;
+};
+
+struct Folha {
+    long offset;
+    long proxima;
+    int numKeys;
+    int primeira;
+    int ultima;
+    std::uint64_t distintas;
+};
+
+static bool lerNo(int fd, long offset, No& no) {
+    return lerTudo(fd, reinterpret_cast<char*>(&no), sizeof(No), offset);
+}
+
+// desce pela borda esquerda (ou direita) até a folha
+static bool chaveExtrema(int fd, long raiz, bool direita, int& chave) {
+    No no;
+    long offset = raiz;
+    for (int nivel = 0; nivel < 64; ++nivel) {
+        if (!lerNo(fd, offset, no) || no.numKeys < 0 || no.numKeys > 2 * M) return false;
+        if (no.isLeaf) {
+            if (no.numKeys == 0) return false;
+            chave = no.keys[direita ? no.numKeys - 1 : 0];
+            return true;
+        }
+        offset = no.childrenOffsets[direita ? no.numKeys : 0];
+    }
+    return false;
+}
+
+static void inspecionarArvore(unsigned threads, RelatorioArvore& rel, Problemas& problemas) {
+    int fd = ::open(rel.caminho.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    rel.presente = true;
+    const std::string prefixo = rel.nome + ": ";
+    auto& cab = rel.cabecalho;
+    if (!lerTudo(fd, reinterpret_cast<char*>(&cab), sizeof(cab), 0)) {
+        problemas.registrar(prefixo + "cabecalho ilegivel");
+        ::close(fd);
+        return;
+    }
+    if (cab.m != M) problemas.registrar(prefixo + "ordem " + std::to_string(cab.m) + " diferente de M=" + std::to_string(M));
+    if (rel.comPaginasDeDados) rel.tamValor = FileManager::valueBytes(cab, cab.projection ? sizeof(ValorProjetado) : sizeof(long));
+    rel.paginasNoArquivo = cab.nextFreeOffset > BLOCK_SIZE ? static_cast<std::size_t>(cab.nextFreeOffset - BLOCK_SIZE) / BLOCK_SIZE : 0;
+    auto paginaValida = [&](long offset) {
+        return offset >= BLOCK_SIZE && offset % BLOCK_SIZE == 0 && offset < cab.nextFreeOffset;
+    };
+    if (!paginaValida(cab.rootOffset)) {
+        problemas.registrar(prefixo + "raiz em offset invalido " + std::to_string(cab.rootOffset));
+        ::close(fd);
+        return;
+    }
+
+    int menor = 0, maior = 0;
+    bool temChaves = chaveExtrema(fd, cab.rootOffset, false, menor) && chaveExtrema(fd, cab.rootOffset, true, maior);
+    rel.chaveMin = temChaves ? menor : 0;
+    rel.chaveMax = temChaves ? maior : 0;
+    const long long largura = temChaves ? (rel.chaveMax - rel.chaveMin) / FAIXAS_DISPERSAO + 1 : 1;
+    const bool comChecksums = cab.checksums == FileManager::CHECKSUM_MAGIC;
+
+    std::vector<long> paginasUsadas;
+    std::vector<Folha> folhas;
+    std::vector<Pendente> nivel{{cab.rootOffset, LLONG_MIN, LLONG_MAX}};
+    // cada fatia de um nível processa seus nós em ordem; concatenar as fatias
+    // mantém a ordem das chaves no nível seguinte
+    struct Fatia {
+        NivelArvore nivel;
+        std::size_t checksumsInvalidos = 0;
+        std::vector<Pendente> filhos;
+        std::vector<Folha> folhas;
+        std::vector<long> paginas;
+        std::vector<std::uint64_t> dispersao = std::vector<std::uint64_t>(FAIXAS_DISPERSAO, 0);
+    };
+    for (int profundidade = 0; !nivel.empty(); ++profundidade) {
+        if (profundidade >= 64) {
+            problemas.registrar(prefixo + "altura acima de 64 (ciclo entre nos?)");
+            break;
+        }
+        std::vector<Fatia> fatias(std::max(1u, threads));
+        const bool ehRaiz = profundidade == 0;
+        emParalelo(nivel.size(), threads, [&](std::size_t f, std::size_t inicio, std::size_t fim) {
+            Fatia& fatia = fatias[f];
+            No no;
+            for (std::size_t i = inicio; i < fim; ++i) {
+                const Pendente& pendente = nivel[i];
+                const std::string onde = prefixo + "no " + std::to_string(pendente.offset) + ": ";
+                fatia.paginas.push_back(pendente.offset);
+                if (!lerNo(fd, pendente.offset, no)) {
+                    problemas.registrar(onde + "falha na leitura");
+                    continue;
+                }
+                if (comChecksums && no.checksum != FileManager::nodeChecksum<long>(no)) {
+                    fatia.checksumsInvalidos++;
+                    problemas.registrar(onde + "checksum invalido");
+                    continue;
+                }
+                if (no.numKeys < 0 || no.numKeys > 2 * M) {
+                    problemas.registrar(onde + "numKeys = " + std::to_string(no.numKeys));
+                    continue;
+                }
+                NivelArvore& est = fatia.nivel;
+                est.nos++;
+                est.chaves += static_cast<std::uint64_t>(no.numKeys);
+                est.minChaves = std::min(est.minChaves, no.numKeys);
+                est.maxChaves = std::max(est.maxChaves, no.numKeys);
+                if (!ehRaiz && no.numKeys < M) est.abaixoDoMinimo++;
+                est.ocupacao.contagens[faixaOcupacao(no.numKeys, 2 * M)]++;
+
+                std::uint64_t distintas = 0;
+                for (int k = 0; k < no.numKeys; ++k) {
+                    if (k > 0 && no.keys[k] < no.keys[k - 1]) problemas.registrar(onde + "chaves fora de ordem");
+                    if (no.keys[k] < pendente.lo || no.keys[k] > pendente.hi) {
+                        problemas.registrar(onde + "chave " + std::to_string(no.keys[k]) + " fora dos limites do pai");
+                    }
+                    if (k == 0 || no.keys[k] != no.keys[k - 1]) distintas++;
+                }
+
+                if (!no.isLeaf) {
+                    if (no.numKeys == 0) problemas.registrar(onde + "no interno sem chaves");
+                    for (int c = 0; c <= no.numKeys; ++c) {
+                        long filho = no.childrenOffsets[c];
+                        if (!paginaValida(filho)) {
+                            problemas.registrar(onde + "filho " + std::to_string(c) + " em offset invalido " + std::to_string(filho));
+                            continue;
+                        }
+                        fatia.filhos.push_back({filho, c == 0 ? pendente.lo : no.keys[c - 1],
+                                                c == no.numKeys ? pendente.hi : no.keys[c]});
+                    }
+                    continue;
+                }
+
+                est.folhas++;
+                fatia.folhas.push_back({pendente.offset, no.nextLeafOffset, no.numKeys,
+                                        no.numKeys ? no.keys[0] : 0, no.numKeys ? no.keys[no.numKeys - 1] : 0, distintas});
+                for (int k = 0; k < no.numKeys; ++k) {
+                    long long faixa = (no.keys[k] - rel.chaveMin) / largura;
+                    fatia.dispersao[static_cast<std::size_t>(std::max(0LL, std::min<long long>(faixa, FAIXAS_DISPERSAO - 1)))]++;
+                    if (!rel.comPaginasDeDados) continue;
+                    long dado = no.childrenOffsets[k];
+                    if (!paginaValida(dado)) {
+                        problemas.registrar(onde + "pagina de dados invalida " + std::to_string(dado));
+                    } else {
+                        fatia.paginas.push_back(dado);
+                    }
+                }
+            }
+        });
+
+        NivelArvore est;
+        std::vector<Pendente> proximo;
+        for (Fatia& fatia : fatias) {
+            est.somar(fatia.nivel);
+            rel.checksumsInvalidos += fatia.checksumsInvalidos;
+            proximo.insert(proximo.end(), fatia.filhos.begin(), fatia.filhos.end());
+            folhas.insert(folhas.end(), fatia.folhas.begin(), fatia.folhas.end());
+            paginasUsadas.insert(paginasUsadas.end(), fatia.paginas.begin(), fatia.paginas.end());
+            for (int f = 0; f < FAIXAS_DISPERSAO; ++f) rel.dispersao[f] += fatia.dispersao[f];
+        }
+        if (est.folhas != 0 && est.folhas != est.nos) {
+            problemas.registrar(prefixo + "folhas e nos internos misturados no nivel " + std::to_string(profundidade));
+        }
+        rel.paginasDeNos += est.nos;
+        if (est.folhas != 0) rel.entradas += est.chaves;
+        rel.niveis.push_back(est);
+        nivel.swap(proximo);
+    }
+    rel.paginasDeDados = rel.comPaginasDeDados ? static_cast<std::size_t>(rel.entradas) : 0;
+
+    // cadeia de folhas: deve seguir exatamente a ordem das folhas na árvore
+    std::size_t adjacentes = 0;
+    for (std::size_t i = 0; i < folhas.size(); ++i) {
+        const Folha& f = folhas[i];
+        rel.chavesDistintas += f.distintas;
+        if (i + 1 == folhas.size()) {
+            if (f.proxima != 0) problemas.registrar(prefixo + "ultima folha aponta para " + std::to_string(f.proxima));
+            break;
+        }
+        const Folha& seguinte = folhas[i + 1];
+        if (f.proxima != seguinte.offset) {
+            problemas.registrar(prefixo + "folha " + std::to_string(f.offset) + " aponta para " + std::to_string(f.proxima) +
+                                " em vez de " + std::to_string(seguinte.offset));
+        }
+        if (f.numKeys && seguinte.numKeys) {
+            if (seguinte.primeira < f.ultima) problemas.registrar(prefixo + "chaves decrescem entre as folhas " + std::to_string(f.offset) + " e " + std::to_string(seguinte.offset));
+            if (seguinte.primeira == f.ultima) rel.chavesDistintas--;
+        }
+        std::size_t faixa = faixaDistancia((seguinte.offset - f.offset) / BLOCK_SIZE);
+        rel.distanciaFolhas.contagens[faixa]++;
+        if (faixa == 0) adjacentes++;
+    }
+    rel.fragmentacaoFolhas = folhas.size() > 1 ? 1.0 - static_cast<double>(adjacentes) / static_cast<double>(folhas.size() - 1) : 0.0;
+
+    // lista livre: o encadeamento fica nos primeiros bytes de cada página
+    long livre = cab.freeListHead;
+    while (livre != 0) {
+        if (!paginaValida(livre) || rel.paginasLivres > rel.paginasNoArquivo) {
+            problemas.registrar(prefixo + "lista livre corrompida em " + std::to_string(livre));
+            break;
+        }
+        paginasUsadas.push_back(livre);
+        rel.paginasLivres++;
+        long proxima = 0;
+        if (!lerTudo(fd, reinterpret_cast<char*>(&proxima), sizeof(proxima), livre)) break;
+        livre = proxima;
+    }
+    ::close(fd);
+
+    // cada página pertence a um único dono (nó, valor ou lista livre)
+    std::sort(paginasUsadas.begin(), paginasUsadas.end());
+    std::size_t repetidas = 0;
+    for (std::size_t i = 1; i < paginasUsadas.size(); ++i) {
+        if (paginasUsadas[i] == paginasUsadas[i - 1]) repetidas++;
+    }
+    if (repetidas) problemas.registrar(prefixo + std::to_string(repetidas) + " paginas com mais de um dono");
+    std::size_t unicas = paginasUsadas.size() - repetidas;
+    rel.paginasOrfas = rel.paginasNoArquivo > unicas ? rel.paginasNoArquivo - unicas : 0;
+}
+
+// ===== JSON =====
+
+static std::string textoJson(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+static void escreverHistograma(std::ostream& out, const Histograma& h) {
+    out << "{";
+    for (std::size_t i = 0; i < h.rotulos.size(); ++i) {
+        out << (i ? ", " : "") << textoJson(h.rotulos[i]) << ": " << h.contagens[i];
+    }
+    out << "}";
+}
+
+static void escreverHash(std::ostream& out, const RelatorioHash& h) {
+    out << "  \"hash\": {\"presente\": " << (h.presente ? "true" : "false");
+    if (h.presente) {
+        out << ",\n    \"tamanho_tabela\": " << h.tamanhoTabela
+            << ", \"blocos\": " << h.totalBlocos
+            << ", \"registros\": " << h.registros
+            << ", \"buckets_usados\": " << h.bucketsUsados
+            << ", \"blocos_em_cadeias\": " << h.blocosEmCadeias
+            << ", \"blocos_livres\": " << h.blocosLivres
+            << ", \"blocos_orfaos\": " << h.blocosOrfaos << ",\n"
+            << "    \"fator_de_carga\": " << (h.tamanhoTabela ? static_cast<double>(h.registros) / (h.tamanhoTabela * REGISTROS_POR_BLOCO) : 0.0)
+            << ", \"ocupacao_blocos\": " << (h.blocosEmCadeias ? static_cast<double>(h.registros) / (h.blocosEmCadeias * REGISTROS_POR_BLOCO) : 0.0)
+            << ", \"cadeia_media\": " << (h.bucketsUsados ? static_cast<double>(h.blocosEmCadeias) / h.bucketsUsados : 0.0)
+            << ", \"maior_cadeia\": " << h.maiorCadeia
+            << ", \"saltos\": " << h.saltos
+            << ", \"blocos_sem_checksum\": " << h.blocosSemChecksum
+            << ", \"checksums_invalidos\": " << h.checksumsInvalidos << ",\n"
+            << "    \"histograma_comprimento_cadeia\": ";
+        escreverHistograma(out, h.comprimentoCadeia);
+        out << ",\n    \"histograma_registros_por_bucket\": ";
+        escreverHistograma(out, h.registrosPorBucket);
+        out << ",\n    \"histograma_registros_por_bloco\": ";
+        escreverHistograma(out, h.registrosPorBloco);
+        out << ",\n    \"histograma_distancia_saltos\": ";
+        escreverHistograma(out, h.distanciaSaltos);
+        out << "\n  ";
+    }
+    out << "}";
+}
+
+static void escreverArvore(std::ostream& out, const RelatorioArvore& a) {
+    out << "    {\"nome\": " << textoJson(a.nome) << ", \"arquivo\": " << textoJson(a.caminho)
+        << ", \"presente\": " << (a.presente ? "true" : "false");
+    if (!a.presente) {
+        out << "}";
+        return;
+    }
+    out << ",\n      \"ordem\": " << a.cabecalho.m
+        << ", \"altura\": " << a.niveis.size()
+        << ", \"entradas\": " << a.entradas
+        << ", \"chaves_distintas\": " << a.chavesDistintas
+        << ", \"projecao\": " << textoJson(nomesDasColunas(a.cabecalho.projection))
+        << ", \"checksums\": " << (a.cabecalho.checksums == FileManager::CHECKSUM_MAGIC ? "true" : "false")
+        << ", \"checksums_invalidos\": " << a.checksumsInvalidos << ",\n"
+        << "      \"paginas\": {\"total\": " << a.paginasNoArquivo
+        << ", \"nos\": " << a.paginasDeNos
+        << ", \"dados\": " << a.paginasDeDados
+        << ", \"livres\": " << a.paginasLivres
+        << ", \"orfas\": " << a.paginasOrfas
+        << ", \"bytes_uteis_no\": " << sizeof(No)
+        << ", \"bytes_uteis_dado\": " << (a.comPaginasDeDados ? a.tamValor : 0)
+        << ", \"bytes_desperdicados\": "
+        << a.paginasDeNos * (BLOCK_SIZE - sizeof(No)) + a.paginasDeDados * (BLOCK_SIZE - a.tamValor) << "},\n"
+        << "      \"niveis\": [";
+    for (std::size_t i = 0; i < a.niveis.size(); ++i) {
+        const NivelArvore& n = a.niveis[i];
+        out << (i ? ",\n" : "\n") << "        {\"nivel\": " << i
+            << ", \"nos\": " << n.nos
+            << ", \"folhas\": " << (n.folhas != 0 ? "true" : "false")
+            << ", \"chaves\": " << n.chaves
+            << ", \"min_chaves\": " << (n.nos ? n.minChaves : 0)
+            << ", \"max_chaves\": " << n.maxChaves
+            << ", \"ocupacao_media\": " << (n.nos ? static_cast<double>(n.chaves) / (n.nos * 2.0 * M) : 0.0)
+            << ", \"abaixo_do_minimo\": " << n.abaixoDoMinimo
+            << ", \"histograma_ocupacao\": ";
+        escreverHistograma(out, n.ocupacao);
+        out << "}";
+    }
+    out << "\n      ],\n"
+        << "      \"dispersao_chaves\": {\"min\": " << a.chaveMin << ", \"max\": " << a.chaveMax
+        << ", \"faixas\": [";
+    for (int f = 0; f < FAIXAS_DISPERSAO; ++f) out << (f ? ", " : "") << a.dispersao[f];
+    out << "]},\n"
+        << "      \"fragmentacao_folhas\": " << a.fragmentacaoFolhas
+        << ", \"histograma_distancia_folhas\": ";
+    escreverHistograma(out, a.distanciaFolhas);
+    out << "}";
+}
+
+static void uso(const char* prog) {
+    std::cerr << "Uso: " << prog << " [--threads N] [--particao K] [--saida ARQUIVO.json]\n"
+              << "  --threads N     threads das varreduras (padrao: nucleos disponiveis)\n"
+              << "  --particao K    particao inspecionada, se a base for particionada (padrao 0)\n"
+              << "  --saida ARQUIVO grava o JSON no arquivo em vez de stdout\n"
+              << "Sai com status 2 se algum invariante da estrutura for violado." << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    unsigned threads = std::thread::hardware_concurrency();
+    std::string caminhoSaida;
+    int particao = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (arg == "--particao" && i + 1 < argc) {
+            particao = std::atoi(argv[++i]);
+        } else if (arg == "--saida" && i + 1 < argc) {
+            caminhoSaida = argv[++i];
+        } else {
+            uso(argv[0]);
+            return 1;
+        }
+    }
+    if (threads == 0) threads = 1;
+    if (particao < 0 || particao >= numParticoes()) {
+        std::cerr << "Erro: particao " << particao << " inexistente (a base tem " << numParticoes() << ")" << std::endl;
+        return 1;
+    }
+    Caminhos c = caminhosDaParticao(particao);
+
+    auto inicio = std::chrono::steady_clock::now();
+    Problemas problemas;
+    RelatorioHash hash;
+    inspecionarHash(c, threads, hash, problemas);
+
+    std::vector<RelatorioArvore> arvores(3);
+    arvores[0].nome = "primario";
+    arvores[0].caminho = c.primario;
+    arvores[1].nome = "secundario";
+    arvores[1].caminho = c.secundario;
+    arvores[2].nome = "ano_citacoes";
+    arvores[2].caminho = c.anoCitacoes;
+    arvores[2].comPaginasDeDados = false; // bulkLoadPayloads: o valor fica na folha
+    for (RelatorioArvore& a : arvores) inspecionarArvore(threads, a, problemas);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count();
+
+    std::ofstream arquivo;
+    if (!caminhoSaida.empty()) {
+        arquivo.open(caminhoSaida, std::ios::trunc);
+        if (!arquivo.is_open()) {
+            std::cerr << "Erro: nao foi possivel criar " << caminhoSaida << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = caminhoSaida.empty() ? std::cout : arquivo;
+    out << "{\n  \"data_dir\": " << textoJson(c.dataDir) << ", \"db_dir\": " << textoJson(c.dbDir)
+        << ", \"particao\": " << particao << ", \"particoes\": " << numParticoes()
+        << ", \"threads\": " << threads << ", \"tempo_ms\": " << ms << ",\n"
+        << "  \"ok\": " << (problemas.total() == 0 ? "true" : "false")
+        << ", \"problemas\": " << problemas.total() << ", \"exemplos_problemas\": [";
+    for (std::size_t i = 0; i < problemas.exemplos().size(); ++i) {
+        out << (i ? ", " : "") << textoJson(problemas.exemplos()[i]);
+    }
+    out << "],\n";
+    escreverHash(out, hash);
+    out << ",\n  \"arvores\": [\n";
+    for (std::size_t i = 0; i < arvores.size(); ++i) {
+        escreverArvore(out, arvores[i]);
+        out << (i + 1 < arvores.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    return problemas.total() == 0 ? 0 : 2;
+}
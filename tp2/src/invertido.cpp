@@ -0,0 +1,415 @@
+#include "../include/invertido.h"
+#include "../include/hashing_file.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char INVERTIDO_MAGIC[4] = {'I', 'N', 'V', '1'};
+
+struct Cabecalho {
+    char magic[4];
+    std::uint32_t postingsPorBloco;
+    std::uint64_t numTermos;
+    std::uint64_t numDocs;
+    std::uint64_t offDicionario;
+    std::uint64_t offTermos;
+    std::uint64_t offPostings;
+    std::uint64_t tamanho;
+    char reservado[8];
+};
+static_assert(sizeof(Cabecalho) == 64, "cabecalho do indice invertido deve ter 64 bytes");
+
+struct EntradaDicionario {
+    std::uint64_t offTermo;    // relativo ao pool de termos
+    std::uint32_t tamTermo;
+    std::uint32_t df;
+    std::uint64_t offPostings; // absoluto no arquivo
+    std::uint64_t bytesPostings;
+};
+static_assert(sizeof(EntradaDicionario) == 32, "entrada do dicionario deve ter 32 bytes");
+
+inline bool caractereDeTermo(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c >= 0x80;
+}
+
+inline void escreverVarint(std::string& out, std::uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+inline std::uint64_t lerVarint(const unsigned char*& p) {
+    std::uint64_t v = 0;
+    int shift = 0;
+    while (*p & 0x80) {
+        v |= static_cast<std::uint64_t>(*p++ & 0x7F) << shift;
+        shift += 7;
+    }
+    v |= static_cast<std::uint64_t>(*p++) << shift;
+    return v;
+}
+
+inline std::size_t alinhar8(std::size_t n) {
+    return (n + 7) & ~static_cast<std::size_t>(7);
+}
+
+} // namespace
+
+void tokenizar(const char* texto, std::size_t maxLen, std::vector<std::string>& termos) {
+    std::size_t n = strnlen(texto, maxLen);
+    std::size_t i = 0;
+    while (i < n) {
+        while (i < n && !caractereDeTermo(static_cast<unsigned char>(texto[i]))) ++i;
+        std::size_t inicio = i;
+        while (i < n && caractereDeTermo(static_cast<unsigned char>(texto[i]))) ++i;
+        std::size_t tam = i - inicio;
+        if (tam < TAMANHO_MIN_TERMO) continue;
+
+        std::string termo(texto + inicio, std::min(tam, TAMANHO_MAX_TERMO));
+        for (char& c : termo) {
+            if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        }
+        termos.push_back(std::move(termo));
+    }
+}
+
+void extrairAutores(const char* autores, std::size_t maxLen, std::vector<std::string>& nomes) {
+    std::size_t n = strnlen(autores, maxLen);
+    std::string nome;
+    bool espaco = false;
+    for (std::size_t i = 0; i <= n; ++i) {
+        char c = i < n ? autores[i] : '|';
+        if (c == '|') {
+            if (!nome.empty()) nomes.push_back(nome);
+            nome.clear();
+            espaco = false;
+        } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            espaco = !nome.empty();
+        } else {
+            if (espaco) nome.push_back(' ');
+            espaco = false;
+            if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+            nome.push_back(c);
+        }
+    }
+}
+
+// ===== construção =====
+
+void InvertidoBuilder::adicionar(long rid, const Artigo& artigo) {
+    termosDoc_.clear();
+    tokenizar(artigo.titulo, sizeof(artigo.titulo), termosDoc_);
+    tokenizar(artigo.snippet, sizeof(artigo.snippet), termosDoc_);
+    adicionarTermos(rid, termosDoc_);
+}
+
+void InvertidoBuilder::adicionarTermos(long rid, std::vector<std::string>& termos) {
+    std::sort(termos.begin(), termos.end());
+    termos.erase(std::unique(termos.begin(), termos.end()), termos.end());
+    docs_++;
+
+    for (const std::string& termo : termos) {
+        acrescentar(listas_[termo], rid);
+        postings_++;
+    }
+}
+
+void InvertidoBuilder::acrescentar(Lista& lista, long rid) {
+    if (lista.df % POSTINGS_POR_BLOCO == 0) {
+        // novo bloco: o primeiro RID vai absoluto para decodificar o bloco sozinho
+        lista.skips.push_back({rid, static_cast<std::uint32_t>(lista.bytes.size()), 0});
+        escreverVarint(lista.bytes, static_cast<std::uint64_t>(rid));
+    } else {
+        escreverVarint(lista.bytes, static_cast<std::uint64_t>(rid - lista.ultimo));
+    }
+    lista.skips.back().n++;
+    lista.ultimo = rid;
+    lista.df++;
+}
+
+bool InvertidoBuilder::gravar(const std::string& caminho) const {
+    std::vector<ListaGravada> ordenadas;
+    ordenadas.reserve(listas_.size());
+    for (const auto& par : listas_) ordenadas.push_back({par.first, par.second.df, &par.second, nullptr, 0});
+    std::sort(ordenadas.begin(), ordenadas.end(), [](const ListaGravada& a, const ListaGravada& b) { return a.termo < b.termo; });
+    return gravarListas(caminho, docs_, ordenadas);
+}
+
+void InvertidoBuilder::retirar(long rid, const Artigo& anterior) {
+    termosDoc_.clear();
+    tokenizar(anterior.titulo, sizeof(anterior.titulo), termosDoc_);
+    tokenizar(anterior.snippet, sizeof(anterior.snippet), termosDoc_);
+    retirarTermos(rid, termosDoc_);
+}
+
+void InvertidoBuilder::retirarTermos(long rid, std::vector<std::string>& termos) {
+    std::sort(termos.begin(), termos.end());
+    termos.erase(std::unique(termos.begin(), termos.end()), termos.end());
+    docsRetirados_++;
+    for (const std::string& termo : termos) retiradas_[termo].push_back(rid);
+}
+
+bool InvertidoBuilder::mesclar(const std::string& caminho) const {
+    IndiceInvertido atual;
+    if (!atual.abrir(caminho)) return false;
+    const Cabecalho* cab = reinterpret_cast<const Cabecalho*>(atual.base_);
+    const EntradaDicionario* dic = reinterpret_cast<const EntradaDicionario*>(atual.base_ + cab->offDicionario);
+    const char* pool = reinterpret_cast<const char*>(atual.base_ + cab->offTermos);
+    auto termoDe = [&](const EntradaDicionario& e) { return std::string_view(pool + e.offTermo, e.tamTermo); };
+
+    // termos que o lote toca, em ordem
+    std::vector<std::string_view> lote;
+    lote.reserve(listas_.size() + retiradas_.size());
+    for (const auto& par : listas_) lote.push_back(par.first);
+    for (const auto& par : retiradas_) lote.push_back(par.first);
+    std::sort(lote.begin(), lote.end());
+    lote.erase(std::unique(lote.begin(), lote.end()), lote.end());
+
+    std::unordered_map<std::string, Lista> refeitas;
+    std::vector<ListaGravada> saida;
+    saida.reserve(cab->numTermos + lote.size());
+    std::vector<long> antigos, novos, retirados, rids;
+    std::size_t i = 0, j = 0;
+    while (i < cab->numTermos || j < lote.size()) {
+        if (j == lote.size() || (i < cab->numTermos && termoDe(dic[i]) < lote[j])) {
+            saida.push_back({termoDe(dic[i]), dic[i].df, nullptr, atual.base_ + dic[i].offPostings, dic[i].bytesPostings});
+            ++i;
+            continue;
+        }
+
+        // termo do lote: a lista antiga sem os RIDs retirados, intercalada com os novos
+        const std::string_view termo = lote[j++];
+        antigos.clear();
+        if (i < cab->numTermos && termoDe(dic[i]) == termo) {
+            PostingCursor cursor;
+            for (atual.buscar(std::string(termo), cursor); !cursor.fim(); cursor.proximo()) antigos.push_back(cursor.atual());
+            ++i;
+        }
+        retirados.clear();
+        auto r = retiradas_.find(std::string(termo));
+        if (r != retiradas_.end()) {
+            retirados = r->second;
+            std::sort(retirados.begin(), retirados.end());
+        }
+        novos.clear();
+        auto n = listas_.find(std::string(termo));
+        if (n != listas_.end()) {
+            for (const Skip& skip : n->second.skips) {
+                const unsigned char* p = reinterpret_cast<const unsigned char*>(n->second.bytes.data()) + skip.offset;
+                long rid = static_cast<long>(lerVarint(p));
+                novos.push_back(rid);
+                for (std::uint32_t k = 1; k < skip.n; ++k) {
+                    rid += static_cast<long>(lerVarint(p));
+                    novos.push_back(rid);
+                }
+            }
+        }
+
+        rids.clear();
+        std::set_difference(antigos.begin(), antigos.end(), retirados.begin(), retirados.end(), std::back_inserter(rids));
+        std::size_t meio = rids.size();
+        rids.insert(rids.end(), novos.begin(), novos.end());
+        std::inplace_merge(rids.begin(), rids.begin() + static_cast<long>(meio), rids.end());
+        rids.erase(std::unique(rids.begin(), rids.end()), rids.end());
+        if (rids.empty()) continue;
+
+        Lista& lista = refeitas[std::string(termo)];
+        for (long rid : rids) acrescentar(lista, rid);
+        saida.push_back({termo, lista.df, &lista, nullptr, 0});
+    }
+    return gravarListas(caminho, cab->numDocs + docs_ - docsRetirados_, saida);
+}
+
+bool InvertidoBuilder::gravarListas(const std::string& caminho, std::uint64_t numDocs, const std::vector<ListaGravada>& listas) {
+    Cabecalho cab{};
+    std::memcpy(cab.magic, INVERTIDO_MAGIC, sizeof(INVERTIDO_MAGIC));
+    cab.postingsPorBloco = static_cast<std::uint32_t>(POSTINGS_POR_BLOCO);
+    cab.numTermos = listas.size();
+    cab.numDocs = numDocs;
+    cab.offDicionario = sizeof(Cabecalho);
+
+    std::vector<EntradaDicionario> dicionario(listas.size());
+    std::string pool;
+    for (std::size_t i = 0; i < listas.size(); ++i) {
+        dicionario[i].offTermo = pool.size();
+        dicionario[i].tamTermo = static_cast<std::uint32_t>(listas[i].termo.size());
+        dicionario[i].df = listas[i].df;
+        pool += listas[i].termo;
+    }
+    cab.offTermos = cab.offDicionario + dicionario.size() * sizeof(EntradaDicionario);
+    cab.offPostings = alinhar8(cab.offTermos + pool.size());
+
+    std::uint64_t off = cab.offPostings;
+    for (std::size_t i = 0; i < listas.size(); ++i) {
+        const Lista* lista = listas[i].lista;
+        std::uint64_t bytes = lista ? 8 + lista->skips.size() * sizeof(Skip) + lista->bytes.size() : listas[i].tamanho;
+        dicionario[i].offPostings = off;
+        dicionario[i].bytesPostings = bytes;
+        off = alinhar8(off + bytes);
+    }
+    cab.tamanho = off;
+
+    // grava em arquivo temporário e renomeia: consultas nunca veem o índice pela metade
+    std::string tmp = caminho + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        static const char zeros[8] = {};
+        out.write(reinterpret_cast<const char*>(&cab), sizeof(cab));
+        out.write(reinterpret_cast<const char*>(dicionario.data()), static_cast<std::streamsize>(dicionario.size() * sizeof(EntradaDicionario)));
+        out.write(pool.data(), static_cast<std::streamsize>(pool.size()));
+        out.write(zeros, static_cast<std::streamsize>(cab.offPostings - (cab.offTermos + pool.size())));
+
+        for (std::size_t i = 0; i < listas.size(); ++i) {
+            if (const Lista* lista = listas[i].lista) {
+                std::uint32_t numBlocos = static_cast<std::uint32_t>(lista->skips.size());
+                out.write(reinterpret_cast<const char*>(&numBlocos), sizeof(numBlocos));
+                out.write(reinterpret_cast<const char*>(&lista->df), sizeof(lista->df));
+                out.write(reinterpret_cast<const char*>(lista->skips.data()), static_cast<std::streamsize>(lista->skips.size() * sizeof(Skip)));
+                out.write(lista->bytes.data(), static_cast<std::streamsize>(lista->bytes.size()));
+            } else {
+                out.write(reinterpret_cast<const char*>(listas[i].bytes), static_cast<std::streamsize>(listas[i].tamanho));
+            }
+            std::uint64_t fim = dicionario[i].offPostings + dicionario[i].bytesPostings;
+            out.write(zeros, static_cast<std::streamsize>(alinhar8(fim) - fim));
+        }
+        if (!out.good()) return false;
+    }
+    return std::rename(tmp.c_str(), caminho.c_str()) == 0;
+}
+
+// ===== consulta =====
+
+IndiceInvertido::~IndiceInvertido() {
+    if (base_) munmap(const_cast<unsigned char*>(base_), tamanho_);
+}
+
+bool IndiceInvertido::abrir(const std::string& caminho) {
+    int fd = ::open(caminho.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(Cabecalho)) {
+        ::close(fd);
+        return false;
+    }
+    void* p = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+
+    const Cabecalho* cab = static_cast<const Cabecalho*>(p);
+    if (std::memcmp(cab->magic, INVERTIDO_MAGIC, sizeof(INVERTIDO_MAGIC)) != 0 ||
+        cab->postingsPorBloco != POSTINGS_POR_BLOCO || cab->tamanho > static_cast<std::uint64_t>(st.st_size)) {
+        munmap(p, static_cast<std::size_t>(st.st_size));
+        return false;
+    }
+    base_ = static_cast<const unsigned char*>(p);
+    tamanho_ = static_cast<std::size_t>(st.st_size);
+    return true;
+}
+
+std::size_t IndiceInvertido::numTermos() const {
+    return base_ ? reinterpret_cast<const Cabecalho*>(base_)->numTermos : 0;
+}
+
+std::size_t IndiceInvertido::numDocs() const {
+    return base_ ? reinterpret_cast<const Cabecalho*>(base_)->numDocs : 0;
+}
+
+bool IndiceInvertido::buscar(const std::string& termo, PostingCursor& cursor) const {
+    cursor = PostingCursor();
+    if (!base_) return false;
+    const Cabecalho* cab = reinterpret_cast<const Cabecalho*>(base_);
+    const EntradaDicionario* dic = reinterpret_cast<const EntradaDicionario*>(base_ + cab->offDicionario);
+    const char* pool = reinterpret_cast<const char*>(base_ + cab->offTermos);
+
+    auto termoDe = [&](const EntradaDicionario& e) { return std::string_view(pool + e.offTermo, e.tamTermo); };
+    const EntradaDicionario* fim = dic + cab->numTermos;
+    const EntradaDicionario* it = std::lower_bound(dic, fim, std::string_view(termo),
+        [&](const EntradaDicionario& e, std::string_view t) { return termoDe(e) < t; });
+    if (it == fim || termoDe(*it) != termo) return false;
+
+    const unsigned char* lista = base_ + it->offPostings;
+    std::memcpy(&cursor.numBlocos_, lista, sizeof(std::uint32_t));
+    std::memcpy(&cursor.df_, lista + 4, sizeof(std::uint32_t));
+    cursor.skips_ = reinterpret_cast<const PostingCursor::Skip*>(lista + 8);
+    cursor.dados_ = lista + 8 + cursor.numBlocos_ * sizeof(PostingCursor::Skip);
+    if (cursor.numBlocos_ == 0) return false;
+    cursor.carregarBloco(0);
+    return true;
+}
+
+void PostingCursor::carregarBloco(std::uint32_t b) {
+    bloco_ = b;
+    pos_ = 0;
+    buf_.resize(skips_[b].n);
+    const unsigned char* p = dados_ + skips_[b].offset;
+    long rid = static_cast<long>(lerVarint(p));
+    buf_[0] = rid;
+    for (std::uint32_t i = 1; i < skips_[b].n; ++i) {
+        rid += static_cast<long>(lerVarint(p));
+        buf_[i] = rid;
+    }
+    fim_ = buf_.empty();
+    decodificados_++;
+}
+
+void PostingCursor::proximo() {
+    if (fim_) return;
+    if (++pos_ < buf_.size()) return;
+    if (bloco_ + 1 < numBlocos_) carregarBloco(bloco_ + 1);
+    else fim_ = true;
+}
+
+bool PostingCursor::avancarPara(long alvo) {
+    if (fim_) return false;
+    if (buf_[pos_] >= alvo) return true;
+
+    // alvo além do bloco atual: galopa pelos skips atrás do último bloco cujo
+    // primeiro RID é <= alvo e decodifica só ele
+    if (bloco_ + 1 < numBlocos_ && skips_[bloco_ + 1].primeiroRid <= alvo) {
+        std::uint32_t lo = bloco_ + 1, passo = 1, hi = lo;
+        while (hi < numBlocos_ && skips_[hi].primeiroRid <= alvo) {
+            lo = hi;
+            hi = lo + passo;
+            passo *= 2;
+        }
+        hi = std::min(hi, numBlocos_);
+        // skips_[lo] <= alvo; skips_[hi] > alvo (ou fim)
+        while (hi - lo > 1) {
+            std::uint32_t meio = lo + (hi - lo) / 2;
+            if (skips_[meio].primeiroRid <= alvo) lo = meio;
+            else hi = meio;
+        }
+        carregarBloco(lo);
+    }
+
+    // galope dentro do bloco a partir da posição atual
+    std::size_t lo = pos_, passo = 1, hi = pos_;
+    while (hi < buf_.size() && buf_[hi] < alvo) {
+        lo = hi;
+        hi = lo + passo;
+        passo *= 2;
+    }
+    hi = std::min(hi, buf_.size());
+    pos_ = static_cast<std::size_t>(std::lower_bound(buf_.begin() + static_cast<long>(lo), buf_.begin() + static_cast<long>(hi), alvo) - buf_.begin());
+    if (pos_ < buf_.size()) return true;
+
+    // o bloco acabou: o próximo começa depois do alvo
+    if (bloco_ + 1 < numBlocos_) {
+        carregarBloco(bloco_ + 1);
+        return true;
+    }
+    fim_ = true;
+    return false;
+}
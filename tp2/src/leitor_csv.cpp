@@ -0,0 +1,164 @@
+#include "../include/leitor_csv.h"
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// bit i ligado se p[i] é ';', '"' ou '\n'
+std::uint64_t eventosDoBloco(const char* p) {
+#if defined(__SSE2__)
+    const __m128i pontoEVirgula = _mm_set1_epi8(';');
+    const __m128i aspas = _mm_set1_epi8('"');
+    const __m128i quebra = _mm_set1_epi8('\n');
+    std::uint64_t mascara = 0;
+    for (int i = 0; i < 4; ++i) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+        __m128i eventos = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, pontoEVirgula), _mm_cmpeq_epi8(v, aspas)),
+                                       _mm_cmpeq_epi8(v, quebra));
+        mascara |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm_movemask_epi8(eventos))) << (16 * i);
+    }
+    return mascara;
+#else
+    std::uint64_t mascara = 0;
+    for (int i = 0; i < 64; ++i) {
+        if (p[i] == ';' || p[i] == '"' || p[i] == '\n') mascara |= std::uint64_t(1) << i;
+    }
+    return mascara;
+#endif
+}
+
+} // namespace
+
+LeitorCsv::~LeitorCsv() {
+    if (base_) munmap(const_cast<char*>(base_), tamanho_);
+}
+
+bool LeitorCsv::abrir(const std::string& caminho) {
+    int fd = ::open(caminho.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    tamanho_ = static_cast<std::size_t>(st.st_size);
+    if (tamanho_ == 0) { // mmap não aceita tamanho 0; o arquivo só não tem linhas
+        ::close(fd);
+        return true;
+    }
+    void* p = mmap(nullptr, tamanho_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        tamanho_ = 0;
+        return false;
+    }
+    madvise(p, tamanho_, MADV_SEQUENTIAL);
+    base_ = static_cast<const char*>(p);
+    bloco_ = 0;
+    carregarBloco();
+    return true;
+}
+
+void LeitorCsv::carregarBloco() {
+    if (bloco_ + 64 <= tamanho_) {
+        mascara_ = eventosDoBloco(base_ + bloco_);
+        return;
+    }
+    // o último bloco vai para um buffer completado com zeros, para não ler além do mapa
+    char resto[64] = {};
+    std::memcpy(resto, base_ + bloco_, tamanho_ - bloco_);
+    mascara_ = eventosDoBloco(resto);
+}
+
+// Posição do próximo ';', '"' ou '\n' (ou tamanho_ no fim do arquivo)
+std::size_t LeitorCsv::proximoEvento() {
+    while (mascara_ == 0) {
+        bloco_ += 64;
+        if (bloco_ >= tamanho_) return tamanho_;
+        carregarBloco();
+    }
+    std::size_t pos = bloco_ + static_cast<std::size_t>(__builtin_ctzll(mascara_));
+    mascara_ &= mascara_ - 1;
+    return pos;
+}
+
+bool LeitorCsv::proximaLinha(LinhaCsv& linha) {
+    if (pos_ >= tamanho_) return false;
+    linha.numero = ++numeroLinha_;
+    linha.numCampos = 0;
+
+    const std::size_t inicio = pos_;
+    std::size_t ini = inicio, fim = tamanho_;
+    int aspasNoCampo = 0;
+    bool dentroDeAspas = false;
+    bool copiar = false;
+    auto fecharCampo = [&](std::size_t f) {
+        if (linha.numCampos < MAX_CAMPOS_CSV) {
+            trechos_[linha.numCampos] = {ini, f, aspasNoCampo};
+            copiar = copiar || (aspasNoCampo > 0 && !(aspasNoCampo == 2 && base_[ini] == '"' && base_[f - 1] == '"'));
+        }
+        linha.numCampos++;
+    };
+    for (;;) {
+        std::size_t ev = proximoEvento();
+        if (ev >= tamanho_) break; // última linha sem '\n'
+        char c = base_[ev];
+        if (c == '"') {
+            dentroDeAspas = !dentroDeAspas;
+            aspasNoCampo++;
+        } else if (c == ';') {
+            if (dentroDeAspas) continue;
+            fecharCampo(ev);
+            ini = ev + 1;
+            aspasNoCampo = 0;
+        } else {
+            fim = ev;
+            break;
+        }
+    }
+    fecharCampo(fim);
+    pos_ = fim + 1;
+    linha.texto = std::string_view(base_ + inicio, fim - inicio);
+
+    // campos com aspas no meio são copiados sem elas; a linha inteira cabe no
+    // buffer, então ele não realoca enquanto as views da linha estão vivas
+    if (copiar && semAspas_.size() < linha.texto.size()) semAspas_.resize(linha.texto.size());
+    char* saida = semAspas_.data();
+    std::size_t n = linha.numCampos < MAX_CAMPOS_CSV ? linha.numCampos : MAX_CAMPOS_CSV;
+    for (std::size_t i = 0; i < n; ++i) {
+        const Trecho& t = trechos_[i];
+        if (t.aspas == 0) {
+            linha.campos[i] = std::string_view(base_ + t.ini, t.fim - t.ini);
+        } else if (t.aspas == 2 && base_[t.ini] == '"' && base_[t.fim - 1] == '"') {
+            linha.campos[i] = std::string_view(base_ + t.ini + 1, t.fim - t.ini - 2);
+        } else {
+            char* comeco = saida;
+            for (std::size_t j = t.ini; j < t.fim; ++j) {
+                if (base_[j] != '"') *saida++ = base_[j];
+            }
+            linha.campos[i] = std::string_view(comeco, static_cast<std::size_t>(saida - comeco));
+        }
+    }
+    return true;
+}
+
+bool lerInteiro(std::string_view texto, int& valor) {
+    const char* p = texto.data();
+    const char* fim = p + texto.size();
+    while (p < fim && std::isspace(static_cast<unsigned char>(*p))) ++p;
+    // from_chars não aceita '+'
+    if (p < fim && *p == '+') {
+        ++p;
+        if (p < fim && *p == '-') return false;
+    }
+    return std::from_chars(p, fim, valor).ec == std::errc();
+}
@@ -0,0 +1,141 @@
+#include "../include/leitor_registros.h"
+#include "../include/BPlusTree.hpp"
+#include "../include/compressao.h"
+#include "../include/metrics.h"
+#include "../include/projecao.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Lê 'n' bytes em 'offset' repetindo o pread em leituras curtas
+static bool lerTudo(int fd, char* destino, std::size_t n, off_t offset) {
+    while (n > 0) {
+        ssize_t r = pread(fd, destino, n, offset);
+        if (r <= 0) return false;
+        destino += r;
+        n -= static_cast<std::size_t>(r);
+        offset += r;
+    }
+    return true;
+}
+
+LeitorDeRegistros::~LeitorDeRegistros() {
+    if (fdIndice_ >= 0) ::close(fdIndice_);
+    if (fdDados_ >= 0) ::close(fdDados_);
+}
+
+bool LeitorDeRegistros::abrir(const std::string& caminhoIndice, const std::string& caminhoDados,
+                              const DadosComprimidos* comprimidos) {
+    fdIndice_ = ::open(caminhoIndice.c_str(), O_RDONLY);
+    if (fdIndice_ < 0) return false;
+    caminhoIndice_ = caminhoIndice;
+    // páginas de dados de B+ trees com checksum: valor (RID ou ValorProjetado) + CRC32C
+    FileManager::FileHeader cabecalho{};
+    if (lerTudo(fdIndice_, reinterpret_cast<char*>(&cabecalho), sizeof(cabecalho), 0)
+        && cabecalho.checksums == FileManager::CHECKSUM_MAGIC) {
+        tamanhoValor_ = FileManager::valueBytes(cabecalho, cabecalho.projection ? sizeof(ValorProjetado) : sizeof(long));
+    }
+    comprimidos_ = comprimidos && comprimidos->aberto() ? comprimidos : nullptr;
+    origem_ = comprimidos_ ? "copia comprimida de " + caminhoDados : caminhoDados;
+    if (comprimidos_) {
+        totalBlocos_ = comprimidos_->numBlocos();
+        return true;
+    }
+    fdDados_ = ::open(caminhoDados.c_str(), O_RDONLY);
+    if (fdDados_ < 0) return false;
+    struct stat st;
+    if (fstat(fdDados_, &st) != 0) return false;
+    totalBlocos_ = static_cast<std::size_t>(st.st_size) / sizeof(Bloco);
+    // os blocos pedidos por uma consulta não são vizinhos
+    posix_fadvise(fdDados_, 0, 0, POSIX_FADV_RANDOM);
+    return true;
+}
+
+bool LeitorDeRegistros::lerDoIndice(long offset, void* destino, std::size_t tamanho) const {
+    if (fdIndice_ < 0 || offset < 0) return false;
+    if (tamanhoValor_ == 0 || tamanho > tamanhoValor_ || tamanhoValor_ + sizeof(std::uint32_t) > BLOCK_SIZE) {
+        return lerTudo(fdIndice_, static_cast<char*>(destino), tamanho, offset);
+    }
+    // a página inteira (valor + CRC32C) vem na mesma leitura
+    unsigned char pagina[BLOCK_SIZE];
+    std::uint32_t crc;
+    if (!lerTudo(fdIndice_, reinterpret_cast<char*>(pagina), tamanhoValor_ + sizeof(crc), offset)) return false;
+    std::memcpy(&crc, pagina + tamanhoValor_, sizeof(crc));
+    if (crc != crc32c(pagina, tamanhoValor_)) {
+        StorageMetrics::get().checksumFailures.inc();
+        std::cerr << "[ERRO] Checksum invalido na pagina " << offset / BLOCK_SIZE << " de " << caminhoIndice_ << std::endl;
+        return false;
+    }
+    std::memcpy(destino, pagina, tamanho);
+    return true;
+}
+
+void LeitorDeRegistros::lerRids(const std::vector<long>& offsets, std::vector<long>& rids) const {
+    rids.assign(offsets.size(), -1);
+    std::vector<std::size_t> ordem(offsets.size());
+    for (std::size_t i = 0; i < ordem.size(); ++i) ordem[i] = i;
+    std::sort(ordem.begin(), ordem.end(), [&](std::size_t a, std::size_t b) { return offsets[a] < offsets[b]; });
+
+    long anterior = -1;
+    long rid = -1;
+    for (std::size_t i : ordem) {
+        if (offsets[i] != anterior) {
+            anterior = offsets[i];
+            if (!lerDoIndice(offsets[i], &rid, sizeof(rid))) rid = -1;
+        }
+        rids[i] = rid;
+    }
+}
+
+bool LeitorDeRegistros::lerBloco(std::size_t indice, Bloco& bloco) const {
+    if (comprimidos_) {
+        return comprimidos_->lerBloco(indice, bloco) && conferirBloco(bloco, origem_, indice);
+    }
+    return lerTudo(fdDados_, reinterpret_cast<char*>(&bloco), sizeof(Bloco),
+                   static_cast<off_t>(indice * sizeof(Bloco)))
+        && conferirBloco(bloco, origem_, indice);
+}
+
+void LeitorDeRegistros::buscar(const std::vector<long>& rids, std::vector<RegistroLido>& registros) {
+    registros.resize(rids.size());
+    std::vector<std::size_t> ordem;
+    ordem.reserve(rids.size());
+    for (std::size_t i = 0; i < rids.size(); ++i) {
+        registros[i].rid = rids[i];
+        registros[i].estado = REG_FORA_DO_ARQUIVO;
+        if (rids[i] >= 0 && static_cast<std::size_t>(rids[i] / REGISTROS_POR_BLOCO) < totalBlocos_) ordem.push_back(i);
+    }
+    std::sort(ordem.begin(), ordem.end(), [&](std::size_t a, std::size_t b) { return rids[a] < rids[b]; });
+
+    StorageMetrics& metrics = StorageMetrics::get();
+    Bloco bloco;
+    std::size_t blocoAtual = 0;
+    bool temBloco = false, blocoOk = false;
+    for (std::size_t i : ordem) {
+        std::size_t indice = static_cast<std::size_t>(rids[i] / REGISTROS_POR_BLOCO);
+        if (!temBloco || indice != blocoAtual) {
+            blocoAtual = indice;
+            temBloco = true;
+            blocoOk = lerBloco(indice, bloco);
+            if (blocoOk) {
+                blocosLidos_++;
+                metrics.dataFileBlocksRead.inc();
+                metrics.dataFileBytesRead.inc(sizeof(Bloco));
+            }
+        }
+        RegistroLido& reg = registros[i];
+        int posicao = static_cast<int>(rids[i] % REGISTROS_POR_BLOCO);
+        if (!blocoOk) {
+            reg.estado = REG_ERRO_LEITURA;
+        } else if (posicao >= bloco.num_registros_usados || !bloco.artigos[posicao].ocupado) {
+            reg.estado = REG_VAZIO;
+        } else {
+            reg.estado = REG_OK;
+            reg.artigo = bloco.artigos[posicao];
+        }
+    }
+}
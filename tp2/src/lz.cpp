@@ -0,0 +1,133 @@
+#include "../include/lz.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr int BITS_HASH = 14;
+constexpr std::size_t OFFSET_MAX = 65535;
+constexpr std::size_t LITERAIS_FINAIS = 5; // o fim sempre sai como literais
+constexpr std::size_t LIMITE_MATCH = 12;   // não procura matches tão perto do fim
+
+inline std::uint32_t ler32(const char* p) {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline std::uint32_t hash4(std::uint32_t v) {
+    return (v * 2654435761u) >> (32 - BITS_HASH);
+}
+
+inline void escreverTamanho(std::string& out, std::size_t resto) {
+    while (resto >= 255) {
+        out.push_back(static_cast<char>(255));
+        resto -= 255;
+    }
+    out.push_back(static_cast<char>(resto));
+}
+
+void emitirSequencia(std::string& out, const char* literais, std::size_t numLiterais,
+                     std::size_t offset, std::size_t tamMatch) {
+    std::size_t extraMatch = tamMatch ? tamMatch - LZ_MATCH_MIN : 0;
+    unsigned char token = static_cast<unsigned char>((numLiterais >= 15 ? 15 : numLiterais) << 4);
+    if (tamMatch) token |= static_cast<unsigned char>(extraMatch >= 15 ? 15 : extraMatch);
+    out.push_back(static_cast<char>(token));
+    if (numLiterais >= 15) escreverTamanho(out, numLiterais - 15);
+    out.append(literais, numLiterais);
+    if (!tamMatch) return;
+    out.push_back(static_cast<char>(offset & 0xFF));
+    out.push_back(static_cast<char>(offset >> 8));
+    if (extraMatch >= 15) escreverTamanho(out, extraMatch - 15);
+}
+
+// lê uma extensão de tamanho (bytes 255 ... resto); false se a entrada acabou
+inline bool lerTamanho(const unsigned char*& ip, const unsigned char* fim, std::size_t& tam) {
+    unsigned char b;
+    do {
+        if (ip >= fim) return false;
+        b = *ip++;
+        tam += b;
+    } while (b == 255);
+    return true;
+}
+
+} // namespace
+
+std::size_t lzComprimir(const char* src, std::size_t n, std::string& saida) {
+    std::size_t inicioSaida = saida.size();
+    std::size_t ancora = 0;
+    if (n > LIMITE_MATCH) {
+        std::vector<std::uint32_t> tabela(std::size_t(1) << BITS_HASH, 0); // posição + 1 (0 = vazio)
+        const std::size_t limite = n - LIMITE_MATCH;
+        const std::size_t fimMatch = n - LITERAIS_FINAIS;
+        std::size_t ip = 0;
+        std::size_t falhas = 0;
+        while (ip < limite) {
+            std::uint32_t seq = ler32(src + ip);
+            std::uint32_t& slot = tabela[hash4(seq)];
+            std::size_t ref = slot;
+            slot = static_cast<std::uint32_t>(ip + 1);
+            if (ref == 0 || ip - (ref - 1) > OFFSET_MAX || ler32(src + ref - 1) != seq) {
+                // sem match: avança mais rápido em trechos que não comprimem
+                ip += 1 + (falhas++ >> 6);
+                continue;
+            }
+            falhas = 0;
+            ref -= 1;
+
+            std::size_t tam = LZ_MATCH_MIN;
+            while (ip + tam < fimMatch && src[ref + tam] == src[ip + tam]) ++tam;
+            // estende para trás sobre literais pendentes
+            while (ip > ancora && ref > 0 && src[ip - 1] == src[ref - 1]) {
+                --ip;
+                --ref;
+                ++tam;
+            }
+
+            emitirSequencia(saida, src + ancora, ip - ancora, ip - ref, tam);
+            ip += tam;
+            ancora = ip;
+            if (ip >= 2 && ip - 2 < limite) tabela[hash4(ler32(src + ip - 2))] = static_cast<std::uint32_t>(ip - 1);
+        }
+    }
+    emitirSequencia(saida, src + ancora, n - ancora, 0, 0);
+    return saida.size() - inicioSaida;
+}
+
+long lzDescomprimir(const unsigned char* src, std::size_t n, char* dst, std::size_t cap, std::size_t necessario) {
+    const unsigned char* ip = src;
+    const unsigned char* fim = src + n;
+    std::size_t op = 0;
+    while (ip < fim && op < necessario) {
+        unsigned char token = *ip++;
+        std::size_t numLiterais = token >> 4;
+        if (numLiterais == 15 && !lerTamanho(ip, fim, numLiterais)) return -1;
+        if (numLiterais > static_cast<std::size_t>(fim - ip) || numLiterais > cap - op) return -1;
+        std::memcpy(dst + op, ip, numLiterais);
+        ip += numLiterais;
+        op += numLiterais;
+        if (ip == fim) break; // última sequência: só literais
+
+        if (fim - ip < 2) return -1;
+        std::size_t offset = ip[0] | (static_cast<std::size_t>(ip[1]) << 8);
+        ip += 2;
+        std::size_t tam = token & 0x0F;
+        if (tam == 15 && !lerTamanho(ip, fim, tam)) return -1;
+        tam += LZ_MATCH_MIN;
+        if (offset == 0 || offset > op || tam > cap - op) return -1;
+
+        char* d = dst + op;
+        const char* s = d - offset;
+        if (offset >= tam) {
+            std::memcpy(d, s, tam);
+        } else if (offset == 1) {
+            std::memset(d, *s, tam); // sequência de um byte só (preenchimento)
+        } else {
+            for (std::size_t i = 0; i < tam; ++i) d[i] = s[i]; // sobreposto: repete o padrão
+        }
+        op += tam;
+    }
+    return static_cast<long>(op);
+}
@@ -0,0 +1,337 @@
+#include "../include/manutencao.h"
+#include "../include/BPlusTree.hpp"
+#include "../include/ano_citacoes.h"
+#include "../include/aprendido.h"
+#include "../include/bloom.h"
+#include "../include/compressao.h"
+#include "../include/config.h"
+#include "../include/hashing_file.h"
+#include "../include/invertido.h"
+#include "../include/prefixo.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+
+static std::string trim(const std::string& s) {
+    std::size_t start = s.find_first_not_of(" \t\n\r");
+    if (start == std::string::npos) return "";
+    std::size_t end = s.find_last_not_of(" \t\n\r");
+    return s.substr(start, end - start + 1);
+}
+
+static std::size_t remapearIndice(const std::string& caminho, const std::vector<long>& novoRid) {
+    BPlusTree<long> idx(caminho);
+    std::size_t alterados = 0;
+    idx.forEachValue([&](int, long& rid) {
+        if (rid < 0 || static_cast<std::size_t>(rid) >= novoRid.size()) return false;
+        long novo = novoRid[rid];
+        if (novo < 0 || novo == rid) return false;
+        rid = novo;
+        alterados++;
+        return true;
+    });
+    return alterados;
+}
+
+bool remapearRids(const std::vector<long>& novoRid, const Caminhos& c) {
+    std::size_t prim = remapearIndice(c.primario, novoRid);
+    std::cout << "[INFO] Indice primario: " << prim << " RIDs atualizados" << std::endl;
+    std::size_t sec = remapearIndice(c.secundario, novoRid);
+    std::cout << "[INFO] Indice secundario: " << sec << " RIDs atualizados" << std::endl;
+    return true;
+}
+
+bool reconstruirBlooms(const Caminhos& c) {
+    std::ifstream in(c.dados, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "[ERRO] Não foi possível abrir " << c.dados << "\n";
+        return false;
+    }
+
+    std::vector<std::uint64_t> ids;
+    std::vector<std::uint64_t> titulos;
+    Bloco bloco{};
+    std::size_t blocoIndex = 0;
+    while (in.read(reinterpret_cast<char*>(&bloco), sizeof(Bloco))) {
+        if (!conferirBloco(bloco, c.dados, blocoIndex++)) return false;
+        for (int i = 0; i < bloco.num_registros_usados && i < REGISTROS_POR_BLOCO; ++i) {
+            const Artigo& art = bloco.artigos[i];
+            if (!art.ocupado) continue;
+            ids.push_back(bloomHashId(art.id));
+            std::string norm = trim(art.titulo);
+            if (!norm.empty()) titulos.push_back(bloomHashTitulo(norm));
+        }
+    }
+
+    // folga de 25% para os appends não forçarem uma reconstrução logo em seguida
+    double fpr = bloomFprFromEnv();
+    BloomFilter porId, porTitulo;
+    porId.criar(ids.size() + ids.size() / 4 + 1024, fpr);
+    for (std::uint64_t h : ids) porId.add(h);
+    porTitulo.criar(titulos.size() + titulos.size() / 4 + 1024, fpr);
+    for (std::uint64_t h : titulos) porTitulo.add(h);
+
+    if (!porId.salvar(c.bloomId) || !porTitulo.salvar(c.bloomTitulo)) {
+        std::cerr << "[ERRO] Não foi possível gravar os Bloom filters em " << c.dbDir << "\n";
+        return false;
+    }
+    std::cout << "[INFO] Bloom filters (fpr=" << fpr << ", k=" << porId.hashes() << "): "
+              << ids.size() << " IDs em " << porId.tamanhoBytes() / 1024 << " KB, "
+              << titulos.size() << " titulos em " << porTitulo.tamanhoBytes() / 1024 << " KB" << std::endl;
+    return true;
+}
+
+struct EntradaRanking {
+    int ano;
+    int citacoes;
+    int id;
+};
+
+// Entradas (chave, payload) do índice ano/citações na ordem (ano, citacoes desc, id)
+static std::vector<std::pair<int, long>> chavesDoRanking(std::vector<EntradaRanking>& entradas) {
+    std::sort(entradas.begin(), entradas.end(), [](const EntradaRanking& a, const EntradaRanking& b) {
+        if (a.ano != b.ano) return a.ano < b.ano;
+        if (a.citacoes != b.citacoes) return a.citacoes > b.citacoes;
+        return a.id < b.id;
+    });
+    std::vector<std::pair<int, long>> chaves;
+    chaves.reserve(entradas.size());
+    for (const EntradaRanking& e : entradas) {
+        chaves.push_back({chaveAnoCitacoes(e.ano, e.citacoes), empacotarIdCitacoes(e.id, e.citacoes)});
+    }
+    return chaves;
+}
+
+// Monta o índice (ano, citacoes desc, id) do zero em um arquivo temporário e o
+// troca de uma vez, como os demais índices derivados
+static bool gravarIndiceAnoCitacoes(std::vector<EntradaRanking>& entradas, const std::string& caminho) {
+    std::vector<std::pair<int, long>> chaves = chavesDoRanking(entradas);
+
+    std::string tmp = caminho + ".tmp";
+    std::remove(tmp.c_str());
+    {
+        BPlusTree<long> arvore(tmp);
+        if (!arvore.bulkLoadPayloads(chaves)) return false;
+    }
+    return std::rename(tmp.c_str(), caminho.c_str()) == 0;
+}
+
+bool reconstruirIndicesDerivados(const Caminhos& c) {
+    std::ifstream in(c.dados, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "[ERRO] Não foi possível abrir " << c.dados << "\n";
+        return false;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    InvertidoBuilder invertido;
+    PrefixoBuilder prefixo;
+    InvertidoBuilder autores;
+    std::vector<std::string> nomes;
+    std::vector<EntradaRanking> ranking;
+    std::vector<std::pair<int, long>> idsRids;
+    CompressorDeDados compressor;
+    bool comprimir = compressaoDadosAtiva(c.comprimidos);
+    if (comprimir && !compressor.iniciar(c.comprimidos)) {
+        std::cerr << "[ERRO] Não foi possível criar " << c.comprimidos << "\n";
+        return false;
+    }
+    Bloco bloco{};
+    long blocoIndex = 0;
+    while (in.read(reinterpret_cast<char*>(&bloco), sizeof(Bloco))) {
+        if (!conferirBloco(bloco, c.dados, static_cast<std::size_t>(blocoIndex))) return false;
+        if (comprimir && !compressor.adicionarBloco(bloco)) {
+            std::cerr << "[ERRO] Falha ao gravar " << c.comprimidos << "\n";
+            return false;
+        }
+        for (int i = 0; i < bloco.num_registros_usados && i < REGISTROS_POR_BLOCO; ++i) {
+            const Artigo& art = bloco.artigos[i];
+            if (!art.ocupado) continue;
+            long rid = blocoIndex * REGISTROS_POR_BLOCO + i;
+            invertido.adicionar(rid, art);
+            prefixo.adicionar(rid, art);
+            nomes.clear();
+            extrairAutores(art.autores, sizeof(art.autores), nomes);
+            if (!nomes.empty()) autores.adicionarTermos(rid, nomes);
+            ranking.push_back({art.ano, art.citacoes, art.id});
+            idsRids.push_back({art.id, rid});
+        }
+        blocoIndex++;
+    }
+
+    if (!invertido.gravar(c.invertido)) {
+        std::cerr << "[ERRO] Não foi possível gravar " << c.invertido << "\n";
+        return false;
+    }
+    std::cout << "[INFO] Indice invertido: " << invertido.numTermos() << " termos, "
+              << invertido.numPostings() << " postings de " << invertido.numDocs() << " registros" << std::endl;
+
+    if (!prefixo.gravar(c.prefixo)) {
+        std::cerr << "[ERRO] Não foi possível gravar " << c.prefixo << "\n";
+        return false;
+    }
+    std::cout << "[INFO] Indice de prefixos: " << prefixo.numTitulos() << " titulos distintos, "
+              << prefixo.bytesGravados() / 1024 << " KB (titulos brutos: " << prefixo.bytesBrutos() / 1024 << " KB)" << std::endl;
+
+    if (!autores.gravar(c.autores)) {
+        std::cerr << "[ERRO] Não foi possível gravar " << c.autores << "\n";
+        return false;
+    }
+    std::cout << "[INFO] Indice de autores: " << autores.numTermos() << " autores, "
+              << autores.numPostings() << " postings de " << autores.numDocs() << " registros" << std::endl;
+
+    if (!gravarIndiceAnoCitacoes(ranking, c.anoCitacoes)) {
+        std::cerr << "[ERRO] Não foi possível gravar " << c.anoCitacoes << "\n";
+        return false;
+    }
+    std::cout << "[INFO] Indice ano/citacoes: " << ranking.size() << " artigos" << std::endl;
+
+    std::sort(idsRids.begin(), idsRids.end());
+    idsRids.erase(std::unique(idsRids.begin(), idsRids.end(),
+                              [](const std::pair<int, long>& a, const std::pair<int, long>& b) { return a.first == b.first; }),
+                  idsRids.end());
+    std::size_t segmentos = 0;
+    if (!gravarIndiceAprendido(idsRids, c.aprendidoModelo, c.aprendidoArranjo, &segmentos)) {
+        std::cerr << "[ERRO] Não foi possível gravar " << c.aprendidoModelo << "\n";
+        return false;
+    }
+    std::cout << "[INFO] Indice aprendido: " << idsRids.size() << " IDs em " << segmentos
+              << " segmentos (erro maximo " << ERRO_APRENDIDO << ")" << std::endl;
+
+    if (comprimir) {
+        if (!compressor.finalizar()) {
+            std::cerr << "[ERRO] Não foi possível gravar " << c.comprimidos << "\n";
+            return false;
+        }
+        std::cout << "[INFO] Dados comprimidos: " << compressor.numBlocos() << " blocos, "
+                  << compressor.bytesOriginais() / 1024 << " KB -> " << compressor.bytesComprimidos() / 1024 << " KB" << std::endl;
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "[INFO] Indices derivados reconstruidos em "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms" << std::endl;
+    return true;
+}
+
+bool atualizarIndicesDerivados(const Caminhos& c, DeltaDeAppend& delta) {
+    if (delta.rids.empty() && delta.blocosGravados.empty()) return true;
+    auto refazer = [&](const std::string& motivo) {
+        std::cerr << "[AVISO] " << motivo << "; reconstruindo os indices derivados a partir de " << c.dados << std::endl;
+        return reconstruirIndicesDerivados(c);
+    };
+    std::ifstream in(c.dados, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "[ERRO] Não foi possível abrir " << c.dados << "\n";
+        return false;
+    }
+
+    std::sort(delta.rids.begin(), delta.rids.end());
+    delta.rids.erase(std::unique(delta.rids.begin(), delta.rids.end()), delta.rids.end());
+    // com o delta tocando mais da metade dos registros, retirar e intercalar
+    // custa mais que a varredura completa
+    in.seekg(0, std::ios::end);
+    std::size_t registros = static_cast<std::size_t>(in.tellg()) / sizeof(Bloco) * REGISTROS_POR_BLOCO;
+    if (delta.rids.size() * 2 > registros) return reconstruirIndicesDerivados(c);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    InvertidoBuilder invertido;
+    PrefixoBuilder prefixo;
+    InvertidoBuilder autores;
+    std::vector<std::string> nomes;
+    for (const auto& par : delta.anteriores) {
+        const Artigo& anterior = par.second;
+        invertido.retirar(par.first, anterior);
+        prefixo.retirar(par.first);
+        nomes.clear();
+        extrairAutores(anterior.autores, sizeof(anterior.autores), nomes);
+        if (!nomes.empty()) autores.retirarTermos(par.first, nomes);
+    }
+
+    // só os registros do delta, em ordem de RID (um bloco lido por vez)
+    std::vector<EntradaRanking> rankingNovo;
+    std::vector<std::pair<int, long>> rankingRetirado;
+    std::vector<std::pair<int, long>> idsNovos;
+    Bloco bloco{};
+    long blocoLido = -1;
+    for (long rid : delta.rids) {
+        long blocoIndex = rid / REGISTROS_POR_BLOCO;
+        if (blocoIndex != blocoLido) {
+            in.seekg(blocoIndex * static_cast<long>(sizeof(Bloco)));
+            if (!in.read(reinterpret_cast<char*>(&bloco), sizeof(Bloco)) ||
+                !conferirBloco(bloco, c.dados, static_cast<std::size_t>(blocoIndex))) {
+                std::cerr << "[ERRO] Não foi possível ler o bloco " << blocoIndex << " de " << c.dados << "\n";
+                return false;
+            }
+            blocoLido = blocoIndex;
+        }
+        const Artigo& art = bloco.artigos[rid % REGISTROS_POR_BLOCO];
+        if (!art.ocupado) continue;
+        invertido.adicionar(rid, art);
+        prefixo.adicionar(rid, art);
+        nomes.clear();
+        extrairAutores(art.autores, sizeof(art.autores), nomes);
+        if (!nomes.empty()) autores.adicionarTermos(rid, nomes);
+
+        auto anterior = delta.anteriores.find(rid);
+        if (anterior == delta.anteriores.end()) {
+            rankingNovo.push_back({art.ano, art.citacoes, art.id});
+            idsNovos.push_back({art.id, rid});
+        } else if (anterior->second.ano != art.ano || anterior->second.citacoes != art.citacoes) {
+            const Artigo& a = anterior->second;
+            rankingRetirado.push_back({chaveAnoCitacoes(a.ano, a.citacoes), empacotarIdCitacoes(a.id, a.citacoes)});
+            rankingNovo.push_back({art.ano, art.citacoes, art.id});
+        }
+    }
+
+    if (!invertido.mesclar(c.invertido)) return refazer("Indice invertido " + c.invertido + " ausente ou invalido");
+    std::cout << "[INFO] Indice invertido: " << invertido.numPostings() << " postings de " << invertido.numDocs()
+              << " registros intercaladas" << std::endl;
+
+    if (!prefixo.mesclar(c.prefixo)) return refazer("Indice de prefixos " + c.prefixo + " ausente ou invalido");
+    std::cout << "[INFO] Indice de prefixos: " << prefixo.numTitulos() << " titulos distintos, "
+              << prefixo.bytesGravados() / 1024 << " KB" << std::endl;
+
+    if (!autores.mesclar(c.autores)) return refazer("Indice de autores " + c.autores + " ausente ou invalido");
+    std::cout << "[INFO] Indice de autores: " << autores.numPostings() << " postings de " << autores.numDocs()
+              << " registros intercaladas" << std::endl;
+
+    // o construtor da árvore criaria um índice vazio no lugar do que falta
+    if (access(c.anoCitacoes.c_str(), F_OK) != 0) return refazer("Indice " + c.anoCitacoes + " ausente");
+    {
+        BPlusTree<long> arvore(c.anoCitacoes);
+        for (const auto& e : rankingRetirado) {
+            if (!arvore.removePayload(e.first, e.second)) return refazer("Indice " + c.anoCitacoes + " sem a entrada do ID " + std::to_string(idDoPayload(e.second)));
+        }
+        arvore.insertSortedPayloads(chavesDoRanking(rankingNovo));
+    }
+    std::cout << "[INFO] Indice ano/citacoes: " << rankingNovo.size() << " chaves inseridas, "
+              << rankingRetirado.size() << " removidas" << std::endl;
+
+    std::sort(idsNovos.begin(), idsNovos.end());
+    idsNovos.erase(std::unique(idsNovos.begin(), idsNovos.end(),
+                               [](const std::pair<int, long>& a, const std::pair<int, long>& b) { return a.first == b.first; }),
+                   idsNovos.end());
+    std::size_t segmentos = 0, entradas = 0;
+    if (!mesclarIndiceAprendido(idsNovos, c.aprendidoModelo, c.aprendidoArranjo, &segmentos, &entradas)) {
+        return refazer("Indice aprendido " + c.aprendidoModelo + " ausente ou invalido");
+    }
+    std::cout << "[INFO] Indice aprendido: " << idsNovos.size() << " IDs novos, " << entradas << " IDs em "
+              << segmentos << " segmentos" << std::endl;
+
+    if (compressaoDadosAtiva(c.comprimidos)) {
+        CompressorDeDados compressor;
+        if (!compressor.atualizar(c.comprimidos, c.dados, delta.tamanhoAnterior, delta.blocosGravados)) {
+            return refazer("Copia comprimida " + c.comprimidos + " ausente ou desatualizada");
+        }
+        std::cout << "[INFO] Dados comprimidos: " << delta.blocosGravados.size() << " blocos gravados pelo delta, "
+                  << compressor.numBlocos() << " blocos, " << compressor.bytesComprimidos() / 1024 << " KB" << std::endl;
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "[INFO] Indices derivados atualizados com " << delta.rids.size() << " registros do delta em "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms" << std::endl;
+    return true;
+}
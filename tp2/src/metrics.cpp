@@ -0,0 +1,321 @@
+#include "../include/metrics.h"
+#include "../include/config.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static void dumpJsonAtExit() {
+    std::string destino = getEnv("METRICS_JSON", "");
+    if (destino.empty()) return;
+    if (destino == "-") {
+        MetricsRegistry::instance().writeJson(std::cerr);
+        return;
+    }
+    std::ofstream out(destino);
+    if (out.is_open()) MetricsRegistry::instance().writeJson(out);
+}
+
+int Histogram::bucketOf(std::uint64_t v) {
+    if (v < static_cast<std::uint64_t>(SUB_COUNT)) return static_cast<int>(v);
+    int e = 63 - __builtin_clzll(v); // e >= SUB_BITS
+    int sub = static_cast<int>(v >> (e - SUB_BITS)) - SUB_COUNT;
+    return (e - SUB_BITS + 1) * SUB_COUNT + sub;
+}
+
+std::uint64_t Histogram::highestIn(int bucket) {
+    if (bucket < SUB_COUNT) return static_cast<std::uint64_t>(bucket);
+    int e = bucket / SUB_COUNT + SUB_BITS - 1;
+    std::uint64_t sub = static_cast<std::uint64_t>(bucket % SUB_COUNT);
+    std::uint64_t lower = (static_cast<std::uint64_t>(SUB_COUNT) + sub) << (e - SUB_BITS);
+    return lower + ((std::uint64_t{1} << (e - SUB_BITS)) - 1);
+}
+
+void Histogram::record(std::uint64_t v) {
+    buckets_[bucketOf(v)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(v, std::memory_order_relaxed);
+    std::uint64_t atual = max_.load(std::memory_order_relaxed);
+    while (v > atual && !max_.compare_exchange_weak(atual, v, std::memory_order_relaxed)) {
+    }
+}
+
+std::uint64_t Histogram::percentile(double p) const {
+    std::uint64_t total = count();
+    if (total == 0) return 0;
+    std::uint64_t alvo = static_cast<std::uint64_t>(p / 100.0 * static_cast<double>(total) + 0.5);
+    if (alvo < 1) alvo = 1;
+    std::uint64_t acumulado = 0;
+    for (int b = 0; b < BUCKETS; ++b) {
+        acumulado += buckets_[b].load(std::memory_order_relaxed);
+        if (acumulado >= alvo) return std::min(highestIn(b), max());
+    }
+    return max();
+}
+
+MetricsRegistry& MetricsRegistry::instance() {
+    static MetricsRegistry registry;
+    // registrado depois da construção: roda antes da destruição do registro
+    static bool registered = (std::atexit(dumpJsonAtExit) == 0);
+    (void)registered;
+    return registry;
+}
+
+MetricsRegistry::Entry& MetricsRegistry::find(const std::string& name, const std::string& help, Kind kind) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry* achada = nullptr;
+    for (Entry& e : entries_) {
+        if (e.name == name) {
+            achada = &e;
+            break;
+        }
+    }
+    if (!achada) {
+        entries_.emplace_back();
+        achada = &entries_.back();
+        achada->name = name;
+        achada->help = help;
+        achada->kind = kind;
+    }
+    // mesmo nome pedido com outro tipo: devolve um instrumento que não é exportado
+    Entry& e = *achada;
+    if (kind == Kind::Counter && !e.counter) e.counter.reset(new Counter());
+    if (kind == Kind::Gauge && !e.gauge) e.gauge.reset(new Gauge());
+    if (kind == Kind::Histogram && !e.histogram) e.histogram.reset(new Histogram());
+    return e;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help) {
+    return *find(name, help, Kind::Counter).counter;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help) {
+    return *find(name, help, Kind::Gauge).gauge;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help) {
+    return *find(name, help, Kind::Histogram).histogram;
+}
+
+static const double QUANTIS[] = {50.0, 90.0, 99.0, 99.9};
+
+void MetricsRegistry::writeJson(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const char* secoes[] = {"{\"counters\": {", ", \"gauges\": {", ", \"histograms\": {"};
+    const Kind tipos[] = {Kind::Counter, Kind::Gauge, Kind::Histogram};
+    for (int pass = 0; pass < 3; ++pass) {
+        out << secoes[pass];
+        bool first = true;
+        for (const Entry& e : entries_) {
+            if (e.kind != tipos[pass]) continue;
+            out << (first ? "" : ", ") << "\"" << e.name << "\": ";
+            first = false;
+            if (e.kind == Kind::Counter) {
+                out << e.counter->value();
+            } else if (e.kind == Kind::Gauge) {
+                out << e.gauge->value();
+            } else {
+                const Histogram& h = *e.histogram;
+                out << "{\"count\": " << h.count() << ", \"mean\": " << static_cast<long long>(h.mean())
+                    << ", \"p50\": " << h.percentile(50.0) << ", \"p90\": " << h.percentile(90.0)
+                    << ", \"p99\": " << h.percentile(99.0) << ", \"p999\": " << h.percentile(99.9)
+                    << ", \"max\": " << h.max() << "}";
+            }
+        }
+        out << "}";
+    }
+    out << "}\n";
+}
+
+void MetricsRegistry::writePrometheus(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Entry& e : entries_) {
+        out << "# HELP " << e.name << " " << e.help << "\n";
+        if (e.kind == Kind::Histogram) {
+            // exportado como summary: os quantis já vêm calculados
+            const Histogram& h = *e.histogram;
+            out << "# TYPE " << e.name << " summary\n";
+            for (double q : QUANTIS) {
+                out << e.name << "{quantile=\"" << q / 100.0 << "\"} " << h.percentile(q) << "\n";
+            }
+            out << e.name << "_sum " << h.sum() << "\n";
+            out << e.name << "_count " << h.count() << "\n";
+            continue;
+        }
+        out << "# TYPE " << e.name << (e.kind == Kind::Counter ? " counter\n" : " gauge\n");
+        out << e.name << " ";
+        if (e.kind == Kind::Counter) out << e.counter->value();
+        else out << e.gauge->value();
+        out << "\n";
+    }
+}
+
+StorageMetrics& StorageMetrics::get() {
+    static StorageMetrics m = [] {
+        MetricsRegistry& r = MetricsRegistry::instance();
+        return StorageMetrics{
+            r.counter("bptree_node_reads_total", "Nos da B+ tree lidos"),
+            r.counter("bptree_node_writes_total", "Nos da B+ tree escritos"),
+            r.counter("bptree_data_reads_total", "Paginas de dados da B+ tree lidas"),
+            r.counter("bptree_data_writes_total", "Paginas de dados da B+ tree escritas"),
+            r.counter("bptree_bytes_read_total", "Bytes lidos dos arquivos de indice B+"),
+            r.counter("bptree_bytes_written_total", "Bytes escritos nos arquivos de indice B+"),
+            r.counter("bptree_seeks_total", "Reposicionamentos nos arquivos de indice B+"),
+            r.counter("bptree_flushes_total", "Flushes nos arquivos de indice B+"),
+            r.counter("bptree_leaf_splits_total", "Divisoes de folha"),
+            r.counter("bptree_internal_splits_total", "Divisoes de no interno"),
+            r.counter("bptree_borrows_total", "Redistribuicoes entre irmaos na remocao"),
+            r.counter("bptree_merges_total", "Fusoes de nos na remocao"),
+            r.counter("bptree_pages_allocated_total", "Paginas alocadas no fim do arquivo"),
+            r.counter("bptree_pages_reused_total", "Paginas reaproveitadas da lista livre"),
+            r.counter("bptree_pages_freed_total", "Paginas devolvidas a lista livre"),
+            r.counter("bptree_prefetches_total", "Paginas antecipadas com posix_fadvise nas varreduras"),
+
+            r.counter("hash_blocks_read_total", "Blocos de artigos.dat lidos pelo HashingFile"),
+            r.counter("hash_blocks_written_total", "Blocos de artigos.dat escritos pelo HashingFile"),
+            r.counter("hash_bytes_read_total", "Bytes lidos de artigos.dat pelo HashingFile"),
+            r.counter("hash_bytes_written_total", "Bytes escritos em artigos.dat pelo HashingFile"),
+            r.counter("hash_seeks_total", "Reposicionamentos em artigos.dat"),
+            r.counter("hash_flushes_total", "Flushes em artigos.dat"),
+            r.counter("hash_writes_total", "Escritas em artigos.dat (um bloco ou uma sequencia de blocos contiguos)"),
+            r.counter("hash_buffer_hits_total", "Blocos lidos do buffer de escrita da carga, sem ir ao disco"),
+            r.counter("hash_table_reads_total", "Leituras de entradas da tabela hash"),
+            r.counter("hash_table_writes_total", "Escritas de entradas da tabela hash"),
+            r.counter("hash_chain_hops_total", "Saltos para o proximo bloco de uma cadeia de overflow"),
+            r.counter("hash_overflow_blocks_total", "Blocos de overflow criados"),
+            r.counter("hash_inserts_total", "Registros inseridos"),
+            r.counter("hash_updates_total", "Registros atualizados no lugar"),
+            r.counter("hash_removals_total", "Registros removidos"),
+            r.counter("hash_lookups_total", "Buscas por ID"),
+            r.counter("hash_lookup_misses_total", "Buscas por ID sem resultado"),
+
+            r.counter("datafile_blocks_read_total", "Blocos de artigos.dat lidos por RID"),
+            r.counter("datafile_bytes_read_total", "Bytes de artigos.dat lidos por RID"),
+            r.counter("datafile_lz_groups_decoded_total", "Grupos de artigos.lz descomprimidos"),
+            r.counter("datafile_lz_bytes_read_total", "Bytes comprimidos de artigos.lz lidos"),
+
+            r.counter("bloom_checks_total", "Consultas aos Bloom filters"),
+            r.counter("bloom_negatives_total", "Consultas descartadas pelo Bloom filter sem I/O nos indices"),
+
+            r.counter("scan_blocks_read_total", "Blocos de artigos.dat lidos pela varredura"),
+            r.counter("scan_bytes_read_total", "Bytes de artigos.dat lidos pela varredura"),
+            r.counter("scan_records_matched_total", "Registros aceitos pelos predicados da varredura"),
+
+            r.counter("checksum_failures_total", "Paginas lidas com checksum CRC32C invalido"),
+        };
+    }();
+    return m;
+}
+
+QueryTimings QueryTimings::forTool(const std::string& tool) {
+    MetricsRegistry& r = MetricsRegistry::instance();
+    return QueryTimings{
+        r.histogram(tool + "_index_ns", "Latencia da busca no indice (ns)"),
+        r.histogram(tool + "_rid_ns", "Latencia da leitura do RID (ns)"),
+        r.histogram(tool + "_fetch_ns", "Latencia da leitura do bloco de dados (ns)"),
+        r.histogram(tool + "_output_ns", "Latencia da formatacao da saida (ns)"),
+        r.histogram(tool + "_total_ns", "Latencia total da consulta (ns)"),
+    };
+}
+
+void QueryTimings::printSummary(std::ostream& out) const {
+    const std::pair<const char*, const Histogram*> fases[] = {
+        {"indice", &index}, {"rid", &rid}, {"dados", &fetch}, {"saida", &output}, {"total", &total}};
+    auto us = [](std::uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+
+    out << "\n=== LATENCIA POR FASE (us) ===" << std::endl;
+    out << std::left << std::setw(8) << "fase" << std::right << std::setw(10) << "n"
+        << std::setw(11) << "media" << std::setw(11) << "p50" << std::setw(11) << "p90"
+        << std::setw(11) << "p99" << std::setw(11) << "p99.9" << std::setw(11) << "max" << std::endl;
+    out << std::fixed << std::setprecision(1);
+    for (const auto& f : fases) {
+        const Histogram& h = *f.second;
+        if (h.count() == 0) continue;
+        out << std::left << std::setw(8) << f.first << std::right << std::setw(10) << h.count()
+            << std::setw(11) << h.mean() / 1000.0;
+        for (double q : QUANTIS) out << std::setw(11) << us(h.percentile(q));
+        out << std::setw(11) << us(h.max()) << std::endl;
+    }
+    out << std::defaultfloat;
+}
+
+// Servidor HTTP mínimo: toda requisição recebe o texto do Prometheus
+static void serveMetrics(int listenFd) {
+    int esperaMs = 0;
+    while (true) {
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                // sem descritores ou memória: espera (dobrando, até 1 s) em vez de girar no accept
+                esperaMs = std::min(esperaMs ? esperaMs * 2 : 10, 1000);
+                std::this_thread::sleep_for(std::chrono::milliseconds(esperaMs));
+                continue;
+            }
+            std::cerr << "[WARN] Servidor de metricas encerrado: accept falhou (" << std::strerror(errno) << ")" << std::endl;
+            close(listenFd);
+            return;
+        }
+        esperaMs = 0;
+
+        char req[1024];
+        (void)read(fd, req, sizeof(req)); // a requisição é ignorada
+
+        std::ostringstream body;
+        MetricsRegistry::instance().writePrometheus(body);
+        std::string corpo = body.str();
+        std::ostringstream resp;
+        resp << "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: "
+             << corpo.size() << "\r\nConnection: close\r\n\r\n" << corpo;
+        std::string s = resp.str();
+        std::size_t enviado = 0;
+        while (enviado < s.size()) {
+            ssize_t n = write(fd, s.data() + enviado, s.size() - enviado);
+            if (n <= 0) break;
+            enviado += static_cast<std::size_t>(n);
+        }
+        close(fd);
+    }
+}
+
+void startMetricsServerFromEnv() {
+    static bool started = false;
+    std::string porta = getEnv("METRICS_PORT", "");
+    if (started || porta.empty()) return;
+    started = true;
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        std::cerr << "[WARN] Nao foi possivel criar o socket de metricas" << std::endl;
+        return;
+    }
+    int um = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &um, sizeof(um));
+
+    // só loopback, a menos que METRICS_ADDR exponha outra interface (ex.: 0.0.0.0 no container)
+    std::string endereco = getEnv("METRICS_ADDR", "127.0.0.1");
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(std::atoi(porta.c_str())));
+    if (inet_pton(AF_INET, endereco.c_str(), &addr.sin_addr) != 1) {
+        std::cerr << "[WARN] METRICS_ADDR invalido: " << endereco << std::endl;
+        close(fd);
+        return;
+    }
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, 16) != 0) {
+        std::cerr << "[WARN] Nao foi possivel escutar em " << endereco << ":" << porta << " para as metricas" << std::endl;
+        close(fd);
+        return;
+    }
+    std::cerr << "[INFO] Metricas Prometheus em http://" << endereco << ":" << porta << "/metrics" << std::endl;
+    std::thread(serveMetrics, fd).detach();
+}
@@ -0,0 +1,180 @@
+#include "../include/particoes.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <sys/stat.h>
+#include <thread>
+
+namespace {
+
+// diretórios de dados das partições; vazio = base sem partições
+std::vector<std::string>& diretorios() {
+    static std::vector<std::string> dirs = [] {
+        std::vector<std::string> lidos;
+        std::ifstream in(SHARDS_LST);
+        std::string linha;
+        while (std::getline(in, linha)) {
+            if (!linha.empty()) lidos.push_back(linha);
+        }
+        return lidos;
+    }();
+    return dirs;
+}
+
+bool criarDiretorio(const std::string& caminho) {
+    return ::mkdir(caminho.c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+std::string nomeDoArquivo(const std::string& caminho) {
+    std::size_t barra = caminho.find_last_of('/');
+    return barra == std::string::npos ? caminho : caminho.substr(barra + 1);
+}
+
+// ID do primeiro campo da linha, sem aspas nem espaços; false se não for número
+bool idDaLinha(const std::string& linha, int& id) {
+    std::size_t fim = linha.find(';');
+    std::string campo = linha.substr(0, fim);
+    std::size_t ini = campo.find_first_not_of(" \t\r\"");
+    if (ini == std::string::npos) return false;
+    std::size_t ult = campo.find_last_not_of(" \t\r\"");
+    campo = campo.substr(ini, ult - ini + 1);
+    char* resto = nullptr;
+    long valor = std::strtol(campo.c_str(), &resto, 10);
+    if (resto == campo.c_str() || *resto != '\0') return false;
+    id = static_cast<int>(valor);
+    return true;
+}
+
+} // namespace
+
+int numParticoes() {
+    std::size_t n = diretorios().size();
+    return n == 0 ? 1 : static_cast<int>(n);
+}
+
+Caminhos caminhosDaParticao(int k) {
+    const std::vector<std::string>& dirs = diretorios();
+    if (dirs.empty()) return caminhosEm(DATA_DIR, DB_DIR);
+    return caminhosEm(dirs[k], dirs[k] + "/db");
+}
+
+int particaoDoId(int id, int total) {
+    if (total <= 1) return 0;
+    // finalizador do murmur3: a tabela hash de cada partição usa id % T, então
+    // a partição não pode depender só dos bits baixos do ID
+    std::uint32_t h = static_cast<std::uint32_t>(id);
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return static_cast<int>(h % static_cast<std::uint32_t>(total));
+}
+
+bool configurarParticoes() {
+    std::string quantidade = getEnv("SHARDS", "");
+    int total = quantidade.empty() ? 1 : std::atoi(quantidade.c_str());
+    if (total < 1) {
+        std::cerr << "--> AVISO: SHARDS invalido; usando 1 particao" << std::endl;
+        total = 1;
+    }
+    std::vector<std::string> montagens;
+    std::stringstream lista(getEnv("SHARD_DIRS", ""));
+    std::string dir;
+    while (std::getline(lista, dir, ':')) {
+        if (!dir.empty()) montagens.push_back(dir);
+    }
+
+    std::vector<std::string>& dirs = diretorios();
+    dirs.clear();
+    if (total == 1 && montagens.empty()) {
+        std::remove(SHARDS_LST.c_str());
+        return true;
+    }
+    if (montagens.empty()) montagens.push_back(DATA_DIR);
+
+    std::ofstream out(SHARDS_LST, std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "[ERRO] Não foi possível gravar " << SHARDS_LST << "\n";
+        return false;
+    }
+    for (int k = 0; k < total; ++k) {
+        std::string caminho = montagens[k % montagens.size()] + "/shard" + std::to_string(k);
+        if (!criarDiretorio(caminho) || !criarDiretorio(caminho + "/db")) {
+            std::cerr << "[ERRO] Não foi possível criar " << caminho << "\n";
+            return false;
+        }
+        dirs.push_back(caminho);
+        out << caminho << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+bool paraCadaParticao(const std::function<bool(int, const Caminhos&)>& fn) {
+    int total = numParticoes();
+    if (total == 1) return fn(0, caminhosDaParticao(0));
+
+    std::vector<Caminhos> caminhos;
+    for (int k = 0; k < total; ++k) caminhos.push_back(caminhosDaParticao(k));
+    std::vector<char> ok(static_cast<std::size_t>(total), 0); // vector<bool> não aceita escritas concorrentes
+    std::vector<std::thread> threads;
+    for (int k = 0; k < total; ++k) {
+        threads.emplace_back([&, k] { ok[k] = fn(k, caminhos[k]); });
+    }
+    bool todas = true;
+    for (int k = 0; k < total; ++k) {
+        threads[k].join();
+        todas = todas && ok[k];
+    }
+    return todas;
+}
+
+bool particionarPorId(const std::string& caminho, std::vector<std::string>& partes) {
+    int total = numParticoes();
+    partes.clear();
+    if (total == 1) {
+        partes.push_back(caminho);
+        return true;
+    }
+    std::ifstream in(caminho);
+    if (!in.is_open()) {
+        std::cerr << "Erro: Nao foi possivel abrir o arquivo '" << caminho << "'" << std::endl;
+        return false;
+    }
+
+    std::vector<std::unique_ptr<std::ofstream>> saidas;
+    for (int k = 0; k < total; ++k) {
+        partes.push_back(caminhosDaParticao(k).dataDir + "/" + nomeDoArquivo(caminho) + ".parte");
+        saidas.emplace_back(new std::ofstream(partes.back(), std::ios::trunc));
+        if (!saidas.back()->is_open()) {
+            std::cerr << "Erro: Nao foi possivel criar '" << partes.back() << "'" << std::endl;
+            return false;
+        }
+    }
+    std::vector<std::size_t> linhas(total, 0);
+    std::string linha;
+    while (std::getline(in, linha)) {
+        int id;
+        int k = idDaLinha(linha, id) ? particaoDoId(id, total) : 0;
+        *saidas[k] << linha << '\n';
+        linhas[k]++;
+    }
+    bool ok = true;
+    for (int k = 0; k < total; ++k) {
+        saidas[k]->close();
+        ok = ok && !saidas[k]->fail();
+        std::cout << "[INFO] Particao " << k << ": " << linhas[k] << " linhas de " << caminho << std::endl;
+    }
+    return ok;
+}
+
+void removerPartes(const std::string& caminho, const std::vector<std::string>& partes) {
+    for (const std::string& parte : partes) {
+        if (parte != caminho) std::remove(parte.c_str());
+    }
+}
@@ -0,0 +1,502 @@
+#include "../include/prefixo.h"
+#include "../include/hashing_file.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iterator>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char PREFIXO_MAGIC[4] = {'P', 'F', 'X', '2'};
+
+struct Cabecalho {
+    char magic[4];
+    std::uint16_t titulosPorBalde;
+    std::uint16_t palavrasPorBalde;
+    std::uint64_t numPalavras;
+    std::uint64_t numBaldesPalavras;
+    std::uint64_t offBaldesPalavras;
+    std::uint64_t offPalavras;
+    std::uint64_t numTitulos;
+    std::uint64_t numBaldes;
+    std::uint64_t offBaldes;
+    std::uint64_t offTitulos;
+    std::uint64_t tamanho;
+    char reservado[16];
+};
+static_assert(sizeof(Cabecalho) == 96, "cabecalho do indice de prefixos deve ter 96 bytes");
+
+inline void escreverVarint(std::string& out, std::uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+inline std::uint64_t lerVarint(const unsigned char*& p) {
+    std::uint64_t v = 0;
+    int shift = 0;
+    while (*p & 0x80) {
+        v |= static_cast<std::uint64_t>(*p++ & 0x7F) << shift;
+        shift += 7;
+    }
+    v |= static_cast<std::uint64_t>(*p++) << shift;
+    return v;
+}
+
+// Lê a lista de RIDs após um título; com destino nulo só pula os bytes
+inline void lerRids(const unsigned char*& p, std::vector<long>* destino) {
+    std::uint64_t n = lerVarint(p);
+    long rid = 0;
+    for (std::uint64_t i = 0; i < n; ++i) {
+        rid += static_cast<long>(lerVarint(p));
+        if (destino) destino->push_back(rid);
+    }
+}
+
+inline bool separador(char c) {
+    return static_cast<unsigned char>(c) <= ' ';
+}
+
+// Lê um registro de título (front coding em palavras) sobre 'ids'
+inline void lerTitulo(const unsigned char*& p, std::vector<std::uint32_t>& ids) {
+    std::uint64_t comuns = lerVarint(p);
+    std::uint64_t resto = lerVarint(p);
+    ids.resize(comuns);
+    for (std::uint64_t i = 0; i < resto; ++i) ids.push_back(static_cast<std::uint32_t>(lerVarint(p)));
+}
+
+// Lê a palavra seguinte de um balde do vocabulário sobre 'atual'
+inline void lerPalavra(const unsigned char*& p, bool cabeca, std::string& atual) {
+    std::uint64_t comum = cabeca ? 0 : lerVarint(p);
+    std::uint64_t tam = lerVarint(p);
+    atual.resize(comum);
+    atual.append(reinterpret_cast<const char*>(p), tam);
+    p += tam;
+}
+
+inline void escreverFrontCoding(std::string& out, const std::string& anterior, const std::string& atual, bool cabeca) {
+    if (cabeca) {
+        escreverVarint(out, atual.size());
+        out += atual;
+        return;
+    }
+    std::size_t lcp = 0;
+    std::size_t limite = std::min(anterior.size(), atual.size());
+    while (lcp < limite && anterior[lcp] == atual[lcp]) ++lcp;
+    escreverVarint(out, lcp);
+    escreverVarint(out, atual.size() - lcp);
+    out.append(atual, lcp, std::string::npos);
+}
+
+} // namespace
+
+std::string normalizarTitulo(const char* titulo, std::size_t maxLen) {
+    std::size_t n = strnlen(titulo, maxLen);
+    std::string s;
+    s.reserve(n);
+    bool espaco = false;
+    for (std::size_t i = 0; i < n; ++i) {
+        char c = titulo[i];
+        if (separador(c)) {
+            espaco = !s.empty();
+            continue;
+        }
+        if (espaco) s.push_back(' ');
+        espaco = false;
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        s.push_back(c);
+    }
+    return s;
+}
+
+// ===== construção =====
+
+void PrefixoBuilder::adicionar(long rid, const Artigo& artigo) {
+    std::string norm = normalizarTitulo(artigo.titulo, sizeof(artigo.titulo));
+    if (norm.empty()) return;
+    bytesBrutos_ += norm.size();
+
+    Entrada e;
+    e.rid = rid;
+    std::size_t inicio = 0;
+    while (inicio <= norm.size()) {
+        std::size_t fim = norm.find(' ', inicio);
+        if (fim == std::string::npos) fim = norm.size();
+        auto it = palavras_.emplace(norm.substr(inicio, fim - inicio), static_cast<std::uint32_t>(palavras_.size())).first;
+        e.ids.push_back(it->second);
+        inicio = fim + 1;
+    }
+    entradas_.push_back(std::move(e));
+}
+
+bool PrefixoBuilder::gravar(const std::string& caminho) {
+    // vocabulário em ordem lexicográfica e remapeamento dos IDs provisórios
+    std::vector<const std::string*> vocab(palavras_.size());
+    for (const auto& par : palavras_) vocab[par.second] = &par.first;
+    std::vector<std::uint32_t> ordem(vocab.size());
+    for (std::uint32_t i = 0; i < ordem.size(); ++i) ordem[i] = i;
+    std::sort(ordem.begin(), ordem.end(), [&](std::uint32_t a, std::uint32_t b) { return *vocab[a] < *vocab[b]; });
+    std::vector<std::uint32_t> novoId(vocab.size());
+    std::vector<const std::string*> ordenado(vocab.size());
+    for (std::uint32_t i = 0; i < ordem.size(); ++i) {
+        novoId[ordem[i]] = i;
+        ordenado[i] = vocab[ordem[i]];
+    }
+
+    for (Entrada& e : entradas_) {
+        for (std::uint32_t& id : e.ids) id = novoId[id];
+    }
+    std::sort(entradas_.begin(), entradas_.end(), [](const Entrada& a, const Entrada& b) {
+        return a.ids != b.ids ? a.ids < b.ids : a.rid < b.rid;
+    });
+    return gravarOrdenado(caminho, ordenado);
+}
+
+bool PrefixoBuilder::mesclar(const std::string& caminho) {
+    IndicePrefixo atual;
+    if (!atual.abrir(caminho)) return false;
+    const unsigned char* base = atual.base_;
+    const Cabecalho* cab = reinterpret_cast<const Cabecalho*>(base);
+
+    // vocabulário atual, em sequência (as cabeças dos baldes vêm completas)
+    std::vector<std::string> antigas(cab->numPalavras);
+    const unsigned char* p = base + cab->offPalavras;
+    std::string atualPalavra;
+    for (std::size_t i = 0; i < antigas.size(); ++i) {
+        lerPalavra(p, i % PALAVRAS_POR_BALDE == 0, atualPalavra);
+        antigas[i] = atualPalavra;
+    }
+
+    // intercala com as palavras do lote; IDs antigos e provisórios viram posições do vocabulário novo
+    std::vector<const std::string*> doLote(palavras_.size());
+    for (const auto& par : palavras_) doLote[par.second] = &par.first;
+    std::vector<std::uint32_t> ordemLote(doLote.size());
+    for (std::uint32_t i = 0; i < ordemLote.size(); ++i) ordemLote[i] = i;
+    std::sort(ordemLote.begin(), ordemLote.end(), [&](std::uint32_t a, std::uint32_t b) { return *doLote[a] < *doLote[b]; });
+    std::vector<const std::string*> vocab;
+    vocab.reserve(antigas.size() + doLote.size());
+    std::vector<std::uint32_t> idAntigo(antigas.size()), idLote(doLote.size());
+    for (std::size_t a = 0, b = 0; a < antigas.size() || b < ordemLote.size();) {
+        std::uint32_t id = static_cast<std::uint32_t>(vocab.size());
+        if (b == ordemLote.size() || (a < antigas.size() && antigas[a] < *doLote[ordemLote[b]])) {
+            idAntigo[a] = id;
+            vocab.push_back(&antigas[a++]);
+        } else if (a < antigas.size() && antigas[a] == *doLote[ordemLote[b]]) {
+            idAntigo[a] = id;
+            idLote[ordemLote[b++]] = id;
+            vocab.push_back(&antigas[a++]);
+        } else {
+            idLote[ordemLote[b]] = id;
+            vocab.push_back(doLote[ordemLote[b++]]);
+        }
+    }
+
+    // títulos atuais, já em ordem (o remapeamento preserva a ordem dos IDs), sem os RIDs retirados
+    std::sort(retirados_.begin(), retirados_.end());
+    std::vector<Entrada> entradas;
+    entradas.reserve(cab->numTitulos + entradas_.size());
+    std::vector<std::uint32_t> ids;
+    std::vector<long> rids;
+    p = base + cab->offTitulos;
+    for (std::uint64_t t = 0; t < cab->numTitulos; ++t) {
+        lerTitulo(p, ids);
+        rids.clear();
+        lerRids(p, &rids);
+        for (long rid : rids) {
+            if (std::binary_search(retirados_.begin(), retirados_.end(), rid)) continue;
+            Entrada e;
+            e.rid = rid;
+            e.ids.reserve(ids.size());
+            for (std::uint32_t id : ids) e.ids.push_back(idAntigo[id]);
+            entradas.push_back(std::move(e));
+        }
+    }
+
+    auto ordemEntrada = [](const Entrada& a, const Entrada& b) {
+        return a.ids != b.ids ? a.ids < b.ids : a.rid < b.rid;
+    };
+    for (Entrada& e : entradas_) {
+        for (std::uint32_t& id : e.ids) id = idLote[id];
+    }
+    std::sort(entradas_.begin(), entradas_.end(), ordemEntrada);
+    std::size_t meio = entradas.size();
+    entradas.insert(entradas.end(), std::make_move_iterator(entradas_.begin()), std::make_move_iterator(entradas_.end()));
+    std::inplace_merge(entradas.begin(), entradas.begin() + static_cast<long>(meio), entradas.end(), ordemEntrada);
+    entradas_.swap(entradas);
+
+    // palavras que só os títulos retirados usavam saem do vocabulário
+    std::vector<std::uint32_t> compacto(vocab.size(), 0);
+    for (const Entrada& e : entradas_) {
+        for (std::uint32_t id : e.ids) compacto[id] = 1;
+    }
+    std::vector<const std::string*> usadas;
+    for (std::size_t i = 0; i < vocab.size(); ++i) {
+        if (!compacto[i]) continue;
+        compacto[i] = static_cast<std::uint32_t>(usadas.size());
+        usadas.push_back(vocab[i]);
+    }
+    for (Entrada& e : entradas_) {
+        for (std::uint32_t& id : e.ids) id = compacto[id];
+    }
+    retirados_.clear();
+    return gravarOrdenado(caminho, usadas);
+}
+
+bool PrefixoBuilder::gravarOrdenado(const std::string& caminho, const std::vector<const std::string*>& vocab) {
+    std::string palavras;
+    std::vector<std::uint64_t> baldesPalavras;
+    for (std::size_t i = 0; i < vocab.size(); ++i) {
+        bool cabeca = i % PALAVRAS_POR_BALDE == 0;
+        if (cabeca) baldesPalavras.push_back(palavras.size());
+        escreverFrontCoding(palavras, cabeca ? std::string() : *vocab[i - 1], *vocab[i], cabeca);
+    }
+
+    std::string titulos;
+    std::vector<std::uint64_t> baldes;
+    const std::vector<std::uint32_t>* anterior = nullptr;
+    distintos_ = 0;
+    for (std::size_t i = 0; i < entradas_.size();) {
+        const std::vector<std::uint32_t>& ids = entradas_[i].ids;
+        std::size_t fimGrupo = i;
+        while (fimGrupo < entradas_.size() && entradas_[fimGrupo].ids == ids) ++fimGrupo;
+
+        std::size_t comuns = 0;
+        if (distintos_ % TITULOS_POR_BALDE == 0) {
+            baldes.push_back(titulos.size());
+        } else {
+            std::size_t limite = std::min(anterior->size(), ids.size());
+            while (comuns < limite && (*anterior)[comuns] == ids[comuns]) ++comuns;
+        }
+        escreverVarint(titulos, comuns);
+        escreverVarint(titulos, ids.size() - comuns);
+        for (std::size_t j = comuns; j < ids.size(); ++j) escreverVarint(titulos, ids[j]);
+
+        escreverVarint(titulos, fimGrupo - i);
+        long ridAnterior = 0;
+        for (std::size_t j = i; j < fimGrupo; ++j) {
+            escreverVarint(titulos, static_cast<std::uint64_t>(entradas_[j].rid - ridAnterior));
+            ridAnterior = entradas_[j].rid;
+        }
+
+        anterior = &ids;
+        distintos_++;
+        i = fimGrupo;
+    }
+
+    Cabecalho cab{};
+    std::memcpy(cab.magic, PREFIXO_MAGIC, sizeof(PREFIXO_MAGIC));
+    cab.titulosPorBalde = static_cast<std::uint16_t>(TITULOS_POR_BALDE);
+    cab.palavrasPorBalde = static_cast<std::uint16_t>(PALAVRAS_POR_BALDE);
+    cab.numPalavras = vocab.size();
+    cab.numBaldesPalavras = baldesPalavras.size();
+    cab.offBaldesPalavras = sizeof(Cabecalho);
+    cab.offPalavras = cab.offBaldesPalavras + baldesPalavras.size() * sizeof(std::uint64_t);
+    cab.numTitulos = distintos_;
+    cab.numBaldes = baldes.size();
+    cab.offBaldes = (cab.offPalavras + palavras.size() + 7) & ~std::uint64_t{7};
+    cab.offTitulos = cab.offBaldes + baldes.size() * sizeof(std::uint64_t);
+    cab.tamanho = cab.offTitulos + titulos.size();
+    bytesGravados_ = cab.tamanho;
+
+    // grava em arquivo temporário e renomeia: consultas nunca veem o índice pela metade
+    std::string tmp = caminho + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        static const char zeros[8] = {};
+        out.write(reinterpret_cast<const char*>(&cab), sizeof(cab));
+        out.write(reinterpret_cast<const char*>(baldesPalavras.data()), static_cast<std::streamsize>(baldesPalavras.size() * sizeof(std::uint64_t)));
+        out.write(palavras.data(), static_cast<std::streamsize>(palavras.size()));
+        out.write(zeros, static_cast<std::streamsize>(cab.offBaldes - (cab.offPalavras + palavras.size())));
+        out.write(reinterpret_cast<const char*>(baldes.data()), static_cast<std::streamsize>(baldes.size() * sizeof(std::uint64_t)));
+        out.write(titulos.data(), static_cast<std::streamsize>(titulos.size()));
+        if (!out.good()) return false;
+    }
+    entradas_.clear();
+    entradas_.shrink_to_fit();
+    palavras_.clear();
+    return std::rename(tmp.c_str(), caminho.c_str()) == 0;
+}
+
+// ===== consulta =====
+
+IndicePrefixo::~IndicePrefixo() {
+    if (base_) munmap(const_cast<unsigned char*>(base_), tamanho_);
+}
+
+bool IndicePrefixo::abrir(const std::string& caminho) {
+    int fd = ::open(caminho.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(Cabecalho)) {
+        ::close(fd);
+        return false;
+    }
+    void* p = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+
+    const Cabecalho* cab = static_cast<const Cabecalho*>(p);
+    if (std::memcmp(cab->magic, PREFIXO_MAGIC, sizeof(PREFIXO_MAGIC)) != 0 ||
+        cab->titulosPorBalde != TITULOS_POR_BALDE || cab->palavrasPorBalde != PALAVRAS_POR_BALDE ||
+        cab->tamanho > static_cast<std::uint64_t>(st.st_size)) {
+        munmap(p, static_cast<std::size_t>(st.st_size));
+        return false;
+    }
+    base_ = static_cast<const unsigned char*>(p);
+    tamanho_ = static_cast<std::size_t>(st.st_size);
+    return true;
+}
+
+std::size_t IndicePrefixo::numTitulos() const {
+    return base_ ? reinterpret_cast<const Cabecalho*>(base_)->numTitulos : 0;
+}
+
+std::size_t IndicePrefixo::numPalavras() const {
+    return base_ ? reinterpret_cast<const Cabecalho*>(base_)->numPalavras : 0;
+}
+
+std::string IndicePrefixo::palavra(std::uint32_t id) const {
+    const Cabecalho* cab = reinterpret_cast<const Cabecalho*>(base_);
+    std::uint64_t off;
+    std::memcpy(&off, base_ + cab->offBaldesPalavras + (id / PALAVRAS_POR_BALDE) * sizeof(std::uint64_t), sizeof(off));
+    const unsigned char* p = base_ + cab->offPalavras + off;
+    std::string atual;
+    for (std::uint32_t i = 0; i <= id % PALAVRAS_POR_BALDE; ++i) lerPalavra(p, i == 0, atual);
+    return atual;
+}
+
+std::uint32_t IndicePrefixo::lowerBoundPalavra(const std::string& alvo) const {
+    const Cabecalho* cab = reinterpret_cast<const Cabecalho*>(base_);
+    if (cab->numPalavras == 0) return 0;
+
+    // primeiro balde cuja cabeça é > alvo; a resposta está no balde anterior
+    std::size_t lo = 0, hi = cab->numBaldesPalavras;
+    while (lo < hi) {
+        std::size_t meio = lo + (hi - lo) / 2;
+        if (palavra(static_cast<std::uint32_t>(meio * PALAVRAS_POR_BALDE)) <= alvo) lo = meio + 1;
+        else hi = meio;
+    }
+    if (lo == 0) return 0;
+
+    std::size_t balde = lo - 1;
+    std::uint64_t off;
+    std::memcpy(&off, base_ + cab->offBaldesPalavras + balde * sizeof(std::uint64_t), sizeof(off));
+    const unsigned char* p = base_ + cab->offPalavras + off;
+    std::string atual;
+    std::uint64_t id = balde * PALAVRAS_POR_BALDE;
+    for (std::size_t i = 0; i < PALAVRAS_POR_BALDE && id < cab->numPalavras; ++i, ++id) {
+        lerPalavra(p, i == 0, atual);
+        if (atual >= alvo) return static_cast<std::uint32_t>(id);
+    }
+    return static_cast<std::uint32_t>(id);
+}
+
+std::vector<std::uint32_t> IndicePrefixo::cabecaDoBalde(std::size_t balde) const {
+    const Cabecalho* cab = reinterpret_cast<const Cabecalho*>(base_);
+    std::uint64_t off;
+    std::memcpy(&off, base_ + cab->offBaldes + balde * sizeof(std::uint64_t), sizeof(off));
+    const unsigned char* p = base_ + cab->offTitulos + off;
+    std::vector<std::uint32_t> ids;
+    lerTitulo(p, ids);
+    return ids;
+}
+
+std::size_t IndicePrefixo::buscar(const std::string& prefixo, std::size_t limite, std::vector<Sugestao>& saida) const {
+    saida.clear();
+    if (!base_ || limite == 0 || prefixo.empty()) return 0;
+    const Cabecalho* cab = reinterpret_cast<const Cabecalho*>(base_);
+    if (cab->numBaldes == 0) return 0;
+
+    // palavras completas viram IDs exatos; a última, se parcial, vira a faixa
+    // [idLo, idHi) das palavras que começam com ela
+    std::vector<std::uint32_t> completas;
+    std::string parcial;
+    bool temParcial = prefixo.back() != ' ';
+    std::size_t inicio = 0;
+    while (inicio < prefixo.size()) {
+        std::size_t fim = prefixo.find(' ', inicio);
+        if (fim == std::string::npos) fim = prefixo.size();
+        std::string w = prefixo.substr(inicio, fim - inicio);
+        inicio = fim + 1;
+        if (w.empty()) continue;
+        if (temParcial && fim == prefixo.size()) {
+            parcial = w;
+            break;
+        }
+        std::uint32_t id = lowerBoundPalavra(w);
+        if (id >= cab->numPalavras || palavra(id) != w) return 0; // palavra que nenhum título tem
+        completas.push_back(id);
+    }
+
+    std::uint32_t idLo = 0, idHi = 0;
+    std::vector<std::uint32_t> alvo = completas;
+    if (temParcial) {
+        idLo = lowerBoundPalavra(parcial);
+        std::string sucessor = parcial;
+        while (!sucessor.empty() && static_cast<unsigned char>(sucessor.back()) == 0xFF) sucessor.pop_back();
+        if (sucessor.empty()) {
+            idHi = static_cast<std::uint32_t>(cab->numPalavras);
+        } else {
+            sucessor.back() = static_cast<char>(static_cast<unsigned char>(sucessor.back()) + 1);
+            idHi = lowerBoundPalavra(sucessor);
+        }
+        if (idLo >= idHi) return 0;
+        alvo.push_back(idLo);
+    }
+    const std::size_t k = completas.size();
+
+    // último balde cuja cabeça é < alvo: os títulos procurados começam nele ou depois
+    std::size_t lo = 0, hi = cab->numBaldes;
+    while (lo < hi) {
+        std::size_t meio = lo + (hi - lo) / 2;
+        if (cabecaDoBalde(meio) < alvo) lo = meio + 1;
+        else hi = meio;
+    }
+    std::size_t balde = lo > 0 ? lo - 1 : 0;
+
+    std::uint64_t off;
+    std::memcpy(&off, base_ + cab->offBaldes + balde * sizeof(std::uint64_t), sizeof(off));
+    const unsigned char* p = base_ + cab->offTitulos + off;
+    const unsigned char* fimDados = base_ + cab->tamanho;
+
+    std::vector<std::uint32_t> ids;
+    std::unordered_map<std::uint32_t, std::string> cache;
+    auto texto = [&](std::uint32_t id) -> const std::string& {
+        auto it = cache.find(id);
+        if (it == cache.end()) it = cache.emplace(id, palavra(id)).first;
+        return it->second;
+    };
+
+    for (std::uint64_t indice = balde * TITULOS_POR_BALDE; indice < cab->numTitulos && p < fimDados; ++indice) {
+        lerTitulo(p, ids);
+        if (ids < alvo) {
+            lerRids(p, nullptr);
+            continue;
+        }
+        if (ids.size() < k || !std::equal(completas.begin(), completas.end(), ids.begin())) break;
+        bool casa = ids.size() > k && (!temParcial || ids[k] < idHi);
+        if (!casa) {
+            if (temParcial) break; // passou da faixa da palavra parcial
+            lerRids(p, nullptr);   // título igual às palavras completas, sem continuação
+            continue;
+        }
+
+        Sugestao s;
+        for (std::size_t i = 0; i < ids.size(); ++i) {
+            if (i) s.titulo.push_back(' ');
+            s.titulo += texto(ids[i]);
+        }
+        lerRids(p, &s.rids);
+        saida.push_back(std::move(s));
+        if (saida.size() >= limite) break;
+    }
+    return saida.size();
+}
@@ -0,0 +1,130 @@
+#include "../include/varredura.h"
+#include "../include/metrics.h"
+#include "../include/particoes.h"
+#include "../include/config.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static void uso(const char* prog) {
+    std::cerr << "Uso: " << prog << " [--ano A[-B]] [--citacoes MIN[-MAX]] [--desde DATA] [--ate DATA]\n"
+              << "           [--por-ano] [--threads N] [--lote BLOCOS]\n"
+              << "  --ano A[-B]          ano ou faixa de anos (inclusiva)\n"
+              << "  --citacoes MIN[-MAX] faixa de citacoes (inclusiva)\n"
+              << "  --desde/--ate DATA   faixa de atualizacao (AAAA-MM-DD[ hh:mm:ss])\n"
+              << "  --por-ano            agrupa contagem/soma/min/max por ano\n"
+              << "  --threads N          threads da varredura (padrao: nucleos disponiveis)\n"
+              << "  --lote BLOCOS        blocos lidos por unidade de trabalho (padrao 256)" << std::endl;
+}
+
+// "A" ou "A-B"; um '-' inicial é sinal, não separador
+static bool lerFaixa(const std::string& texto, int& lo, int& hi) {
+    std::size_t sep = texto.find('-', 1);
+    char* fim = nullptr;
+    long a = std::strtol(texto.c_str(), &fim, 10);
+    if (fim == texto.c_str()) return false;
+    if (sep == std::string::npos) {
+        if (*fim != '\0') return false;
+        lo = hi = static_cast<int>(a);
+        return true;
+    }
+    const char* resto = texto.c_str() + sep + 1;
+    long b = std::strtol(resto, &fim, 10);
+    if (fim == resto || *fim != '\0') return false;
+    lo = static_cast<int>(a);
+    hi = static_cast<int>(b);
+    return lo <= hi;
+}
+
+static void imprimirResumo(const ResumoCitacoes& r) {
+    std::cout << r.quantidade << " artigos, citacoes: soma " << r.soma;
+    if (r.quantidade) {
+        std::cout << ", media " << std::fixed << std::setprecision(2) << r.media() << std::defaultfloat
+                  << ", min " << r.minimo << ", max " << r.maximo;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    startMetricsServerFromEnv();
+
+    FiltroScan filtro;
+    OpcoesScan opcoes;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool temValor = i + 1 < argc;
+        if (arg == "--ano" && temValor) {
+            if (!lerFaixa(argv[++i], filtro.anoMin, filtro.anoMax)) {
+                uso(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--citacoes" && temValor) {
+            if (!lerFaixa(argv[++i], filtro.citacoesMin, filtro.citacoesMax)) {
+                uso(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--desde" && temValor) {
+            filtro.atualizacaoMin = argv[++i];
+        } else if (arg == "--ate" && temValor) {
+            filtro.atualizacaoMax = argv[++i];
+        } else if (arg == "--por-ano") {
+            opcoes.agruparPorAno = true;
+        } else if (arg == "--threads" && temValor) {
+            opcoes.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (arg == "--lote" && temValor) {
+            opcoes.blocosPorLote = static_cast<std::size_t>(std::atol(argv[++i]));
+        } else if (arg == "--help" || arg == "-h") {
+            uso(argv[0]);
+            return 0;
+        } else {
+            uso(argv[0]);
+            return 1;
+        }
+    }
+
+    // as partições (particoes.h) são varridas ao mesmo tempo, dividindo as
+    // threads entre elas, e os agregados combinados no fim
+    int total = numParticoes();
+    OpcoesScan porParticao = opcoes;
+    unsigned threads = opcoes.threads ? opcoes.threads : std::thread::hardware_concurrency();
+    porParticao.threads = std::max(1u, threads / static_cast<unsigned>(total));
+
+    auto inicio = std::chrono::steady_clock::now();
+    std::vector<AgregadoScan> parciais(total);
+    if (!paraCadaParticao([&](int k, const Caminhos& c) {
+            if (varrerParalelo(c.dados, filtro, porParticao, parciais[k])) return true;
+            std::cerr << "Erro: nao foi possivel ler '" << c.dados << "'. Execute o upload primeiro." << std::endl;
+            return false;
+        })) {
+        return 1;
+    }
+    AgregadoScan resultado;
+    for (const AgregadoScan& parcial : parciais) resultado.combinar(parcial);
+    auto fim = std::chrono::steady_clock::now();
+
+    if (opcoes.agruparPorAno) {
+        for (const auto& par : resultado.porAno) {
+            std::cout << par.first << ": ";
+            imprimirResumo(par.second);
+            std::cout << std::endl;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "Total: ";
+    imprimirResumo(resultado.total);
+    if (resultado.total.quantidade) {
+        std::cout << " (anos " << resultado.anoMin << "-" << resultado.anoMax << ")";
+    }
+    std::cout << std::endl;
+
+    double segundos = std::chrono::duration<double>(fim - inicio).count();
+    double mb = resultado.bytesLidos / (1024.0 * 1024.0);
+    std::cout << "Registros lidos: " << resultado.registrosLidos << " em " << resultado.blocosLidos << " blocos" << std::endl;
+    std::cout << "Tempo da varredura: " << segundos * 1e3 << "ms (" << std::fixed << std::setprecision(1)
+              << (segundos > 0 ? mb / segundos : 0.0) << " MB/s)" << std::endl;
+    return 0;
+}
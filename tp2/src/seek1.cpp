@@ -1,4 +1,9 @@
 #include "../include/BPlusTree.hpp"
+#include "../include/bloom.h"
+#include "../include/compressao.h"
+#include "../include/leitor_registros.h"
+#include "../include/projecao.h"
+#include "../include/particoes.h"
 #include "../include/config.h" 
 #include <iostream>
 #include <fstream>
@@ -7,25 +12,7 @@
 #include <chrono>
 #include <cstdlib>
 #include <algorithm>
-
-struct ArticleDisk {
-    bool ocupado;
-    int id;
-    char titulo[301];
-    int ano;
-    char autores[151];
-    int citacoes;
-    char atualizacao[20];
-    char snippet[1025];
-};
-
-const int REGISTROS_POR_BLOCO = 2;
-
-struct Bloco {
-    ArticleDisk artigos[REGISTROS_POR_BLOCO];
-    int num_registros_usados;
-    long proximo_bloco_offset;
-};
+#include <memory>
 
 // variáveis globais para logging
 enum LogLevel { ERROR, WARN, INFO, DEBUG };
@@ -113,17 +100,56 @@ struct SearchResult {
     int treeBlocksRead;
     int primaryIndexBlocksRead;
     int dataBlocksRead;
-    long long durationMs;
+    long long durationNs;
+};
+
+// Imprime só as colunas pedidas, direto do valor projetado do índice
+static void imprimirProjetado(int id, const ValorProjetado& v, std::uint32_t campos) {
+    std::cout << "\n=== ARTIGO ENCONTRADO (indice de cobertura) ===" << std::endl;
+    std::cout << "ID: " << id << std::endl;
+    if (campos & PROJ_TITULO) std::cout << "Título: " << v.titulo << std::endl;
+    if (campos & PROJ_ANO) std::cout << "Ano: " << v.ano << std::endl;
+    if (campos & PROJ_AUTORES) std::cout << "Autores: " << v.autores << std::endl;
+    if (campos & PROJ_ATUALIZACAO) std::cout << "Atualização: " << v.atualizacao << std::endl;
+    if (campos & PROJ_CITACOES) std::cout << "Citações: " << v.citacoes << std::endl;
+}
+
+// Índice primário, Bloom filter e leitor de registros de uma partição
+// (particoes.h); cada ID é buscado só na partição que o guarda
+struct Particao {
+    Caminhos caminhos;
+    BPlusTree<long> idx;
+    BloomFilter bloom;
+    DadosComprimidos dados;
+    LeitorDeRegistros leitor;
+    bool aberta;
+
+    explicit Particao(const Caminhos& c) : caminhos(c), idx(c.primario) {
+        if (!bloom.abrir(c.bloomId)) logDebug("Bloom filter de IDs ausente: " + c.bloomId);
+        // sem a cópia comprimida, lê artigos.dat
+        if (dados.abrir(c.comprimidos, c.dados)) logDebug("Lendo registros da copia comprimida: " + c.comprimidos);
+        aberta = leitor.abrir(c.primario, c.dados, &dados);
+        if (!aberta) logError("Erro ao abrir o índice primário ou o arquivo de dados: " + c.primario + ", " + c.dados);
+    }
 };
 
-SearchResult search_primary_index(BPlusTree<long>& idx, int idBuscado) {
-    auto startTime = std::chrono::high_resolution_clock::now();
+// campos: colunas pedidas (projecao.h); 0 = registro completo. Se o índice
+// primário projeta todas elas, a consulta termina na página de dados do índice.
+SearchResult search_primary_index(Particao& particao, int idBuscado, std::uint32_t campos, const QueryTimings& tempos) {
+    ScopedTimer tTotal(tempos.total);
     SearchResult result = {false, 0, 0, 0, 0};
+    BPlusTree<long>& idx = particao.idx;
+    LeitorDeRegistros& leitor = particao.leitor;
     
     logInfo("Iniciando busca por ID: " + std::to_string(idBuscado));
-    logInfo("Caminho do arquivo de dados: " + ARTIGO_DAT);  
-    logInfo("Caminho do arquivo de índice: " + PRIM_INDEX); 
+    logInfo("Caminho do arquivo de dados: " + particao.caminhos.dados);  
+    logInfo("Caminho do arquivo de índice: " + particao.caminhos.primario); 
 
+    ScopedTimer tIndice(tempos.index);
+    if (!particao.bloom.mayContain(bloomHashId(idBuscado))) {
+        logWarn("ID não encontrado (descartado pelo Bloom filter): " + std::to_string(idBuscado));
+        return result;
+    }
     long leafOffset = idx.search(idBuscado);
     result.treeBlocksRead = idx.getBlocksRead();
     
@@ -137,120 +163,171 @@ SearchResult search_primary_index(BPlusTree<long>& idx, int idBuscado) {
         logWarn("ID não encontrado no índice primário: " + std::to_string(idBuscado));
         return result;
     }
+    tIndice.stop();
 
-    long actualRID = -1;
-    std::ifstream idxFile(PRIM_INDEX, std::ios::binary);
-    if (!idxFile.is_open()) {
-        logError("Erro ao abrir arquivo de índice primário: " + PRIM_INDEX);
-        return result;
-    }
+    ScopedTimer tRid(tempos.rid);
+    bool cobre = campos != 0 && (idx.projection() & campos) == campos;
+    if (cobre) {
+        ValorProjetado valor;
+        if (!leitor.lerDoIndice(results[0], &valor, sizeof(valor))) {
+            logError("Erro ao ler valor projetado do índice primário no offset: " + std::to_string(results[0]));
+            return result;
+        }
+        result.primaryIndexBlocksRead = 1;
+        tRid.stop();
 
-    idxFile.seekg(0, std::ios::end);
-    std::streamoff idxSize = idxFile.tellg();
-    if (results[0] < 0 || static_cast<std::streamoff>(results[0]) + sizeof(long) > idxSize) {
-        logError("Offset inválido no arquivo de índice primário: " + std::to_string(results[0]));
-        idxFile.close();
+        ScopedTimer tSaida(tempos.output);
+        imprimirProjetado(idBuscado, valor, campos);
+        result.success = true;
+        tSaida.stop();
+        result.durationNs = static_cast<long long>(tTotal.stop());
         return result;
     }
-
-    idxFile.seekg(results[0], std::ios::beg);
-    if (!idxFile.read(reinterpret_cast<char*>(&actualRID), sizeof(long))) {
+    if (campos != 0) logInfo("Indice primario nao projeta todos os campos pedidos; lendo o registro em " + particao.caminhos.dados);
+    std::vector<long> rids;
+    leitor.lerRids({results[0]}, rids);
+    if (rids[0] < 0) {
         logError("Erro ao ler RID do índice primário no offset: " + std::to_string(results[0]));
-        idxFile.close();
         return result;
     }
-    idxFile.close();
     result.primaryIndexBlocksRead = 1;
+    tRid.stop();
 
-    // buscar no arquivo de dados
-    std::ifstream dataFile(ARTIGO_DAT, std::ios::binary);
-    if (!dataFile.is_open()) {
-        logError("Erro ao abrir arquivo de dados: " + ARTIGO_DAT);
-        return result;
-    }
+    // buscar no arquivo de dados (ou na cópia comprimida, se existir e estiver em dia)
+    ScopedTimer tDados(tempos.fetch);
+    std::vector<RegistroLido> registros;
+    std::size_t blocosAntes = leitor.blocosLidos();
+    leitor.buscar(rids, registros);
+    result.dataBlocksRead = static_cast<int>(leitor.blocosLidos() - blocosAntes);
+    tDados.stop();
 
-    size_t articleIndex = static_cast<size_t>(actualRID);
-    size_t blockIndex = articleIndex / REGISTROS_POR_BLOCO;
-    size_t positionInBlock = articleIndex % REGISTROS_POR_BLOCO;
+    ScopedTimer tSaida(tempos.output);
+    const RegistroLido& reg = registros[0];
+    if (reg.estado == REG_OK) {
+        const Artigo& art = reg.artigo;
+        logInfo("Artigo encontrado com sucesso");
+        std::cout << "\n=== ARTIGO ENCONTRADO ===" << std::endl;
+        std::cout << "ID: " << art.id << std::endl;
+        std::cout << "Título: " << art.titulo << std::endl;
+        std::cout << "Ano: " << art.ano << std::endl;
+        std::cout << "Autores: " << art.autores << std::endl;
+        std::cout << "Atualização: " << art.atualizacao << std::endl;
+        std::cout << "Citações: " << art.citacoes << std::endl;
 
-    dataFile.seekg(0, std::ios::end);
-    std::streamoff dataSize = dataFile.tellg();
-    size_t totalArticles = (dataSize / sizeof(Bloco)) * REGISTROS_POR_BLOCO;
+        std::string cleanedSnippet = fixEncoding(art.snippet);
+        std::string finalSnippet = truncateSnippet(cleanedSnippet);
+        std::cout << "Snippet: " << finalSnippet << std::endl;
 
-    if (articleIndex >= totalArticles) {
-        logError("RID inválido (fora do tamanho do arquivo de dados): " + std::to_string(actualRID));
-        dataFile.close();
-        return result;
+        result.success = true;
+    } else if (reg.estado == REG_VAZIO) {
+        logWarn("Registro marcado como não ocupado no RID: " + std::to_string(reg.rid));
+    } else if (reg.estado == REG_FORA_DO_ARQUIVO) {
+        logError("RID inválido (fora do tamanho do arquivo de dados): " + std::to_string(reg.rid));
+    } else {
+        logError("Erro ao ler bloco do arquivo de dados no índice: " + std::to_string(reg.rid / REGISTROS_POR_BLOCO));
     }
+    tSaida.stop();
 
-    Bloco bloco{};
-    dataFile.seekg(blockIndex * sizeof(Bloco));
-    if (dataFile.read(reinterpret_cast<char*>(&bloco), sizeof(Bloco))) {
-        result.dataBlocksRead = 1;
-        
-        if (positionInBlock < bloco.num_registros_usados) {
-            ArticleDisk& art = bloco.artigos[positionInBlock];
-            if (art.ocupado) {
-                logInfo("Artigo encontrado com sucesso");
-                std::cout << "\n=== ARTIGO ENCONTRADO ===" << std::endl;
-                std::cout << "ID: " << art.id << std::endl;
-                std::cout << "Título: " << art.titulo << std::endl;
-                std::cout << "Ano: " << art.ano << std::endl;
-                std::cout << "Autores: " << art.autores << std::endl;
-                std::cout << "Atualização: " << art.atualizacao << std::endl;
-                std::cout << "Citações: " << art.citacoes << std::endl;
-                
-                std::string cleanedSnippet = fixEncoding(art.snippet);
-                std::string finalSnippet = truncateSnippet(cleanedSnippet);
-                std::cout << "Snippet: " << finalSnippet << std::endl;
-                
-                result.success = true;
-            } else {
-                logWarn("Registro marcado como não ocupado no RID: " + std::to_string(actualRID));
-            }
-        } else {
-            logError("Posição inválida no bloco: " + std::to_string(positionInBlock));
+    result.durationNs = static_cast<long long>(tTotal.stop());
+    return result;
+}
+
+// Modo lote: um ID por linha (arquivo ou "-" para stdin); ao final imprime os
+// percentis de latência de cada fase da consulta.
+int run_batch(std::vector<std::unique_ptr<Particao>>& particoes, std::uint32_t campos, const std::string& caminho, const QueryTimings& tempos) {
+    std::ifstream arquivo;
+    if (caminho != "-") {
+        arquivo.open(caminho);
+        if (!arquivo.is_open()) {
+            logError("Nao foi possivel abrir o arquivo de IDs: " + caminho);
+            return 1;
         }
-    } else {
-        logError("Erro ao ler bloco do arquivo de dados no índice: " + std::to_string(blockIndex));
     }
+    std::istream& in = caminho == "-" ? std::cin : arquivo;
 
-    dataFile.close();
-    
-    auto endTime = std::chrono::high_resolution_clock::now();
-    result.durationMs = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
-    
-    return result;
+    long consultas = 0, encontrados = 0, blocosTotais = 0;
+    std::string linha;
+    while (std::getline(in, linha)) {
+        int id;
+        try {
+            id = std::stoi(linha);
+        } catch (const std::exception&) {
+            continue; // linha vazia ou cabeçalho
+        }
+        Particao& particao = *particoes[particaoDoId(id)];
+        particao.idx.resetStats();
+        SearchResult r = search_primary_index(particao, id, campos, tempos);
+        consultas++;
+        if (r.success) encontrados++;
+        blocosTotais += r.treeBlocksRead + r.primaryIndexBlocksRead + r.dataBlocksRead;
+    }
+
+    std::cout << "\n=== LOTE ===" << std::endl;
+    std::cout << "Consultas: " << consultas << " (encontradas: " << encontrados << ")" << std::endl;
+    if (consultas > 0) {
+        std::cout << "Media de blocos lidos por consulta: " << static_cast<double>(blocosTotais) / consultas << std::endl;
+    }
+    tempos.printSummary(std::cout);
+    return 0;
 }
 
 int main(int argc, char* argv[]) {
     setLogLevelFromEnv();
-    
-    if (argc < 2) {
-        logError("Uso: " + std::string(argv[0]) + " <ID>");
+
+    const std::string uso = "Uso: " + std::string(argv[0]) + " [--campos titulo,ano,...] <ID> | --batch <ARQUIVO_IDS|->";
+    std::uint32_t campos = 0;
+    std::string caminhoLote;
+    std::string idTexto;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--campos" && i + 1 < argc) {
+            if (!lerColunas(argv[++i], campos)) {
+                logError("Campos invalidos (use titulo, ano, autores, citacoes, atualizacao): " + std::string(argv[i]));
+                return 1;
+            }
+        } else if (arg == "--batch" && i + 1 < argc) {
+            caminhoLote = argv[++i];
+        } else {
+            idTexto = arg;
+        }
+    }
+    if (caminhoLote.empty() && idTexto.empty()) {
+        logError(uso);
         return 1;
     }
 
+    QueryTimings tempos = QueryTimings::forTool("seek1");
+    if (!caminhoLote.empty()) {
+        startMetricsServerFromEnv();
+        std::vector<std::unique_ptr<Particao>> particoes;
+        for (int k = 0; k < numParticoes(); ++k) {
+            particoes.emplace_back(new Particao(caminhosDaParticao(k)));
+            if (!particoes.back()->aberta) return 1;
+        }
+        return run_batch(particoes, campos, caminhoLote, tempos);
+    }
+
     int id;
     try {
-        id = std::stoi(argv[1]);
+        id = std::stoi(idTexto);
     } catch (const std::exception& e) {
-        logError("ID inválido: " + std::string(argv[1]));
+        logError("ID inválido: " + idTexto);
         return 1;
     }
 
-    BPlusTree<long> idx(PRIM_INDEX);
-    idx.resetStats();
+    Particao particao(caminhosDaParticao(particaoDoId(id)));
+    if (!particao.aberta) return 1;
+    particao.idx.resetStats();
     
     logDebug("Índice primário carregado");
     
-    SearchResult result = search_primary_index(idx, id);
+    SearchResult result = search_primary_index(particao, id, campos, tempos);
     
     std::cout << "\n=== ESTATÍSTICAS DA BUSCA ===" << std::endl;
     std::cout << "Blocos da árvore lidos: " << result.treeBlocksRead << std::endl;
     std::cout << "Blocos do índice primário lidos: " << result.primaryIndexBlocksRead << std::endl;
     std::cout << "Blocos de dados lidos: " << result.dataBlocksRead << std::endl;
-    std::cout << "Tempo total de execução: " << result.durationMs << "ms" << std::endl;
+    std::cout << "Tempo total de execução: " << result.durationNs / 1e6 << "ms" << std::endl;
     std::cout << "Total de blocos lidos: " 
               << result.treeBlocksRead + result.primaryIndexBlocksRead + result.dataBlocksRead 
               << std::endl;
@@ -1,4 +1,8 @@
 #include "BPlusTree.hpp"
+#include "bloom.h"
+#include "compressao.h"
+#include "leitor_registros.h"
+#include "particoes.h"
 #include "config.h"  
 #include <iostream>
 #include <fstream>
@@ -8,6 +12,7 @@
 #include <cstdint>
 #include <vector>
 #include <locale>
+#include <memory>
 
 // variáveis globais para logging
 enum LogLevel { ERROR, WARN, INFO, DEBUG };
@@ -51,25 +56,6 @@ void logDebug(const std::string& message) {
 }
 
 
-struct ArticleDisk {
-    bool ocupado;
-    int id;
-    char titulo[301];
-    int ano;
-    char autores[151];
-    int citacoes;
-    char atualizacao[20];
-    char snippet[1025];
-};
-
-const int REGISTROS_POR_BLOCO = 2;
-
-struct Bloco {
-    ArticleDisk artigos[REGISTROS_POR_BLOCO];
-    int num_registros_usados;
-    long proximo_bloco_offset;
-};
-
 static inline std::string trim(const std::string& s) {
     std::size_t start = s.find_first_not_of(" \t\n\r");
     if (start == std::string::npos) return "";
@@ -127,8 +113,60 @@ std::string fixEncoding(const std::string& str) {
     return result;
 }
 
-// função para busca usando B+Tree
-bool search_bplus_index(BPlusTree<long>& idx, const std::string& titulo_buscado) {
+// Índice secundário, Bloom filter e leitor de registros de uma partição
+// (particoes.h); o título pode estar em qualquer uma, então todas são consultadas
+struct Particao {
+    Caminhos caminhos;
+    BPlusTree<long> idx;
+    BloomFilter bloom;
+    DadosComprimidos dados;
+    LeitorDeRegistros leitor;
+    bool aberta;
+
+    explicit Particao(const Caminhos& c) : caminhos(c), idx(c.secundario) {
+        if (!bloom.abrir(c.bloomTitulo)) logDebug("Bloom filter de titulos ausente: " + c.bloomTitulo);
+        // sem a cópia comprimida, lê artigos.dat
+        if (dados.abrir(c.comprimidos, c.dados)) logDebug("Lendo registros da copia comprimida: " + c.comprimidos);
+        aberta = leitor.abrir(c.secundario, c.dados, &dados);
+        if (!aberta) logError("Nao foi possivel abrir o indice secundario ou o arquivo de dados: " + c.secundario + ", " + c.dados);
+    }
+};
+
+// Ocorrências do título em uma partição
+struct Ocorrencias {
+    bool descartadoPeloBloom = false;
+    std::vector<long> offsets;
+    std::vector<long> rids;
+    std::vector<RegistroLido> registros;
+    std::size_t blocosArvore = 0;
+};
+
+// Roda na thread da partição: só lê, sem imprimir
+static void buscarNaParticao(Particao& p, const std::string& norm, int key, const QueryTimings& tempos, Ocorrencias& o) {
+    p.idx.resetStats();
+    ScopedTimer tIndice(tempos.index);
+    if (!p.bloom.mayContain(bloomHashTitulo(norm))) {
+        o.descartadoPeloBloom = true;
+        return;
+    }
+    o.offsets = p.idx.searchAll(key);
+    o.blocosArvore = p.idx.getBlocksRead();
+    tIndice.stop();
+    if (o.offsets.empty()) return;
+
+    // todos os RIDs e depois todos os blocos, cada página/bloco lido uma vez
+    ScopedTimer tRid(tempos.rid);
+    p.leitor.lerRids(o.offsets, o.rids);
+    tRid.stop();
+
+    ScopedTimer tDados(tempos.fetch);
+    p.leitor.buscar(o.rids, o.registros);
+}
+
+// função para busca usando B+Tree, em todas as partições em paralelo
+bool search_bplus_index(std::vector<std::unique_ptr<Particao>>& particoes, const std::string& titulo_buscado, const QueryTimings& tempos, std::size_t& blocosArvore) {
+    ScopedTimer tTotal(tempos.total);
+    blocosArvore = 0;
     std::string norm = normalize(titulo_buscado.c_str());
     if (norm.empty()) {
         logWarn("Titulo vazio.");
@@ -136,87 +174,131 @@ bool search_bplus_index(BPlusTree<long>& idx, const std::string& titulo_buscado)
     }
     int key = static_cast<int>(fnv1a32(norm));
 
-    long leafOffset = idx.search(key);
-    if (leafOffset == 0) {
-        logWarn("Titulo nao encontrado no indice secundario.");
+    std::vector<Ocorrencias> porParticao(particoes.size());
+    paraCadaParticao([&](int k, const Caminhos&) {
+        buscarNaParticao(*particoes[k], norm, key, tempos, porParticao[k]);
+        return true;
+    });
+
+    std::size_t total = 0;
+    bool todosDescartados = true;
+    for (const Ocorrencias& o : porParticao) {
+        total += o.offsets.size();
+        blocosArvore += o.blocosArvore;
+        todosDescartados = todosDescartados && o.descartadoPeloBloom;
+    }
+    if (todosDescartados) {
+        logWarn("Titulo nao encontrado (descartado pelo Bloom filter).");
         return false;
     }
-
-    std::vector<long> results = idx.searchAll(key);
-    if (results.empty()) {
+    if (total == 0) {
         logWarn("Titulo nao encontrado no indice secundario.");
         return false;
     }
 
-    logInfo("Encontradas " + std::to_string(results.size()) + " ocorrencias!");
+    logInfo("Encontradas " + std::to_string(total) + " ocorrencias!");
 
-    for (size_t idxRes = 0; idxRes < results.size(); idxRes++) {
-        long ridOffset = results[idxRes];
-        std::cout << "\n--- Resultado " << (idxRes + 1) << " ---\n";
-
-        std::ifstream idxFile(SEC_INDEX, std::ios::binary);
-        if (!idxFile.is_open()) {
-            logError("Nao foi possivel abrir arquivo de indice.");
-            continue;
-        }
+    ScopedTimer tSaida(tempos.output);
+    std::size_t numero = 0;
+    for (std::size_t k = 0; k < porParticao.size(); ++k) {
+        const Ocorrencias& o = porParticao[k];
+        for (size_t idxRes = 0; idxRes < o.offsets.size(); idxRes++) {
+            std::cout << "\n--- Resultado " << ++numero << " ---\n";
+            if (o.rids[idxRes] < 0) {
+                logError("Nao foi possivel ler RID do indice (offset=" + std::to_string(o.offsets[idxRes]) + ").");
+                continue;
+            }
+            std::cout << "RID=" << o.rids[idxRes];
+            if (particoes.size() > 1) std::cout << " (particao " << k << ")";
+            std::cout << std::endl;
 
-        long actualRID;
-        idxFile.seekg(ridOffset);
-        if (!idxFile.read(reinterpret_cast<char*>(&actualRID), sizeof(long))) {
-            logError("Nao foi possivel ler RID do indice (offset=" + std::to_string(ridOffset) + ").");
-            idxFile.close();
-            continue;
-        }
-        idxFile.close();
-
-        std::cout << "RID=" << actualRID << std::endl;
-
-        std::ifstream dataFile(ARTIGO_DAT, std::ios::binary);
-        if (dataFile.is_open()) {
-            size_t articleIndex = static_cast<size_t>(actualRID);
-            size_t blockIndex = articleIndex / REGISTROS_POR_BLOCO;
-            size_t positionInBlock = articleIndex % REGISTROS_POR_BLOCO;
-
-            Bloco bloco{};
-            dataFile.seekg(blockIndex * sizeof(Bloco));
-            if (dataFile.read(reinterpret_cast<char*>(&bloco), sizeof(Bloco))) {
-                if (positionInBlock < REGISTROS_POR_BLOCO && positionInBlock < bloco.num_registros_usados) {
-                    ArticleDisk& art = bloco.artigos[positionInBlock];
-
-                    if (art.ocupado) {
-                        std::cout << "ID: " << art.id << std::endl;
-                        std::cout << "Titulo: " << fixEncoding(art.titulo) << std::endl;
-                        std::cout << "Ano: " << art.ano << std::endl;
-                        std::cout << "Autores: " << fixEncoding(art.autores) << std::endl;
-                        std::cout << "Atualizacao: " << art.atualizacao << std::endl;
-                        std::cout << "Citacoes: " << art.citacoes << std::endl;
-                        std::cout << "Snippet: " << fixEncoding(art.snippet) << std::endl;
-                    } else {
-                        logWarn("Registro nao ocupado (RID=" + std::to_string(actualRID) + ").");
-                    }
+            const RegistroLido& reg = o.registros[idxRes];
+            if (reg.estado == REG_OK) {
+                const Artigo& art = reg.artigo;
+                if (normalize(art.titulo) != norm) {
+                    // colisão do FNV-1a: outro título com o mesmo hash
+                    logDebug("Titulo do registro difere do buscado (RID=" + std::to_string(reg.rid) + "), descartado.");
                 } else {
-                    logError("Posicao invalida no bloco (posicao=" + std::to_string(positionInBlock) + ", registros_usados=" + std::to_string(bloco.num_registros_usados) + ").");
+                    std::cout << "ID: " << art.id << std::endl;
+                    std::cout << "Titulo: " << fixEncoding(art.titulo) << std::endl;
+                    std::cout << "Ano: " << art.ano << std::endl;
+                    std::cout << "Autores: " << fixEncoding(art.autores) << std::endl;
+                    std::cout << "Atualizacao: " << art.atualizacao << std::endl;
+                    std::cout << "Citacoes: " << art.citacoes << std::endl;
+                    std::cout << "Snippet: " << fixEncoding(art.snippet) << std::endl;
                 }
+            } else if (reg.estado == REG_VAZIO) {
+                logWarn("Registro nao ocupado (RID=" + std::to_string(reg.rid) + ").");
             } else {
-                logError("Nao foi possivel ler bloco do arquivo (blockIndex=" + std::to_string(blockIndex) + ").");
+                logError("Nao foi possivel ler bloco do arquivo (blockIndex=" + std::to_string(reg.rid / REGISTROS_POR_BLOCO) + ").");
             }
-            dataFile.close();
-        } else {
-            logError("Nao foi possivel abrir arquivo de dados.");
         }
     }
 
     return true;
 }
 
+// Modo lote: um título por linha (arquivo ou "-" para stdin); ao final imprime
+// os percentis de latência de cada fase da consulta.
+int run_batch(std::vector<std::unique_ptr<Particao>>& particoes, const std::string& caminho, const QueryTimings& tempos) {
+    std::ifstream arquivo;
+    if (caminho != "-") {
+        arquivo.open(caminho);
+        if (!arquivo.is_open()) {
+            logError("Nao foi possivel abrir o arquivo de titulos: " + caminho);
+            return 1;
+        }
+    }
+    std::istream& in = caminho == "-" ? std::cin : arquivo;
+
+    long consultas = 0, encontrados = 0;
+    std::size_t blocosArvore = 0;
+    std::string linha;
+    while (std::getline(in, linha)) {
+        if (trim(linha).empty()) continue;
+        std::size_t blocos = 0;
+        if (search_bplus_index(particoes, linha, tempos, blocos)) encontrados++;
+        blocosArvore += blocos;
+        consultas++;
+    }
+
+    std::cout << "\n=== LOTE ===" << std::endl;
+    std::cout << "Consultas: " << consultas << " (com ocorrencias no indice: " << encontrados << ")" << std::endl;
+    if (consultas > 0) {
+        std::cout << "Media de blocos da arvore por consulta: " << static_cast<double>(blocosArvore) / consultas << std::endl;
+    }
+    tempos.printSummary(std::cout);
+    return 0;
+}
+
+static bool abrirParticoes(std::vector<std::unique_ptr<Particao>>& particoes) {
+    for (int k = 0; k < numParticoes(); ++k) {
+        particoes.emplace_back(new Particao(caminhosDaParticao(k)));
+        if (!particoes.back()->aberta) return false;
+    }
+    return true;
+}
+
 int main(int argc, char* argv[]){
     setLogLevelFromEnv();
     if (argc < 2) {
-        logError("Uso: " + std::string(argv[0]) + " <Titulo>");
+        logError("Uso: " + std::string(argv[0]) + " <Titulo> | --batch <ARQUIVO_TITULOS|->");
         return 1;
     }
     std::setlocale(LC_ALL, "en_US.UTF-8");
 
+    QueryTimings tempos = QueryTimings::forTool("seek2");
+    if (std::string(argv[1]) == "--batch") {
+        if (argc < 3) {
+            logError("Uso: " + std::string(argv[0]) + " --batch <ARQUIVO_TITULOS|->");
+            return 1;
+        }
+        startMetricsServerFromEnv();
+        std::vector<std::unique_ptr<Particao>> particoes;
+        if (!abrirParticoes(particoes)) return 1;
+        return run_batch(particoes, argv[2], tempos);
+    }
+
     std::string titulo;
     for (int i = 1; i < argc; ++i) {
         if (i > 1) titulo.push_back(' ');
@@ -224,9 +306,10 @@ int main(int argc, char* argv[]){
     }
     logInfo("Buscando titulo: '" + titulo + "'");
 
-    BPlusTree<long> idx(SEC_INDEX);  
-    idx.resetStats();
-    search_bplus_index(idx, titulo);
-    std::cout << "Blocos da árvore lidos: " << idx.getBlocksRead() << std::endl;
+    std::vector<std::unique_ptr<Particao>> particoes;
+    if (!abrirParticoes(particoes)) return 1;
+    std::size_t blocosArvore = 0;
+    search_bplus_index(particoes, titulo, tempos, blocosArvore);
+    std::cout << "Blocos da árvore lidos: " << blocosArvore << std::endl;
     return 0;
 }
\ No newline at end of file
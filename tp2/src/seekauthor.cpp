@@ -0,0 +1,98 @@
+#include "../include/invertido.h"
+#include "../include/hashing_file.h"
+#include "../include/metrics.h"
+#include "../include/particoes.h"
+#include "../include/config.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+const int TAMANHO_TABELA = 100000; // mesmo tamanho de tabela do upload
+
+static void uso(const char* prog) {
+    std::cerr << "Uso: " << prog << " [--limite N] <NOME_DO_AUTOR>\n"
+              << "  --limite N   quantos artigos mostrar (padrao 20; 0 = todos)" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t limite = 20;
+    std::string nomeBruto;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--limite" && i + 1 < argc) {
+            limite = static_cast<std::size_t>(std::atol(argv[++i]));
+        } else if (arg == "--help" || arg == "-h") {
+            uso(argv[0]);
+            return 0;
+        } else {
+            if (!nomeBruto.empty()) nomeBruto.push_back(' ');
+            nomeBruto += arg;
+        }
+    }
+    // mesma normalização da construção; um '|' no argumento não faz sentido aqui
+    std::vector<std::string> nomes;
+    extrairAutores(nomeBruto.c_str(), nomeBruto.size(), nomes);
+    if (nomes.size() != 1) {
+        uso(argv[0]);
+        return 1;
+    }
+    const std::string& nome = nomes[0];
+
+    // cada partição (particoes.h) tem o índice de autores só dos seus
+    // registros: as consultas rodam em paralelo e os resultados são concatenados
+    int total = numParticoes();
+    std::vector<std::vector<Artigo>> artigos(total);
+    std::vector<std::size_t> encontrados(total, 0);
+    std::vector<std::size_t> autoresNoIndice(total, 0);
+    std::vector<long long> nsBusca(total, 0);
+    if (!paraCadaParticao([&](int k, const Caminhos& c) {
+            IndiceInvertido indice;
+            if (!indice.abrir(c.autores)) {
+                std::cerr << "Erro: indice de autores '" << c.autores << "' ausente ou invalido. Execute o upload primeiro." << std::endl;
+                return false;
+            }
+            auto inicio = std::chrono::steady_clock::now();
+            PostingCursor cursor;
+            std::vector<long> rids;
+            if (indice.buscar(nome, cursor)) {
+                rids.reserve(cursor.df());
+                for (; !cursor.fim(); cursor.proximo()) rids.push_back(cursor.atual());
+            }
+            nsBusca[k] = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - inicio).count();
+            encontrados[k] = rids.size();
+            autoresNoIndice[k] = indice.numTermos();
+
+            // nenhuma partição precisa ler mais que o limite
+            HashingFile arquivoHash(c.dados, TAMANHO_TABELA, c.tabelaHash);
+            std::size_t mostrar = (limite == 0 || limite > rids.size()) ? rids.size() : limite;
+            for (std::size_t i = 0; i < mostrar; ++i) {
+                Artigo art;
+                if (arquivoHash.lerPorRid(rids[i], art)) artigos[k].push_back(art);
+            }
+            return true;
+        })) {
+        return 1;
+    }
+
+    std::size_t totalEncontrados = 0, autores = 0, mostrados = 0;
+    long long ns = 0;
+    for (int k = 0; k < total; ++k) {
+        totalEncontrados += encontrados[k];
+        autores += autoresNoIndice[k];
+        ns = std::max(ns, nsBusca[k]);
+        for (const Artigo& art : artigos[k]) {
+            if (limite != 0 && mostrados == limite) break;
+            std::cout << "ID " << art.id << " (" << art.ano << ", " << art.citacoes << " citacoes): " << art.titulo << std::endl;
+            mostrados++;
+        }
+    }
+
+    std::cout << "\n" << totalEncontrados << (totalEncontrados == 1 ? " artigo" : " artigos") << " de '" << nome << "'";
+    if (mostrados < totalEncontrados) std::cout << " (mostrando " << mostrados << ")";
+    std::cout << "; " << autores << " autores no indice" << std::endl;
+    std::cout << "Tempo da busca no indice: " << ns / 1e6 << "ms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,220 @@
+#include "../include/BPlusTree.hpp"
+#include "../include/aprendido.h"
+#include "../include/leitor_registros.h"
+#include "../include/particoes.h"
+#include "../include/config.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+static void uso(const char* prog) {
+    std::cerr << "Uso: " << prog << " <ID> | --bench <ARQUIVO_IDS>\n"
+              << "  <ID>                 busca o artigo pelo indice aprendido\n"
+              << "  --bench ARQUIVO_IDS  compara o indice aprendido com o primario (B+ tree)\n"
+              << "                       nos IDs do arquivo (um por linha) e imprime JSON" << std::endl;
+}
+
+static bool arquivoExiste(const std::string& caminho) {
+    struct stat st;
+    return stat(caminho.c_str(), &st) == 0;
+}
+
+static double percentil(std::vector<double> v, double p) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    std::size_t i = static_cast<std::size_t>(p * static_cast<double>(v.size() - 1) + 0.5);
+    return v[i];
+}
+
+struct MedidasBusca {
+    std::vector<double> latenciasUs;
+    long leituras = 0;
+    long encontrados = 0;
+};
+
+static void imprimirMedidas(const char* nome, const MedidasBusca& m, bool virgula) {
+    double n = m.latenciasUs.empty() ? 1 : static_cast<double>(m.latenciasUs.size());
+    std::cout << "  \"" << nome << "\": {\"encontrados\": " << m.encontrados
+              << ", \"leituras_por_busca\": " << static_cast<double>(m.leituras) / n
+              << ", \"p50_us\": " << percentil(m.latenciasUs, 0.50)
+              << ", \"p99_us\": " << percentil(m.latenciasUs, 0.99) << "}" << (virgula ? "," : "") << "\n";
+}
+
+// Os dois índices de ID de uma partição (particoes.h)
+struct Particao {
+    Caminhos caminhos;
+    IndiceAprendido aprendido;
+    std::unique_ptr<BPlusTree<long>> arvore; // só no benchmark
+    LeitorDeRegistros leitor;
+
+    explicit Particao(const Caminhos& c) : caminhos(c) {}
+};
+
+static long tamanhoDoArquivo(const std::string& caminho) {
+    struct stat st;
+    return stat(caminho.c_str(), &st) == 0 ? static_cast<long>(st.st_size) : 0;
+}
+
+// Mede só a resolução ID -> RID nos dois índices; a leitura do registro em
+// artigos.dat é a mesma para ambos e fica fora da comparação.
+static int benchmark(std::vector<std::unique_ptr<Particao>>& particoes, const std::string& caminhoIds) {
+    std::ifstream in(caminhoIds);
+    if (!in.is_open()) {
+        std::cerr << "Erro: nao foi possivel abrir " << caminhoIds << std::endl;
+        return 1;
+    }
+    std::vector<int> ids;
+    std::string linha;
+    while (std::getline(in, linha)) {
+        try {
+            ids.push_back(std::stoi(linha));
+        } catch (const std::exception&) {
+            // linha vazia ou cabeçalho
+        }
+    }
+
+    std::size_t segmentos = 0;
+    long bytesModelo = 0, bytesArvore = 0;
+    for (auto& p : particoes) {
+        // o construtor da árvore criaria um arquivo vazio
+        if (!arquivoExiste(p->caminhos.primario) || !p->leitor.abrir(p->caminhos.primario, p->caminhos.dados)) {
+            std::cerr << "Erro: indice '" << p->caminhos.primario << "' ausente. Execute o upload primeiro." << std::endl;
+            return 1;
+        }
+        p->arvore.reset(new BPlusTree<long>(p->caminhos.primario));
+        segmentos += p->aprendido.numSegmentos();
+        bytesModelo += tamanhoDoArquivo(p->caminhos.aprendidoModelo);
+        bytesArvore += tamanhoDoArquivo(p->caminhos.primario);
+    }
+
+    MedidasBusca medidasArvore, medidasAprendido;
+    long divergentes = 0;
+    std::vector<long> rids;
+    for (int id : ids) {
+        Particao& p = *particoes[particaoDoId(id)];
+        BPlusTree<long>& arvore = *p.arvore;
+        arvore.resetStats();
+        auto t0 = std::chrono::steady_clock::now();
+        std::vector<long> offsets = arvore.searchAll(id);
+        long ridArvore = -1;
+        if (!offsets.empty()) {
+            p.leitor.lerRids({offsets[0]}, rids);
+            ridArvore = rids[0];
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        // páginas da árvore + a página de dados com o RID
+        medidasArvore.leituras += static_cast<long>(arvore.getBlocksRead()) + (offsets.empty() ? 0 : 1);
+        medidasArvore.latenciasUs.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+        if (ridArvore >= 0) medidasArvore.encontrados++;
+
+        int paginas = 0;
+        t0 = std::chrono::steady_clock::now();
+        long ridAprendido = p.aprendido.buscar(id, paginas);
+        t1 = std::chrono::steady_clock::now();
+        medidasAprendido.leituras += paginas;
+        medidasAprendido.latenciasUs.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+        if (ridAprendido >= 0) medidasAprendido.encontrados++;
+
+        if (ridArvore != ridAprendido) divergentes++;
+    }
+
+    std::cout << "{\n"
+              << "  \"consultas\": " << ids.size() << ",\n"
+              << "  \"divergentes\": " << divergentes << ",\n"
+              << "  \"erro_maximo\": " << ERRO_APRENDIDO << ",\n"
+              << "  \"particoes\": " << particoes.size() << ",\n"
+              << "  \"segmentos\": " << segmentos << ",\n"
+              << "  \"bytes_modelo\": " << bytesModelo << ",\n"
+              << "  \"bytes_indice_primario\": " << bytesArvore << ",\n";
+    imprimirMedidas("bplus", medidasArvore, true);
+    imprimirMedidas("aprendido", medidasAprendido, false);
+    std::cout << "}" << std::endl;
+    return divergentes == 0 ? 0 : 2;
+}
+
+static bool abrirAprendido(Particao& p) {
+    if (p.aprendido.abrir(p.caminhos.aprendidoModelo, p.caminhos.aprendidoArranjo)) return true;
+    std::cerr << "Erro: indice aprendido ausente ou inconsistente (" << p.caminhos.aprendidoModelo
+              << "). Execute o upload primeiro." << std::endl;
+    return false;
+}
+
+int main(int argc, char* argv[]) {
+    std::string caminhoBench;
+    std::string idTexto;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--bench" && i + 1 < argc) {
+            caminhoBench = argv[++i];
+        } else if (arg == "--help" || arg == "-h") {
+            uso(argv[0]);
+            return 0;
+        } else {
+            idTexto = arg;
+        }
+    }
+    if (caminhoBench.empty() && idTexto.empty()) {
+        uso(argv[0]);
+        return 1;
+    }
+
+    if (!caminhoBench.empty()) {
+        std::vector<std::unique_ptr<Particao>> particoes;
+        for (int k = 0; k < numParticoes(); ++k) {
+            particoes.emplace_back(new Particao(caminhosDaParticao(k)));
+            if (!abrirAprendido(*particoes.back())) return 1;
+        }
+        return benchmark(particoes, caminhoBench);
+    }
+
+    int id;
+    try {
+        id = std::stoi(idTexto);
+    } catch (const std::exception&) {
+        std::cerr << "Erro: ID invalido: " << idTexto << std::endl;
+        return 1;
+    }
+
+    Particao p(caminhosDaParticao(particaoDoId(id)));
+    if (!abrirAprendido(p)) return 1;
+    const IndiceAprendido& aprendido = p.aprendido;
+
+    auto inicio = std::chrono::steady_clock::now();
+    int paginas = 0;
+    long rid = aprendido.buscar(id, paginas);
+    if (rid < 0) {
+        std::cout << "ID " << id << " nao encontrado (" << paginas << " pagina(s) do indice lida(s))" << std::endl;
+        return 1;
+    }
+    LeitorDeRegistros& leitor = p.leitor;
+    if (!leitor.abrir(p.caminhos.aprendidoArranjo, p.caminhos.dados)) {
+        std::cerr << "Erro: nao foi possivel abrir " << p.caminhos.dados << std::endl;
+        return 1;
+    }
+    std::vector<RegistroLido> registros;
+    leitor.buscar({rid}, registros);
+    auto fim = std::chrono::steady_clock::now();
+    if (registros[0].estado != REG_OK) {
+        std::cerr << "Erro: RID " << rid << " do indice aprendido nao aponta para um registro valido" << std::endl;
+        return 1;
+    }
+
+    const Artigo& art = registros[0].artigo;
+    std::cout << "\n=== ARTIGO ENCONTRADO (indice aprendido) ===" << std::endl;
+    std::cout << "ID: " << art.id << std::endl;
+    std::cout << "Título: " << art.titulo << std::endl;
+    std::cout << "Ano: " << art.ano << std::endl;
+    std::cout << "Autores: " << art.autores << std::endl;
+    std::cout << "Atualização: " << art.atualizacao << std::endl;
+    std::cout << "Citações: " << art.citacoes << std::endl;
+    std::cout << "\nPaginas do indice lidas: " << paginas << " (modelo com " << aprendido.numSegmentos()
+              << " segmentos em memoria)" << std::endl;
+    std::cout << "Blocos de dados lidos: " << leitor.blocosLidos() << std::endl;
+    std::cout << "Tempo total: " << std::chrono::duration<double, std::milli>(fim - inicio).count() << "ms" << std::endl;
+    return 0;
+}
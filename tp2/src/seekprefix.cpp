@@ -0,0 +1,110 @@
+#include "../include/prefixo.h"
+#include "../include/hashing_file.h"
+#include "../include/metrics.h"
+#include "../include/particoes.h"
+#include "../include/config.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+const int TAMANHO_TABELA = 100000; // mesmo tamanho de tabela do upload
+
+static void uso(const char* prog) {
+    std::cerr << "Uso: " << prog << " [--limite N] [--ids] <PREFIXO_DO_TITULO>\n"
+              << "  --limite N   quantos titulos distintos retornar (padrao 10)\n"
+              << "  --ids        le cada registro para mostrar o ID do artigo" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t limite = 10;
+    bool mostrarIds = false;
+    std::string prefixoBruto;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--limite" && i + 1 < argc) {
+            limite = static_cast<std::size_t>(std::atol(argv[++i]));
+        } else if (arg == "--ids") {
+            mostrarIds = true;
+        } else if (arg == "--help" || arg == "-h") {
+            uso(argv[0]);
+            return 0;
+        } else {
+            if (!prefixoBruto.empty()) prefixoBruto.push_back(' ');
+            prefixoBruto += arg;
+        }
+    }
+    // o espaço final é significativo ("graph " não sugere "graphs")
+    bool espacoFinal = !prefixoBruto.empty() && prefixoBruto.back() == ' ';
+    std::string prefixo = normalizarTitulo(prefixoBruto.c_str(), prefixoBruto.size());
+    if (espacoFinal && !prefixo.empty()) prefixo.push_back(' ');
+    if (prefixo.empty()) {
+        uso(argv[0]);
+        return 1;
+    }
+
+    // cada partição (particoes.h) tem o dicionário só dos seus títulos: as
+    // consultas rodam em paralelo e as listas, já em ordem, são intercaladas
+    int total = numParticoes();
+    std::vector<std::vector<Sugestao>> porParticao(total);
+    std::vector<std::size_t> titulosNoIndice(total, 0);
+    std::vector<long long> nsBusca(total, 0);
+    if (!paraCadaParticao([&](int k, const Caminhos& c) {
+            IndicePrefixo indice;
+            if (!indice.abrir(c.prefixo)) {
+                std::cerr << "Erro: indice de prefixos '" << c.prefixo << "' ausente ou invalido. Execute o upload primeiro." << std::endl;
+                return false;
+            }
+            auto inicio = std::chrono::steady_clock::now();
+            indice.buscar(prefixo, limite, porParticao[k]);
+            nsBusca[k] = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - inicio).count();
+            titulosNoIndice[k] = indice.numTitulos();
+            return true;
+        })) {
+        return 1;
+    }
+
+    // título -> (partição, RID) de todas as partições
+    std::map<std::string, std::vector<std::pair<int, long>>> combinadas;
+    for (int k = 0; k < total; ++k) {
+        for (const Sugestao& s : porParticao[k]) {
+            for (long rid : s.rids) combinadas[s.titulo].push_back({k, rid});
+        }
+    }
+
+    std::vector<std::unique_ptr<HashingFile>> arquivos(total);
+    std::size_t sugestoes = 0;
+    for (const auto& par : combinadas) {
+        if (sugestoes == limite) break;
+        sugestoes++;
+        const auto& rids = par.second;
+        std::cout << par.first << "  [" << rids.size() << (rids.size() == 1 ? " registro" : " registros");
+        if (mostrarIds) {
+            std::cout << ": ID";
+            for (const auto& pr : rids) {
+                if (!arquivos[pr.first]) {
+                    Caminhos c = caminhosDaParticao(pr.first);
+                    arquivos[pr.first].reset(new HashingFile(c.dados, TAMANHO_TABELA, c.tabelaHash));
+                }
+                Artigo art;
+                if (arquivos[pr.first]->lerPorRid(pr.second, art)) std::cout << " " << art.id;
+            }
+        }
+        std::cout << "]" << std::endl;
+    }
+
+    long long ns = 0;
+    std::size_t titulos = 0;
+    for (int k = 0; k < total; ++k) {
+        ns = std::max(ns, nsBusca[k]);
+        titulos += titulosNoIndice[k];
+    }
+    std::cout << "\n" << sugestoes << " sugestoes para '" << prefixo << "' ("
+              << titulos << " titulos no indice)" << std::endl;
+    std::cout << "Tempo da busca no indice: " << ns / 1e6 << "ms" << std::endl;
+    return 0;
+}
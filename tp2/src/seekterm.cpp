@@ -0,0 +1,181 @@
+#include "../include/invertido.h"
+#include "../include/hashing_file.h"
+#include "../include/metrics.h"
+#include "../include/particoes.h"
+#include "../include/config.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <queue>
+#include <string>
+#include <vector>
+
+const int TAMANHO_TABELA = 100000; // mesmo tamanho de tabela do upload
+
+// Interseção (AND) por leapfrog: o candidato é o maior RID atual entre as
+// listas e cada cursor galopa até ele; começa pela lista menos frequente.
+static std::vector<long> intersecao(std::vector<PostingCursor>& cursores) {
+    std::vector<long> resultado;
+    std::sort(cursores.begin(), cursores.end(), [](const PostingCursor& a, const PostingCursor& b) { return a.df() < b.df(); });
+
+    while (!cursores[0].fim()) {
+        long candidato = cursores[0].atual();
+        bool todos = true;
+        for (std::size_t i = 1; i < cursores.size(); ++i) {
+            if (!cursores[i].avancarPara(candidato)) return resultado;
+            if (cursores[i].atual() != candidato) {
+                candidato = cursores[i].atual();
+                todos = false;
+                break;
+            }
+        }
+        if (todos) {
+            resultado.push_back(candidato);
+            cursores[0].proximo();
+        } else if (!cursores[0].avancarPara(candidato)) {
+            break;
+        }
+    }
+    return resultado;
+}
+
+// União (OR) por merge de k vias com heap
+static std::vector<long> uniao(std::vector<PostingCursor>& cursores) {
+    std::vector<long> resultado;
+    auto maior = [&](std::size_t a, std::size_t b) { return cursores[a].atual() > cursores[b].atual(); };
+    std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(maior)> heap(maior);
+    for (std::size_t i = 0; i < cursores.size(); ++i) {
+        if (!cursores[i].fim()) heap.push(i);
+    }
+    while (!heap.empty()) {
+        std::size_t i = heap.top();
+        heap.pop();
+        long rid = cursores[i].atual();
+        if (resultado.empty() || resultado.back() != rid) resultado.push_back(rid);
+        cursores[i].proximo();
+        if (!cursores[i].fim()) heap.push(i);
+    }
+    return resultado;
+}
+
+// Busca em uma partição (particoes.h): cada uma tem o índice invertido só dos
+// seus registros, então as partições são consultadas em paralelo e os
+// resultados concatenados
+struct ResultadoParticao {
+    std::vector<std::size_t> df; // por termo
+    std::vector<long> rids;
+    std::vector<std::pair<long, Artigo>> artigos; // (rid, registro) dos primeiros 'limite' de rids
+    std::size_t blocosDecodificados = 0;
+    long long usBusca = 0;
+};
+
+static bool buscarNaParticao(const Caminhos& c, const std::vector<std::string>& termos, bool modoOr, long limite,
+                             ResultadoParticao& r) {
+    IndiceInvertido indice;
+    if (!indice.abrir(c.invertido)) {
+        std::cerr << "Erro: indice invertido '" << c.invertido << "' ausente ou invalido. Execute o upload primeiro." << std::endl;
+        return false;
+    }
+
+    auto inicio = std::chrono::steady_clock::now();
+    std::vector<PostingCursor> cursores;
+    r.df.assign(termos.size(), 0);
+    for (std::size_t t = 0; t < termos.size(); ++t) {
+        PostingCursor c;
+        bool existe = indice.buscar(termos[t], c);
+        if (existe) r.df[t] = c.df();
+        if (existe) cursores.push_back(std::move(c));
+        else if (!modoOr) cursores.clear(); // AND com um termo ausente é vazio
+        if (!existe && !modoOr) break;
+    }
+
+    if (!cursores.empty()) r.rids = modoOr ? uniao(cursores) : intersecao(cursores);
+    for (const PostingCursor& c : cursores) r.blocosDecodificados += c.blocosDecodificados();
+    r.usBusca = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - inicio).count();
+
+    HashingFile arquivoHash(c.dados, TAMANHO_TABELA, c.tabelaHash);
+    for (long rid : r.rids) {
+        if (static_cast<long>(r.artigos.size()) >= limite) break;
+        Artigo art;
+        if (arquivoHash.lerPorRid(rid, art)) r.artigos.push_back({rid, art});
+    }
+    return true;
+}
+
+static void uso(const char* prog) {
+    std::cerr << "Uso: " << prog << " [--or] [--limite N] <termo> [termo...]\n"
+              << "  sem --or, retorna os registros que contem todos os termos (AND)\n"
+              << "  --limite N   quantos resultados imprimir (padrao 20; 0 so conta)" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    bool modoOr = false;
+    long limite = 20;
+    std::vector<std::string> termos;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--or") {
+            modoOr = true;
+        } else if (arg == "--and") {
+            modoOr = false;
+        } else if (arg == "--limite" && i + 1 < argc) {
+            limite = std::atol(argv[++i]);
+        } else if (arg == "--help" || arg == "-h") {
+            uso(argv[0]);
+            return 0;
+        } else {
+            tokenizar(arg.c_str(), arg.size(), termos);
+        }
+    }
+    std::sort(termos.begin(), termos.end());
+    termos.erase(std::unique(termos.begin(), termos.end()), termos.end());
+    if (termos.empty()) {
+        uso(argv[0]);
+        return 1;
+    }
+
+    auto inicio = std::chrono::steady_clock::now();
+    std::vector<ResultadoParticao> resultados(numParticoes());
+    if (!paraCadaParticao([&](int k, const Caminhos& c) {
+            return buscarNaParticao(c, termos, modoOr, limite, resultados[k]);
+        })) {
+        return 1;
+    }
+    auto fim = std::chrono::steady_clock::now();
+
+    std::size_t total = 0, blocosDecodificados = 0;
+    long long usBusca = 0;
+    for (const ResultadoParticao& r : resultados) {
+        total += r.rids.size();
+        blocosDecodificados += r.blocosDecodificados;
+        usBusca = std::max(usBusca, r.usBusca);
+    }
+    for (std::size_t t = 0; t < termos.size(); ++t) {
+        std::size_t df = 0;
+        for (const ResultadoParticao& r : resultados) df += r.df[t];
+        std::cout << "termo '" << termos[t] << "': " << df << " registros" << std::endl;
+    }
+
+    std::cout << "\n=== " << total << " registros (" << (modoOr ? "OR" : "AND") << ") ===" << std::endl;
+    long impressos = 0;
+    for (std::size_t k = 0; k < resultados.size(); ++k) {
+        const ResultadoParticao& r = resultados[k];
+        for (std::size_t i = 0; i < r.artigos.size() && impressos < limite; ++i) {
+            const Artigo& art = r.artigos[i].second;
+            std::cout << "RID=" << r.artigos[i].first;
+            if (resultados.size() > 1) std::cout << " (particao " << k << ")";
+            std::cout << " ID=" << art.id << " | " << art.titulo << std::endl;
+            impressos++;
+        }
+    }
+    if (static_cast<long>(total) > impressos && limite > 0) {
+        std::cout << "... (" << total - impressos << " nao exibidos; use --limite)" << std::endl;
+    }
+
+    auto us = [](auto d) { return std::chrono::duration_cast<std::chrono::microseconds>(d).count(); };
+    std::cout << "\nBlocos de postings decodificados: " << blocosDecodificados << std::endl;
+    std::cout << "Tempo da busca no indice: " << usBusca / 1000.0 << "ms" << std::endl;
+    std::cout << "Tempo total (com leitura dos registros): " << us(fim - inicio) / 1000.0 << "ms" << std::endl;
+    return 0;
+}
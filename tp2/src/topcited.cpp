@@ -0,0 +1,126 @@
+#include "../include/BPlusTree.hpp"
+#include "../include/ano_citacoes.h"
+#include "../include/hashing_file.h"
+#include "../include/metrics.h"
+#include "../include/particoes.h"
+#include "../include/config.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+const int TAMANHO_TABELA = 100000; // mesmo tamanho de tabela do upload
+
+static void uso(const char* prog) {
+    std::cerr << "Uso: " << prog << " [--k N] [--titulos] <ANO>\n"
+              << "  --k N       quantos artigos retornar (padrao 10)\n"
+              << "  --titulos   le cada registro no arquivo de dados para mostrar o titulo" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t k = 10;
+    bool mostrarTitulos = false;
+    std::string anoTexto;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--k" && i + 1 < argc) {
+            k = static_cast<std::size_t>(std::atol(argv[++i]));
+        } else if (arg == "--titulos") {
+            mostrarTitulos = true;
+        } else if (arg == "--help" || arg == "-h") {
+            uso(argv[0]);
+            return 0;
+        } else if (anoTexto.empty() && arg.rfind("-", 0) != 0) {
+            anoTexto = arg;
+        } else {
+            // um segundo ano, opção desconhecida ou --k sem valor
+            uso(argv[0]);
+            return 1;
+        }
+    }
+    if (anoTexto.empty() || k == 0) {
+        uso(argv[0]);
+        return 1;
+    }
+    int ano = std::atoi(anoTexto.c_str());
+    if (ano < 0 || ano > ANO_MAX_CHAVE) {
+        std::cerr << "Erro: ano fora da faixa do indice (0.." << ANO_MAX_CHAVE << ")" << std::endl;
+        return 1;
+    }
+
+    // os k primeiros de cada partição (particoes.h), lidos em paralelo, contêm os
+    // k primeiros da base; a intercalação usa a mesma ordem do índice
+    int total = numParticoes();
+    std::vector<std::vector<long>> porParticao(total);
+    std::vector<std::size_t> paginas(total, 0);
+    std::vector<long long> nsBusca(total, 0);
+    if (!paraCadaParticao([&](int p, const Caminhos& c) {
+            // o construtor da árvore criaria um arquivo vazio
+            struct stat st;
+            if (stat(c.anoCitacoes.c_str(), &st) != 0) {
+                std::cerr << "Erro: indice '" << c.anoCitacoes << "' ausente. Execute o upload primeiro." << std::endl;
+                return false;
+            }
+
+            BPlusTree<long> idx(c.anoCitacoes);
+            idx.resetStats();
+
+            // a faixa do ano já vem em ordem de citações decrescentes: basta parar
+            // em k, depois de ler o resto do empate da k-ésima chave (ano_citacoes.h)
+            auto inicio = std::chrono::steady_clock::now();
+            std::vector<long>& payloads = porParticao[p];
+            payloads.reserve(k);
+            int chaveK = 0;
+            idx.scanRange(primeiraChaveDoAno(ano), ultimaChaveDoAno(ano), [&](int chave, long payload) {
+                if (payloads.size() >= k && chave != chaveK) return false;
+                payloads.push_back(payload);
+                chaveK = chave;
+                return true;
+            });
+            nsBusca[p] = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - inicio).count();
+            paginas[p] = idx.getBlocksRead();
+            return true;
+        })) {
+        return 1;
+    }
+
+    std::vector<long> payloads;
+    std::size_t paginasIndice = 0;
+    long long ns = 0;
+    for (int p = 0; p < total; ++p) {
+        payloads.insert(payloads.end(), porParticao[p].begin(), porParticao[p].end());
+        paginasIndice += paginas[p];
+        ns = std::max(ns, nsBusca[p]);
+    }
+    std::sort(payloads.begin(), payloads.end(), [](long a, long b) {
+        if (citacoesDoPayload(a) != citacoesDoPayload(b)) return citacoesDoPayload(a) > citacoesDoPayload(b);
+        return idDoPayload(a) < idDoPayload(b);
+    });
+    if (payloads.size() > k) payloads.resize(k);
+
+    std::vector<std::unique_ptr<HashingFile>> arquivos(total);
+    for (std::size_t i = 0; i < payloads.size(); ++i) {
+        int id = idDoPayload(payloads[i]);
+        std::cout << i + 1 << ". ID " << id << " - " << citacoesDoPayload(payloads[i]) << " citacoes";
+        if (mostrarTitulos) {
+            int p = particaoDoId(id);
+            if (!arquivos[p]) {
+                Caminhos c = caminhosDaParticao(p);
+                arquivos[p].reset(new HashingFile(c.dados, TAMANHO_TABELA, c.tabelaHash));
+            }
+            int blocosLidos = 0;
+            Artigo art = arquivos[p]->buscarPorId(id, blocosLidos);
+            if (art.ocupado) std::cout << ": " << art.titulo;
+        }
+        std::cout << std::endl;
+    }
+
+    std::cout << "\n" << payloads.size() << " artigos mais citados de " << ano << std::endl;
+    std::cout << "Paginas do indice lidas: " << paginasIndice << std::endl;
+    std::cout << "Tempo da busca no indice: " << ns / 1e6 << "ms" << std::endl;
+    return 0;
+}
@@ -1,5 +1,10 @@
 #include "hashing_file.h"
 #include "BPlusTree.hpp"
+#include "bloom.h"
+#include "leitor_csv.h"
+#include "manutencao.h"
+#include "particoes.h"
+#include "projecao.h"
 #include "config.h"  // NOVO: inclui configurações
 #include <sstream>
 #include <cstring>
@@ -8,8 +13,10 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <chrono>
 #include <algorithm>
+#include <unordered_set>
 #include <vector>
 
 const int TAMANHO_TABELA_HASH = 100000;
@@ -20,34 +27,6 @@ struct IndexEntry {
     long rid;
 };
 
-// ====== FUNÇÕES DE APOIO ====
-std::string trimQuotes(const std::string& str) {
-    if (str.length() >= 2 && str.front() == '"' && str.back() == '"') {
-        return str.substr(1, str.length() - 2);
-    }
-    return str;
-}
-
-// FUNÇÃO DE PARSING DO CSV
-std::vector<std::string> parseCSVLine(const std::string& linha) {
-    std::vector<std::string> campos;
-    std::string campo_atual;
-    bool dentro_de_aspas = false;
-
-    for (char c : linha) {
-        if (c == '"') {
-            dentro_de_aspas = !dentro_de_aspas;
-        } else if (c == ';' && !dentro_de_aspas) {
-            campos.push_back(trimQuotes(campo_atual));
-            campo_atual.clear();
-        } else {
-            campo_atual += c;
-        }
-    }
-    campos.push_back(trimQuotes(campo_atual));
-    return campos;
-}
-
 // === FUNÇÕES DE NORMALIZAÇÃO ====
 static inline std::string trim(const std::string& s) {
     std::size_t start = s.find_first_not_of(" \t\n\r");
@@ -73,69 +52,111 @@ static uint32_t fnv1a32(const std::string& s) {
     return hash;
 }
 
-static bool insereHashing(){
-    std::ifstream csvFile(ARTIGO_CSV);
-    if (!csvFile.is_open()) {
-        std::cerr << "Erro: Nao foi possivel abrir o arquivo CSV '" << ARTIGO_CSV << "'" << std::endl;
+// strncpy sem o terminador: o destino já está zerado
+static void copiarCampo(char* destino, std::string_view campo, std::size_t max) {
+    std::memcpy(destino, campo.data(), std::min(campo.size(), max));
+}
+
+// Converte uma linha do CSV em Artigo; retorna false (e avisa) se a linha for invalida
+static bool linhaParaArtigo(const LinhaCsv& linha, Artigo& art) {
+    if (linha.numCampos != 7) {
+        std::cerr << "--> AVISO: Linha " << linha.numero << " ignorada. Esperava 7 campos, mas encontrou " << linha.numCampos << "." << std::endl;
+        std::cerr << "    Conteudo da linha: " << linha.texto << std::endl;
         return false;
     }
 
-    std::cout << "\n--- Lendo arquivo " << ARTIGO_CSV << " e inserindo dados ---" << std::endl;
-    std::string linha;
-    int registrosInseridos = 0;
-    int numeroLinha = 0;
-    HashingFile arquivoHash(ARTIGO_DAT, TAMANHO_TABELA_HASH);
+    art = {};
+    art.ocupado = true;
+    const std::string_view* campos = linha.campos;
+    if (!lerInteiro(campos[0], art.id) || !lerInteiro(campos[2], art.ano) || !lerInteiro(campos[4], art.citacoes)) {
+        std::cerr << "--> ERRO DE CONVERSAO na linha " << linha.numero << ". Verifique os campos numericos." << std::endl;
+        return false;
+    }
+    copiarCampo(art.titulo, campos[1], 300);
+    copiarCampo(art.autores, campos[3], 150);
+    copiarCampo(art.atualizacao, campos[5], 19);
+    if (campos[6] != "NULL") {
+        copiarCampo(art.snippet, campos[6], 1024);
+    }
+    return true;
+}
 
-    auto start = std::chrono::high_resolution_clock::now();
+static bool insereHashing(const std::string& caminhoCsv, const Caminhos& c){
+    LeitorCsv csvFile;
+    if (!csvFile.abrir(caminhoCsv)) {
+        std::cerr << "Erro: Nao foi possivel abrir o arquivo CSV '" << caminhoCsv << "'" << std::endl;
+        return false;
+    }
 
-    while (std::getline(csvFile, linha)) {
-        numeroLinha++;
-        if (linha.empty()) continue;
+    std::cout << "\n--- Lendo arquivo " << caminhoCsv << " e inserindo dados ---" << std::endl;
+    LinhaCsv linha;
+    int registrosInseridos = 0;
+    HashingFile arquivoHash(c.dados, TAMANHO_TABELA_HASH, c.tabelaHash);
+    if (!arquivoHash.iniciarCarga()) return false;
 
-        std::vector<std::string> campos = parseCSVLine(linha);
+    auto start = std::chrono::high_resolution_clock::now();
 
-        if (campos.size() == 7) {
-            Artigo art = {};
-            art.ocupado = true;
-            try {
-                art.id = std::stoi(campos[0]);
-                strncpy(art.titulo, campos[1].c_str(), 300);
-                art.ano = std::stoi(campos[2]);
-                strncpy(art.autores, campos[3].c_str(), 150);
-                art.citacoes = std::stoi(campos[4]);
-                strncpy(art.atualizacao, campos[5].c_str(), 19);
-                if (campos[6] != "NULL") {
-                    strncpy(art.snippet, campos[6].c_str(), 1024);
-                }
+    while (csvFile.proximaLinha(linha)) {
+        if (linha.texto.empty()) continue;
 
-                arquivoHash.inserirArtigo(art);
-                registrosInseridos++;
+        Artigo art = {};
+        if (!linhaParaArtigo(linha, art)) continue;
 
-                if (registrosInseridos > 0 && registrosInseridos % 50000 == 0) {
-                    auto now = std::chrono::high_resolution_clock::now();
-                    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - start).count();
-                    std::cout << "[LOG] " << registrosInseridos << " registros inseridos no hashing... (" << elapsed << "s)" << std::endl;
-                }
+        arquivoHash.inserirArtigo(art);
+        registrosInseridos++;
 
-            } catch (const std::exception& e) {
-                std::cerr << "--> ERRO DE CONVERSAO na linha " << numeroLinha << ". Verifique os campos numericos. Erro: " << e.what() << std::endl;
-            }
-        } else {
-            std::cerr << "--> AVISO: Linha " << numeroLinha << " ignorada. Esperava 7 campos, mas encontrou " << campos.size() << "." << std::endl;
-            std::cerr << "    Conteudo da linha: " << linha << std::endl;
+        if (registrosInseridos > 0 && registrosInseridos % 50000 == 0) {
+            auto now = std::chrono::high_resolution_clock::now();
+            auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - start).count();
+            std::cout << "[LOG] " << registrosInseridos << " registros inseridos no hashing... (" << elapsed << "s)" << std::endl;
         }
     }
+    if (!arquivoHash.terminarCarga()) return false;
     std::cout << "--- Insercao finalizada. " << registrosInseridos << " registros inseridos. ---\n" << std::endl;
-    csvFile.close();
     return true;
 }
 
-static bool insereIdxPrim(){
-    BPlusTree<long> idx(PRIM_INDEX);
+// Insere as entradas (já ordenadas por chave) em lotes, com o progresso de cada um
+template <typename T, typename F>
+static std::size_t inserirEmLotes(BPlusTree<T>& idx, const std::vector<IndexEntry>& entries, F valorDe) {
+    auto insert_start = std::chrono::high_resolution_clock::now();
+    const size_t MEGA_BATCH_SIZE = 100000;
+    std::size_t totalInseridos = 0;
+
+    for (size_t start_idx = 0; start_idx < entries.size(); start_idx += MEGA_BATCH_SIZE) {
+        size_t end_idx = std::min(start_idx + MEGA_BATCH_SIZE, entries.size());
+
+        for (size_t j = start_idx; j < end_idx; ++j) {
+            T valor = valorDe(entries[j]);
+            idx.insert(entries[j].key, &valor);
+            totalInseridos++;
+        }
+
+        auto now = std::chrono::high_resolution_clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - insert_start).count();
+
+        std::cout << end_idx << "/" << entries.size()
+                  << " (" << elapsed << "s) - "
+                  << (end_idx * 100 / entries.size()) << "%" << std::endl;
+    }
+    return totalInseridos;
+}
+
+// Colunas que o índice primário deve carregar (PROJECAO_PRIM="titulo,ano,...")
+static std::uint32_t projecaoPrimDoAmbiente() {
+    std::string lista = getEnv("PROJECAO_PRIM", "");
+    std::uint32_t colunas = 0;
+    if (!lerColunas(lista, colunas)) {
+        std::cerr << "--> AVISO: PROJECAO_PRIM invalida ('" << lista << "'); indice primario sem colunas projetadas" << std::endl;
+        return 0;
+    }
+    return colunas;
+}
 
-    std::ifstream in(ARTIGO_DAT, std::ios::binary);
+static bool insereIdxPrim(const Caminhos& c){
+    std::ifstream in(c.dados, std::ios::binary);
     if (!in.is_open()) {
-        std::cerr << "[ERRO] Não foi possível abrir " << ARTIGO_DAT << "\n";
+        std::cerr << "[ERRO] Não foi possível abrir " << c.dados << "\n";
         return false;
     }
 
@@ -152,6 +173,7 @@ static bool insereIdxPrim(){
 
     // coletar o RID e ID
     while (in.read(reinterpret_cast<char*>(&bloco), blocoSize)) {
+        if (!conferirBloco(bloco, c.dados, blocoIndex)) return false;
         for (int i = 0; i < bloco.num_registros_usados; i++) {
             Artigo& art = bloco.artigos[i];
             if (!art.ocupado) continue;
@@ -168,23 +190,27 @@ static bool insereIdxPrim(){
 
     std::cout << "[INFO] Inserindo na B+Tree..." << std::endl;
 
-    auto insert_start = std::chrono::high_resolution_clock::now();
-    const size_t MEGA_BATCH_SIZE = 100000;
-
-    for (size_t start_idx = 0; start_idx < entries.size(); start_idx += MEGA_BATCH_SIZE) {
-        size_t end_idx = std::min(start_idx + MEGA_BATCH_SIZE, entries.size());
-
-        for (size_t j = start_idx; j < end_idx; ++j) {
-            idx.insert(entries[j].key, &entries[j].rid);
-            totalInseridos++;
-        }
-
-        auto now = std::chrono::high_resolution_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - insert_start).count();
-
-        std::cout << end_idx << "/" << entries.size()
-                  << " (" << elapsed << "s) - "
-                  << (end_idx * 100 / entries.size()) << "%" << std::endl;
+    std::uint32_t projecao = projecaoPrimDoAmbiente();
+    if (projecao == 0) {
+        BPlusTree<long> idx(c.primario);
+        totalInseridos = inserirEmLotes(idx, entries, [](const IndexEntry& e) { return e.rid; });
+    } else {
+        // índice de cobertura: as colunas vêm do bloco do RID (em ordem de ID,
+        // então o acesso a artigos.dat é aleatório)
+        std::cout << "[INFO] Colunas projetadas no indice primario: " << nomesDasColunas(projecao) << std::endl;
+        BPlusTree<ValorProjetado> idx(c.primario);
+        idx.setProjection(projecao);
+        std::ifstream dados(c.dados, std::ios::binary);
+        long blocoAtual = -1;
+        totalInseridos = inserirEmLotes(idx, entries, [&](const IndexEntry& e) {
+            long b = e.rid / REGISTROS_POR_BLOCO;
+            if (b != blocoAtual) {
+                dados.seekg(b * static_cast<long>(blocoSize));
+                dados.read(reinterpret_cast<char*>(&bloco), blocoSize);
+                blocoAtual = b;
+            }
+            return projetar(bloco.artigos[e.rid % REGISTROS_POR_BLOCO], e.rid, projecao);
+        });
     }
 
     auto end = std::chrono::high_resolution_clock::now();
@@ -198,12 +224,12 @@ static bool insereIdxPrim(){
 }
 
 
-static bool insereIdxSec(){
-    BPlusTree<long> idx(SEC_INDEX);
+static bool insereIdxSec(const Caminhos& c){
+    BPlusTree<long> idx(c.secundario);
 
-    std::ifstream in(ARTIGO_DAT, std::ios::binary);
+    std::ifstream in(c.dados, std::ios::binary);
     if (!in.is_open()) {
-        std::cerr << "Erro: nao foi possivel abrir " << ARTIGO_DAT << " para leitura.\n";
+        std::cerr << "Erro: nao foi possivel abrir " << c.dados << " para leitura.\n";
         return false;
     }
 
@@ -223,6 +249,7 @@ static bool insereIdxSec(){
     int titulosValidosExibidos = 0;
     
     while (in.read(reinterpret_cast<char*>(&bloco), blocoSize)) {
+        if (!conferirBloco(bloco, c.dados, blocoIndex)) return false;
         for (int i = 0; i < REGISTROS_POR_BLOCO && i < bloco.num_registros_usados; i++) {
             Artigo& art = bloco.artigos[i];
             long rid = static_cast<long>(blocoIndex * REGISTROS_POR_BLOCO + i);
@@ -287,35 +314,312 @@ static bool insereIdxSec(){
     return true;
 }
 
-int main(){
-    // Limpa o ambiente
-    remove(ARTIGO_DAT.c_str());
-    remove(TABELA_HASH.c_str());
-    remove(PRIM_INDEX.c_str());
-    remove(SEC_INDEX.c_str());
+// Acrescenta as chaves novas do delta aos Bloom filters. Se algum filtro não
+// existir ou passar da capacidade para a qual foi dimensionado (a taxa de falsos
+// positivos subiria), devolve false e o chamador reconstrói os dois.
+static bool atualizaBlooms(const std::vector<std::pair<int, long>>& novasPrim, const std::vector<std::uint64_t>& titulosNovos, const Caminhos& c) {
+    BloomFilter porId, porTitulo;
+    if (!porId.carregar(c.bloomId) || !porTitulo.carregar(c.bloomTitulo)) return false;
+    if (porId.inseridos() + novasPrim.size() > porId.capacidade() ||
+        porTitulo.inseridos() + titulosNovos.size() > porTitulo.capacidade()) {
+        return false;
+    }
+    for (const auto& e : novasPrim) porId.add(bloomHashId(e.first));
+    for (std::uint64_t h : titulosNovos) porTitulo.add(h);
+    return porId.salvar(c.bloomId) && porTitulo.salvar(c.bloomTitulo);
+}
 
-    std::cout << "DATA_DIR: " << DATA_DIR << std::endl;
-    std::cout << "BIN_DIR: " << BIN_DIR << std::endl;
-    std::cout << "CSV: " << ARTIGO_CSV << std::endl;
+// Aplica um CSV delta sobre a base existente: IDs novos são inseridos e IDs
+// existentes são atualizados no lugar (o RID não muda). As chaves novas de cada
+// índice são ordenadas e aplicadas em uma passada pelas folhas afetadas, e os
+// índices derivados recebem só os registros do delta.
+static bool aplicaDelta(const std::string& caminhoDelta, const Caminhos& c){
+    LeitorCsv csvFile;
+    if (!csvFile.abrir(caminhoDelta)) {
+        std::cerr << "Erro: Nao foi possivel abrir o arquivo CSV '" << caminhoDelta << "'" << std::endl;
+        return false;
+    }
+
+    std::cout << "\n--- Aplicando delta " << caminhoDelta << " ---" << std::endl;
+    LinhaCsv linha;
+    std::size_t inseridos = 0;
+    std::size_t atualizados = 0;
+
+    std::vector<std::pair<int, long>> novasPrim;
+    std::vector<std::pair<int, long>> novasSec;
+    std::vector<std::pair<int, long>> antigasSec;
+    std::vector<std::uint64_t> titulosNovos;
+
+    // índice primário de cobertura: entradas novas levam as colunas e as
+    // atualizadas trocam o valor projetado
+    std::uint32_t projecao;
+    {
+        BPlusTree<long> idx(c.primario);
+        projecao = idx.projection();
+    }
+    std::vector<std::pair<int, ValorProjetado>> novasPrimProj;
+    struct ProjecaoAlterada {
+        int id;
+        ValorProjetado antigo;
+        ValorProjetado novo;
+    };
+    std::vector<ProjecaoAlterada> projAlteradas;
+
+    DeltaDeAppend delta;
+    std::unordered_set<long> ridsInseridos; // atualizados depois no mesmo delta não têm estado anterior nos índices
+
+    auto start = std::chrono::high_resolution_clock::now();
+    {
+        HashingFile arquivoHash(c.dados, TAMANHO_TABELA_HASH, c.tabelaHash);
+        if (!arquivoHash.iniciarCarga()) return false;
+        delta.tamanhoAnterior = static_cast<std::uint64_t>(arquivoHash.getTotalBlocos()) * sizeof(Bloco);
+
+        while (csvFile.proximaLinha(linha)) {
+            if (linha.texto.empty()) continue;
 
+            Artigo art = {};
+            if (!linhaParaArtigo(linha, art)) continue;
+
+            Artigo anterior = {};
+            long rid = arquivoHash.atualizarArtigo(art, &anterior);
+            std::string norm = normalize(art.titulo);
+
+            if (rid >= 0) {
+                atualizados++;
+                delta.rids.push_back(rid);
+                if (!ridsInseridos.count(rid)) delta.anteriores.emplace(rid, anterior);
+                if (projecao) {
+                    ValorProjetado antigo = projetar(anterior, rid, projecao);
+                    ValorProjetado novo = projetar(art, rid, projecao);
+                    if (std::memcmp(&antigo, &novo, sizeof(ValorProjetado)) != 0) projAlteradas.push_back({art.id, antigo, novo});
+                }
+                // título alterado: troca a entrada do índice secundário
+                std::string normAnterior = normalize(anterior.titulo);
+                if (norm != normAnterior) {
+                    if (!normAnterior.empty()) antigasSec.push_back({static_cast<int>(fnv1a32(normAnterior)), rid});
+                    if (!norm.empty()) {
+                        novasSec.push_back({static_cast<int>(fnv1a32(norm)), rid});
+                        titulosNovos.push_back(bloomHashTitulo(norm));
+                    }
+                }
+                continue;
+            }
+
+            rid = arquivoHash.inserirArtigo(art);
+            if (rid < 0) {
+                std::cerr << "--> ERRO ao inserir o ID " << art.id << " (linha " << linha.numero << ")." << std::endl;
+                continue;
+            }
+            inseridos++;
+            delta.rids.push_back(rid);
+            ridsInseridos.insert(rid);
+            novasPrim.push_back({art.id, rid});
+            if (projecao) novasPrimProj.push_back({art.id, projetar(art, rid, projecao)});
+            if (!norm.empty()) {
+                novasSec.push_back({static_cast<int>(fnv1a32(norm)), rid});
+                titulosNovos.push_back(bloomHashTitulo(norm));
+            }
+        }
+        if (!arquivoHash.terminarCarga()) return false;
+        delta.blocosGravados = arquivoHash.blocosGravadosNaCarga();
+    }
+
+    auto porChave = [](const std::pair<int, long>& a, const std::pair<int, long>& b) { return a.first < b.first; };
+    std::stable_sort(novasPrim.begin(), novasPrim.end(), porChave);
+    std::stable_sort(novasSec.begin(), novasSec.end(), porChave);
+
+    if (projecao == 0) {
+        BPlusTree<long> idx(c.primario);
+        idx.insertSorted(novasPrim);
+    } else {
+        std::stable_sort(novasPrimProj.begin(), novasPrimProj.end(),
+                         [](const auto& a, const auto& b) { return a.first < b.first; });
+        BPlusTree<ValorProjetado> idx(c.primario);
+        for (const auto& alt : projAlteradas) idx.update(alt.id, alt.antigo, alt.novo);
+        idx.insertSorted(novasPrimProj);
+    }
+    {
+        BPlusTree<long> idx(c.secundario);
+        for (const auto& e : antigasSec) idx.remove(e.first, e.second);
+        idx.insertSorted(novasSec);
+    }
+    if (!atualizaBlooms(novasPrim, titulosNovos, c)) {
+        std::cerr << "--> AVISO: Bloom filters nao atualizados; reconstruindo a partir de " << c.dados << std::endl;
+        reconstruirBlooms(c);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "--- Delta aplicado. " << inseridos << " inseridos, " << atualizados
+              << " atualizados, " << novasSec.size() << " chaves no indice secundario (" << elapsed << "ms) ---" << std::endl;
+    return atualizarIndicesDerivados(c, delta);
+}
+
+// Remove os IDs listados (um por linha; aceita também um CSV, usando o primeiro campo).
+// A remoção no hashing pode mover o último registro da cadeia, então o RID dele é
+// corrigido nos dois índices.
+static bool removeIds(const std::string& caminhoIds, const Caminhos& c){
+    LeitorCsv in;
+    if (!in.abrir(caminhoIds)) {
+        std::cerr << "Erro: Nao foi possivel abrir o arquivo '" << caminhoIds << "'" << std::endl;
+        return false;
+    }
+
+    std::cout << "\n--- Removendo IDs de " << caminhoIds << " ---" << std::endl;
+    HashingFile arquivoHash(c.dados, TAMANHO_TABELA_HASH, c.tabelaHash);
+    BPlusTree<long> prim(c.primario);
+    BPlusTree<long> sec(c.secundario);
+
+    LinhaCsv linha;
+    std::size_t removidos = 0;
+    std::size_t ausentes = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+
+    while (in.proximaLinha(linha)) {
+        std::string_view campo = linha.campos[0];
+        std::size_t ini = campo.find_first_not_of(" \t\n\r");
+        if (ini == std::string_view::npos) continue;
+        campo = campo.substr(ini, campo.find_last_not_of(" \t\n\r") - ini + 1);
+
+        int id;
+        if (!lerInteiro(campo, id)) {
+            std::cerr << "--> AVISO: Linha " << linha.numero << " ignorada. ID invalido: " << campo << std::endl;
+            continue;
+        }
+
+        Remocao r;
+        if (!arquivoHash.removerArtigo(id, r)) {
+            ausentes++;
+            continue;
+        }
+        removidos++;
+
+        prim.remove(id, r.rid);
+        std::string norm = normalize(r.removido.titulo);
+        if (!norm.empty()) sec.remove(static_cast<int>(fnv1a32(norm)), r.rid);
+
+        if (r.houveMovimento) {
+            prim.update(r.movido.id, r.ridOrigem, r.rid);
+            std::string normMovido = normalize(r.movido.titulo);
+            if (!normMovido.empty()) sec.update(static_cast<int>(fnv1a32(normMovido)), r.ridOrigem, r.rid);
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "--- Remocao finalizada. " << removidos << " removidos, " << ausentes
+              << " IDs inexistentes (" << elapsed << "ms) ---" << std::endl;
+    // os Bloom filters não removem chaves: as removidas viram falsos positivos
+    // até a próxima reconstrução (upload completo ou aumento de capacidade no append)
+    return true;
+}
+
+// Remove os arquivos de uma partição antes do upload completo
+static void limpaParticao(const Caminhos& c) {
+    for (const std::string* caminho : {&c.dados, &c.comprimidos, &c.tabelaHash, &c.primario, &c.secundario,
+                                       &c.bloomId, &c.bloomTitulo, &c.invertido, &c.prefixo, &c.autores,
+                                       &c.anoCitacoes, &c.aprendidoModelo, &c.aprendidoArranjo}) {
+        remove(caminho->c_str());
+    }
+}
+
+// Monta uma partição a partir do seu CSV: hashing, índices B+, Bloom filters e
+// índices derivados
+static bool carregaParticao(const std::string& caminhoCsv, const Caminhos& c) {
     std::cout << "--- Inicio de inserção em hash ---\n";
-    if (!insereHashing()) {
+    if (!insereHashing(caminhoCsv, c)) {
         std::cerr << "Erro na insercao via hashing. Abortando.\n";
-        return 1;
+        return false;
     }
     std::cout << "--- Inserção em hash realizada com sucesso ---\n";
     std::cout << "\n--- Inicio de insercao do indice primario ---\n";
-    if (!insereIdxPrim()) {
+    if (!insereIdxPrim(c)) {
         std::cerr << "Erro na insercao do indice primario. Abortando.\n";
-        return 1;
+        return false;
     }
     std::cout << "--- Inserção do indice primario realizada com sucesso ---\n";
     std::cout << "\n--- Inicio de insercao do indice secundario ---\n";
-    if (!insereIdxSec()) {
+    if (!insereIdxSec(c)) {
         std::cerr << "Erro na insercao do indice secundario. Abortando.\n";
-        return 1;
+        return false;
     }
     std::cout << "--- Inserção do indice secundario realizada com sucesso ---\n";
 
-    return 0;
-}
\ No newline at end of file
+    std::cout << "\n--- Construindo Bloom filters ---\n";
+    if (!reconstruirBlooms(c)) {
+        std::cerr << "Erro na construcao dos Bloom filters. Abortando.\n";
+        return false;
+    }
+
+    std::cout << "\n--- Construindo indices derivados ---\n";
+    if (!reconstruirIndicesDerivados(c)) {
+        std::cerr << "Erro na construcao dos indices derivados. Abortando.\n";
+        return false;
+    }
+    return true;
+}
+
+// Divide o arquivo de entrada por partição e aplica 'operacao' em todas em
+// paralelo
+template <typename F>
+static bool aplicaPorParticao(const std::string& caminho, F operacao) {
+    std::vector<std::string> partes;
+    if (!particionarPorId(caminho, partes)) {
+        removerPartes(caminho, partes);
+        return false;
+    }
+    bool ok = paraCadaParticao([&](int k, const Caminhos& c) {
+        return operacao(partes[k], c);
+    });
+    removerPartes(caminho, partes);
+    return ok;
+}
+
+int main(int argc, char* argv[]){
+    startMetricsServerFromEnv();
+    if (argc == 3 && std::string(argv[1]) == "--delete") {
+        std::cout << "DATA_DIR: " << DATA_DIR << " (" << numParticoes() << " particoes)" << std::endl;
+        // a remoção move registros, então os índices derivados são refeitos do zero
+        auto removeEReconstroi = [](const std::string& ids, const Caminhos& c) { return removeIds(ids, c) && reconstruirIndicesDerivados(c); };
+        if (!aplicaPorParticao(argv[2], removeEReconstroi)) {
+            std::cerr << "Erro ao remover IDs. Abortando.\n";
+            return 1;
+        }
+        return 0;
+    }
+    if (argc == 3 && std::string(argv[1]) == "--append") {
+        std::cout << "DATA_DIR: " << DATA_DIR << " (" << numParticoes() << " particoes)" << std::endl;
+        std::cout << "DELTA: " << argv[2] << std::endl;
+        if (!aplicaPorParticao(argv[2], aplicaDelta)) {
+            std::cerr << "Erro ao aplicar o delta. Abortando.\n";
+            return 1;
+        }
+        return 0;
+    }
+    if (argc != 1) {
+        std::cerr << "Uso: " << argv[0] << " [--append <delta.csv> | --delete <ids.txt>]" << std::endl;
+        return 1;
+    }
+
+    // Limpa o ambiente (a base anterior pode ter outras partições)
+    for (int k = 0; k < numParticoes(); ++k) limpaParticao(caminhosDaParticao(k));
+    if (!configurarParticoes()) {
+        std::cerr << "Erro ao preparar as particoes. Abortando.\n";
+        return 1;
+    }
+    for (int k = 0; k < numParticoes(); ++k) limpaParticao(caminhosDaParticao(k));
+
+    std::cout << "DATA_DIR: " << DATA_DIR << std::endl;
+    std::cout << "BIN_DIR: " << BIN_DIR << std::endl;
+    std::cout << "CSV: " << ARTIGO_CSV << std::endl;
+    std::cout << "Particoes: " << numParticoes() << std::endl;
+
+    std::vector<std::string> partes;
+    if (!particionarPorId(ARTIGO_CSV, partes)) {
+        removerPartes(ARTIGO_CSV, partes);
+        return 1;
+    }
+    bool ok = paraCadaParticao([&](int k, const Caminhos& c) { return carregaParticao(partes[k], c); });
+    removerPartes(ARTIGO_CSV, partes);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+#include "../include/varredura.h"
+#include "../include/hashing_file.h"
+#include "../include/metrics.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+bool FiltroScan::aceita(const Artigo& art) const {
+    if (art.ano < anoMin || art.ano > anoMax) return false;
+    if (art.citacoes < citacoesMin || art.citacoes > citacoesMax) return false;
+    if (!atualizacaoMin.empty() || !atualizacaoMax.empty()) {
+        std::size_t n = strnlen(art.atualizacao, sizeof(art.atualizacao));
+        std::string valor(art.atualizacao, n);
+        if (!atualizacaoMin.empty() && valor < atualizacaoMin) return false;
+        // o limite superior vale como prefixo: "2020-01-31" inclui o dia inteiro
+        if (!atualizacaoMax.empty() && valor.compare(0, atualizacaoMax.size(), atualizacaoMax) > 0) return false;
+    }
+    return true;
+}
+
+void ResumoCitacoes::adicionar(int citacoes) {
+    quantidade++;
+    soma += citacoes;
+    minimo = std::min(minimo, citacoes);
+    maximo = std::max(maximo, citacoes);
+}
+
+void ResumoCitacoes::combinar(const ResumoCitacoes& outro) {
+    quantidade += outro.quantidade;
+    soma += outro.soma;
+    minimo = std::min(minimo, outro.minimo);
+    maximo = std::max(maximo, outro.maximo);
+}
+
+void AgregadoScan::combinar(const AgregadoScan& outro) {
+    total.combinar(outro.total);
+    anoMin = std::min(anoMin, outro.anoMin);
+    anoMax = std::max(anoMax, outro.anoMax);
+    for (const auto& par : outro.porAno) porAno[par.first].combinar(par.second);
+    registrosLidos += outro.registrosLidos;
+    blocosLidos += outro.blocosLidos;
+    bytesLidos += outro.bytesLidos;
+}
+
+// Lê 'n' bytes em 'offset' repetindo o pread em leituras curtas
+static bool lerTudo(int fd, char* destino, std::size_t n, off_t offset) {
+    while (n > 0) {
+        ssize_t r = pread(fd, destino, n, offset);
+        if (r <= 0) return false;
+        destino += r;
+        n -= static_cast<std::size_t>(r);
+        offset += r;
+    }
+    return true;
+}
+
+bool varrerParalelo(const std::string& caminho, const FiltroScan& filtro,
+                    const OpcoesScan& opcoes, AgregadoScan& resultado) {
+    int fd = open(caminho.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    // blocos incompletos no fim (gravação interrompida) ficam de fora, como no in.read
+    const std::size_t numBlocos = static_cast<std::size_t>(st.st_size) / sizeof(Bloco);
+    const std::size_t porLote = std::max<std::size_t>(opcoes.blocosPorLote, 1);
+    const std::size_t numLotes = (numBlocos + porLote - 1) / porLote;
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    unsigned threads = opcoes.threads ? opcoes.threads : std::thread::hardware_concurrency();
+    threads = static_cast<unsigned>(std::max<std::size_t>(1, std::min<std::size_t>(threads ? threads : 1, numLotes)));
+
+    StorageMetrics& metrics = StorageMetrics::get();
+    std::atomic<std::size_t> proximoLote{0};
+    std::atomic<bool> falhou{false};
+    std::vector<AgregadoScan> parciais(threads);
+
+    auto trabalhador = [&](unsigned t) {
+        AgregadoScan& local = parciais[t];
+        std::vector<Bloco> buffer(porLote);
+        while (!falhou.load(std::memory_order_relaxed)) {
+            std::size_t lote = proximoLote.fetch_add(1, std::memory_order_relaxed);
+            if (lote >= numLotes) break;
+            std::size_t primeiro = lote * porLote;
+            std::size_t n = std::min(porLote, numBlocos - primeiro);
+            std::size_t bytes = n * sizeof(Bloco);
+            if (!lerTudo(fd, reinterpret_cast<char*>(buffer.data()), bytes,
+                         static_cast<off_t>(primeiro * sizeof(Bloco)))) {
+                falhou = true;
+                break;
+            }
+
+            std::uint64_t aceitos = 0;
+            for (std::size_t b = 0; b < n; ++b) {
+                const Bloco& bloco = buffer[b];
+                // bloco corrompido conta como falha de leitura
+                if (!conferirBloco(bloco, caminho, primeiro + b)) {
+                    falhou = true;
+                    break;
+                }
+                for (int i = 0; i < bloco.num_registros_usados && i < REGISTROS_POR_BLOCO; ++i) {
+                    const Artigo& art = bloco.artigos[i];
+                    if (!art.ocupado) continue;
+                    local.registrosLidos++;
+                    if (!filtro.aceita(art)) continue;
+                    aceitos++;
+                    local.total.adicionar(art.citacoes);
+                    local.anoMin = std::min(local.anoMin, art.ano);
+                    local.anoMax = std::max(local.anoMax, art.ano);
+                    if (opcoes.agruparPorAno) local.porAno[art.ano].adicionar(art.citacoes);
+                }
+            }
+            local.blocosLidos += n;
+            local.bytesLidos += bytes;
+            // um incremento por lote: os contadores globais não viram gargalo
+            metrics.scanBlocksRead.inc(n);
+            metrics.scanBytesRead.inc(bytes);
+            metrics.scanRecordsMatched.inc(aceitos);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(trabalhador, t);
+    trabalhador(0);
+    for (std::thread& th : pool) th.join();
+    close(fd);
+    if (falhou) return false;
+
+    for (const AgregadoScan& parcial : parciais) resultado.combinar(parcial);
+    return true;
+}